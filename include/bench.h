@@ -0,0 +1,48 @@
+/**
+ * bench.h
+ * Benchmark drivers selected from the command line
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+// Monotonic wall clock in seconds
+double bench_now_seconds(void);
+
+// network_sim --bench-sssp [nodes] [degree] [max_weight]
+int run_sssp_benchmark(int argc, char* argv[]);
+
+// network_sim --bench-rcu [nodes] [readers] [seconds] [batch]
+int run_rcu_benchmark(int argc, char* argv[]);
+
+// network_sim --bench-lpm [route_file | route_count]
+int run_lpm_benchmark(int argc, char* argv[]);
+
+// network_sim --bench-routes [fragments] [nodes] [sources]
+int run_route_benchmark(int argc, char* argv[]);
+
+// network_sim --bench-link-state [nodes] [degree] [changes] [interval_ms]
+int run_link_state_benchmark(int argc, char* argv[]);
+
+// network_sim --bench-snapshot [nodes] [degree] [sources] [path]
+int run_snapshot_benchmark(int argc, char* argv[]);
+
+// network_sim --bench-headers [datagrams] [mtu] [rounds]
+int run_header_benchmark(int argc, char* argv[]);
+
+// network_sim --bench-wire [datagrams] [mtu] [pipe | output_file]
+int run_wire_benchmark(int argc, char* argv[]);
+
+// network_sim --bench-dense [max_nodes]
+int run_dense_benchmark(int argc, char* argv[]);
+
+// network_sim --bench-multicast [nodes] [degree] [payload] [mtu]
+int run_multicast_benchmark(int argc, char* argv[]);
+
+// network_sim --bench-frr [nodes] [degree] [failures]
+int run_frr_benchmark(int argc, char* argv[]);
+
+// network_sim --bench-txn [rounds]
+int run_txn_benchmark(int argc, char* argv[]);
+
+#endif /* BENCH_H */
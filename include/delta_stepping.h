@@ -0,0 +1,30 @@
+/**
+ * delta_stepping.h
+ * Parallel delta-stepping single-source shortest paths
+ */
+
+#ifndef DELTA_STEPPING_H
+#define DELTA_STEPPING_H
+
+#include "graph.h"
+
+#define DELTA_STEPPING_MIN_NODES 50000  // below this, sequential Dijkstra is faster
+
+typedef struct delta_stepping_config {
+    int delta;      // bucket width, <= 0 to derive it from the weight distribution
+    int threads;    // worker threads, <= 0 to use every online core
+    int min_nodes;  // graphs smaller than this fall back to dijkstra_csr()
+} delta_stepping_config;
+
+// Fill a configuration with defaults (auto delta, all cores, DELTA_STEPPING_MIN_NODES)
+void init_delta_stepping_config(delta_stepping_config* config);
+
+// Bucket width derived from the graph: 2 * mean weight / mean out-degree, at least 1
+int delta_stepping_auto_delta(csr_graph* graph);
+
+// Compute the shortest-path tree from source into dist/prev (same results as
+// dijkstra_csr(), including the canonical prev[] array)
+// Returns the delta used, or 0 if the sequential fallback ran
+int delta_stepping(csr_graph* graph, int source, const delta_stepping_config* config, int* dist, int* prev);
+
+#endif /* DELTA_STEPPING_H */
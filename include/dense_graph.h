@@ -0,0 +1,61 @@
+/**
+ * dense_graph.h
+ * Adjacency-matrix graphs and a vectorized Dijkstra for small, dense topologies
+ */
+
+#ifndef DENSE_GRAPH_H
+#define DENSE_GRAPH_H
+
+#include <stdbool.h>
+#include "graph.h"
+#include "network.h"
+
+#define DENSE_MAX_NODES 4096   // larger graphs stay in CSR form
+
+// Instruction set used by dijkstra_dense(), chosen at run time with DENSE_KERNEL_AUTO
+typedef enum dense_kernel {
+    DENSE_KERNEL_AUTO,
+    DENSE_KERNEL_SCALAR,
+    DENSE_KERNEL_SSE41,   // 4 distances per instruction
+    DENSE_KERNEL_AVX2     // 8 distances per instruction
+} dense_kernel;
+
+typedef struct dense_graph {
+    int  node_count;
+    int  edge_count;
+    int  stride;        // ints per row, at least node_count
+    int* weights;       // weights[u * stride + v], links have weight > 0
+    bool owns_weights;  // false for views of a network_topology
+} dense_graph;
+
+// View the adjacency matrix of a topology without copying it
+void dense_from_topology(dense_graph* graph, network_topology* network);
+
+// Copy a CSR graph into a matrix (node_count <= DENSE_MAX_NODES), keeping the
+// lightest of parallel edges
+void dense_from_csr(dense_graph* graph, const csr_graph* csr);
+
+// Release the matrix of a copied graph
+void dense_free(dense_graph* graph);
+
+// True if the dense kernel is expected to beat heap-based dijkstra_csr()
+bool dense_preferred(int node_count, long edge_count);
+
+// Fastest kernel this CPU supports
+dense_kernel dense_best_kernel(void);
+
+// True if the CPU can run a kernel
+bool dense_kernel_supported(dense_kernel kernel);
+
+// Name of a kernel for display
+const char* dense_kernel_name(dense_kernel kernel);
+
+// Dijkstra with a linear-scan priority queue, stopping once `target` is settled
+// (-1 computes the whole tree). The lowest-numbered closest node is settled
+// first and, like dijkstra(), a node keeps the first predecessor that reached
+// it; with `canonical` it keeps the smallest one instead, the prev[] of
+// dijkstra_csr(). Every kernel returns the same dist[] and prev[]
+void dijkstra_dense(const dense_graph* graph, int source, int target, int* dist, int* prev,
+                    dense_kernel kernel, bool canonical);
+
+#endif /* DENSE_GRAPH_H */
@@ -0,0 +1,92 @@
+/**
+ * fast_reroute.h
+ * Loop-free alternates and remote LFAs precomputed for fast reroute on link failure
+ */
+
+#ifndef FAST_REROUTE_H
+#define FAST_REROUTE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "graph.h"
+#include "link_state.h"
+
+#define FRR_HOP_LIMIT 64   // initial TTL of simulated fragments
+
+// Backups computed for every route
+typedef enum frr_protection {
+    FRR_NONE,          // primary next hops only
+    FRR_LFA,           // loop-free alternate neighbors (RFC 5286)
+    FRR_REMOTE_LFA     // plus tunnels to a remote repair node where no neighbor qualifies (RFC 7490)
+} frr_protection;
+
+// Kind of backup a route has
+typedef enum frr_backup {
+    FRR_BACKUP_NONE,
+    FRR_BACKUP_LFA,          // neighbor whose path avoids the protected link
+    FRR_BACKUP_NODE_LFA,     // neighbor whose path also avoids the primary next hop
+    FRR_BACKUP_REMOTE_LFA    // tunnel to a repair node whose path avoids the router
+} frr_backup;
+
+// Forwarding state of every router towards every destination, indexed [router * node_count + destination]
+typedef struct frr_table {
+    int      node_count;
+    int*     dist;          // all-pairs shortest distances, GRAPH_UNREACHABLE if none
+    int*     next_hop;      // primary next hop, the router itself for its own node, -1 if unreachable
+    int*     backup_hop;    // neighbor used when the primary link is down, -1 if unprotected
+    int*     repair_node;   // tunnel endpoint of a remote LFA, -1 otherwise
+    uint8_t* backup;        // frr_backup
+
+    // Coverage over routes with a next hop other than the router itself
+    long     routes;
+    long     lfa;
+    long     node_lfa;
+    long     remote_lfa;
+    double   build_seconds;
+} frr_table;
+
+// Compute all-pairs routes of a graph and the backups of every route
+void frr_table_build(frr_table* table, csr_graph* graph, frr_protection protection);
+
+// Release the arrays of a table
+void frr_table_free(frr_table* table);
+
+// Next hop of router towards destination in O(1). With primary_down the precomputed
+// backup is returned instead (-1 if none) and *tunnel_to is set to the node the
+// packet must be tunneled to, -1 to forward it unchanged
+int frr_next_hop(const frr_table* table, int router, int destination, bool primary_down, int* tunnel_to);
+
+typedef struct frr_sim_config {
+    frr_protection    protection;
+    long long         fragment_interval_us;  // one fragment of an affected flow injected this often
+    link_state_config link_state;            // reconvergence timing
+} frr_sim_config;
+
+// What happened to the fragments sent while the network reconverged
+typedef struct frr_outcome {
+    long sent;
+    long delivered;
+    long dropped;    // at the failed link or at a router without a route
+    long looped;     // hop limit exceeded in a transient forwarding loop
+    long repaired;   // delivered over a precomputed backup
+} frr_outcome;
+
+typedef struct frr_sim_report {
+    int         affected_pairs;      // (source, destination) pairs routed over a failed link
+    long        protected_routes;    // routes over a failed link with a backup at its router
+    long long   convergence_us;      // failure until the last router installed new routes
+    frr_outcome unprotected;         // routers wait for their SPF
+    frr_outcome fast_reroute;        // the router next to the failure switches to its backup
+} frr_sim_report;
+
+// Fill a configuration with defaults (remote LFAs, one fragment every 100 us, link-state defaults)
+void init_frr_sim_config(frr_sim_config* config);
+
+// Fail the given links of a converged network and forward the fragments of every
+// affected flow, hop by hop, while the link-state protocol reconverges: each router
+// uses its old routes until its own SPF run has finished. Returns 0, or -1 if a
+// link is not in the graph
+int frr_simulate_failure(csr_graph* graph, const link_delta* failed, int failed_count,
+                         const frr_sim_config* config, frr_sim_report* report);
+
+#endif /* FAST_REROUTE_H */
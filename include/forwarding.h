@@ -0,0 +1,61 @@
+/**
+ * forwarding.h
+ * Per-router IPv4 forwarding tables built from shortest-path trees
+ */
+
+#ifndef FORWARDING_H
+#define FORWARDING_H
+
+#include <stdint.h>
+#include "lpm.h"
+#include "network.h"
+#include "route_cache.h"
+
+#define NODE_PREFIX_BASE   0x0A000000u  // node prefixes are carved out of 10.0.0.0/8
+#define NODE_PREFIX_LENGTH 24           // node i owns 10.(i / 256).(i % 256).0/24
+
+// Every router announces the same prefixes and only the next hops differ, so
+// one LPM table (about 64 MB of mostly untouched tbl24) resolves an address to
+// the node owning it, and a small per-router row gives the next hop to that node
+typedef struct forwarding_plane {
+    int       node_count;
+    lpm_table prefixes;   // node prefix -> owning node, shared by all routers
+    int*      next_hop;   // [router * node_count + owner], -1 if unreachable
+} forwarding_plane;
+
+// Prefix owned by a node
+uint32_t node_prefix(int node);
+
+// Host address of a node inside its prefix (x.x.x.1)
+uint32_t node_address(int node);
+
+// Node owning an address, -1 if it is outside every node prefix of the network
+int address_to_node(network_topology* network, uint32_t address);
+
+// Format an address as dotted decimal into a buffer of at least 16 bytes
+void format_ipv4_address(uint32_t address, char* buffer);
+
+// Build every router's forwarding state: each node prefix maps to the first hop
+// of the shortest path towards its owner, a router's own prefix maps to itself
+void forwarding_build(forwarding_plane* plane, network_topology* network);
+
+// After a link change: rederive the next hop rows from the current trees of a route
+// cache on the new topology. Node prefixes do not depend on links, so the prefix
+// table is kept, and Dijkstra only runs for routers the cache has no tree for
+void forwarding_update(forwarding_plane* plane, route_cache* routes);
+
+// Release the prefix table and next hop rows
+void forwarding_free(forwarding_plane* plane);
+
+// Next hop router for a destination address, -1 if the router has no route
+int forwarding_next_hop(const forwarding_plane* plane, int router, uint32_t dest_ip);
+
+// Router that delivers dest_ip when forwarded hop by hop from source,
+// -1 if a router on the way has no route or the hops loop
+int forwarding_egress(const forwarding_plane* plane, int source, uint32_t dest_ip);
+
+// Forward hop by hop from source until the router owning dest_ip is reached
+// Same contract as dijkstra(): returns the path length or -1, caller frees *path
+int forwarding_route(const forwarding_plane* plane, int source, uint32_t dest_ip, int** path);
+
+#endif /* FORWARDING_H */
@@ -0,0 +1,42 @@
+/**
+ * graph.h
+ * Compressed sparse row (CSR) graphs for topologies beyond MAX_NODES
+ */
+
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include "network.h"
+
+#define GRAPH_UNREACHABLE 0x7FFFFFFF  // distance of nodes not reachable from the source
+
+typedef struct csr_graph {
+    int  node_count;
+    int  edge_count;
+    int* offsets;   // node_count + 1 entries, edges of u are [offsets[u], offsets[u+1])
+    int* targets;   // edge_count destination nodes
+    int* weights;   // edge_count positive weights
+    int  max_weight;
+} csr_graph;
+
+// Build a CSR graph from the adjacency matrix of a network topology
+void csr_from_topology(csr_graph* graph, network_topology* network);
+
+// Generate a random directed graph where every node has `degree` outgoing edges
+// with weights in 1..max_weight; edge u -> u+1 is always present so every node
+// is reachable from every other one
+void csr_generate_random(csr_graph* graph, int node_count, int degree, int max_weight, unsigned int seed);
+
+// Release the arrays of a CSR graph
+void csr_free(csr_graph* graph);
+
+// Sequential heap-based Dijkstra computing the full shortest-path tree from source
+// dist[v] is GRAPH_UNREACHABLE for unreachable nodes, prev[] is canonical (see below)
+void dijkstra_csr(csr_graph* graph, int source, int* dist, int* prev);
+
+// Derive the canonical predecessor array from final distances: prev[v] is the
+// smallest-numbered u with dist[u] + w(u, v) == dist[v], -1 for the source and
+// unreachable nodes. Makes trees from different SSSP algorithms comparable.
+void sssp_canonical_prev(csr_graph* graph, const int* dist, int* prev);
+
+#endif /* GRAPH_H */
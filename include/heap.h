@@ -0,0 +1,34 @@
+/**
+ * heap.h
+ * Binary min-heap of (key, value) pairs for priority-queue based searches
+ */
+
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <stdbool.h>
+
+typedef struct heap_entry {
+    long long key;
+    int       value;
+} heap_entry;
+
+typedef struct min_heap {
+    heap_entry* entries;
+    int         size;
+    int         capacity;
+} min_heap;
+
+// Initialize an empty heap with room for `capacity` entries (grows on demand)
+void heap_init(min_heap* heap, int capacity);
+
+// Release the heap storage
+void heap_free(min_heap* heap);
+
+// Insert an entry (duplicates of a value are allowed, callers skip stale ones)
+void heap_push(min_heap* heap, long long key, int value);
+
+// Remove the entry with the smallest key, returns false if the heap is empty
+bool heap_pop(min_heap* heap, heap_entry* entry);
+
+#endif /* HEAP_H */
@@ -1,7 +1,9 @@
 #ifndef IPV4_FRAG_H
 #define IPV4_FRAG_H
 
+#include <stdbool.h>
 #include <stdint.h>
+#include "route_cache.h"
 
 #define IPV4_HEADER_SIZE 20  // IPv4 header size without options
 #define MAX_IPV4_PACKET_SIZE 65535  // Max packet size
@@ -26,31 +28,108 @@ typedef struct ipv4_header
     uint32_t dest_ip;
 } ipv4_header;
 
+// Payload content generators, every byte is a pure function of its position
+typedef enum payload_pattern {
+    PAYLOAD_PATTERN_SEQUENTIAL = 0,  // byte i is i % 256
+    PAYLOAD_PATTERN_RANDOM = 1       // pseudo-random bytes derived from the seed
+} payload_pattern;
+
+// Describes payload bytes without storing them
+typedef struct payload_desc {
+    uint8_t  pattern;   // payload_pattern
+    uint32_t seed;
+    uint32_t offset;    // position of the first byte within the datagram payload
+} payload_desc;
+
 // IPv4 packet structure
 typedef struct ipv4_packet{
     ipv4_header header;
-    uint8_t*   payload;
+    uint8_t*   payload;       // NULL for virtual packets
     uint16_t   payload_size;
+    payload_desc content;     // generator for the payload bytes
 } ipv4_packet;
 
 // IPv4 fragment structure
 typedef struct ipv4_fragment {
     ipv4_header header;
-    uint8_t*   data;
+    uint8_t*   data;          // NULL for fragments of virtual packets
     uint16_t   data_size;
+    payload_desc content;     // generator for the fragment data
     
     // Routing information
-    int*       path;      // Array of nodes that form the path from source to destination
-    int        path_length; // Number of nodes in the path
+    route_handle route;   // Shared shortest-path tree and destination, expanded on demand
 } ipv4_fragment;
 
+// Fragment headers in structure-of-arrays form: every field is one contiguous
+// array, so bulk header math streams through only the fields it touches.
+// Headers carry no options (version_ihl 0x45); the data of fragment i is the
+// datagram payload starting at data_offset[i]
+typedef struct fragment_batch {
+    int       count;
+    int       capacity;
+    uint16_t* total_len;
+    uint16_t* identifier;
+    uint16_t* flags_frag_offset;
+    uint16_t* checksum;
+    uint8_t*  tos;
+    uint8_t*  ttl;
+    uint8_t*  protocol;
+    uint32_t* source_ip;
+    uint32_t* dest_ip;
+    uint32_t* data_offset;
+} fragment_batch;
+
 // Create a new IPv4 packet
 void create_ipv4_packet(ipv4_packet* packet, int source, int destination, int payload_size);
 
+// Create a packet whose payload is only described, bytes are generated on demand
+void create_ipv4_packet_virtual(ipv4_packet* packet, int source, int destination, int payload_size,
+                                payload_pattern pattern, uint32_t seed);
+
 // Fragment an IPv4 packet based on MTU
+// Fragments of a virtual packet carry a payload descriptor instead of a data copy
 int fragment_ipv4_packet(ipv4_packet* packet, int mtu, ipv4_fragment** fragments);
 
-// Helper function to calculate IPv4 header checksum
+// Append the fragments of a packet to a batch, with the headers fragment_ipv4_packet()
+// would produce. Returns the number of fragments appended, 0 if the MTU is too small
+int fragment_ipv4_packet_batch(const ipv4_packet* packet, int mtu, fragment_batch* batch);
+
+// Create an empty batch with room for `capacity` fragments (grows as needed)
+void fragment_batch_init(fragment_batch* batch, int capacity);
+
+// Release the arrays of a batch
+void fragment_batch_free(fragment_batch* batch);
+
+// Recompute the header checksum of fragments [first, first + count)
+void fragment_batch_checksum(fragment_batch* batch, int first, int count);
+
+// Decrement every TTL that is not zero yet, updating checksums incrementally (RFC 1624)
+// Returns the number of fragments whose TTL is now zero and must be dropped
+int fragment_batch_decrement_ttl(fragment_batch* batch);
+
+// Copy fragment `index` of a batch into an ordinary header
+void fragment_batch_header(const fragment_batch* batch, int index, ipv4_header* header);
+
+// Write a header in network byte order (IPV4_HEADER_SIZE bytes)
+void ipv4_serialize_header(const ipv4_header* header, uint8_t* out);
+
+// Read a header in network byte order, returns false if it is not a 20-byte IPv4 header
+bool ipv4_parse_header(const uint8_t* in, ipv4_header* header);
+
+// Generate `length` payload bytes starting at desc->offset
+void materialize_payload(const payload_desc* desc, uint8_t* out, int length);
+
+// Fragment data: the stored copy, or the bytes generated into scratch (data_size bytes)
+const uint8_t* fragment_payload(const ipv4_fragment* fragment, uint8_t* scratch);
+
+// Reassemble fragments of one datagram into out (capacity bytes)
+// Returns the payload length, or -1 if fragments are missing, overlap or do not fit
+int reassemble_ipv4_fragments(const ipv4_fragment* fragments, int count, uint8_t* out, int capacity);
+
+// Internet checksum (RFC 1071) of a header, the checksum field counting as zero
 uint16_t calculate_checksum(ipv4_header* header);
 
+// Checksum of a header after its TTL is decremented by one, without recomputing it (RFC 1624)
+uint16_t checksum_after_ttl_decrement(uint16_t checksum);
+
 #endif
\ No newline at end of file
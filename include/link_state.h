@@ -0,0 +1,152 @@
+/**
+ * link_state.h
+ * OSPF-like link-state routing: LSA flooding, per-router databases and throttled SPF
+ */
+
+#ifndef LINK_STATE_H
+#define LINK_STATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "graph.h"
+#include "heap.h"
+#include "network.h"
+
+#define LSA_MAX_AGE         3600  // seconds; an LSA this old is ignored by SPF and flushed
+#define LSA_REFRESH_TIME    1800  // seconds; originators flood a fresh copy this often
+#define LSA_AGE_SWEEP       60    // seconds between checks of the databases for MaxAge LSAs
+#define LSA_TRANSMIT_DELAY  1     // seconds added to an LSA's age on every hop
+
+// One link advertised by a router
+typedef struct lsa_link {
+    int neighbor;
+    int cost;
+} lsa_link;
+
+// Router LSA: the originator's outgoing links, immutable once flooded
+typedef struct lsa {
+    int         originator;
+    uint32_t    sequence;
+    int         link_count;
+    lsa_link*   links;           // sorted by neighbor
+    struct lsa* next_allocated;  // every LSA ever built, released with the simulation
+} lsa;
+
+// A router's copy of one originator's LSA
+typedef struct lsdb_entry {
+    const lsa* lsa;
+    int        install_age;    // age in seconds when it was installed
+    long long  install_time;   // simulated microseconds
+} lsdb_entry;
+
+// Link whose cost changed (or that appeared or vanished) since a router's last SPF run
+typedef struct link_delta {
+    int from;
+    int to;
+} link_delta;
+
+typedef struct link_state_config {
+    long long link_delay_us;     // propagation delay of one hop
+    long long lsa_process_us;    // CPU time to process one received LSA
+    long long spf_initial_us;    // SPF delay after the first change of a quiet period
+    long long spf_hold_us;       // minimum gap between SPF runs, doubled while changes keep coming
+    long long spf_max_wait_us;   // upper bound of the hold time
+    double    spf_unit_ns;       // simulated CPU cost of one SPF work unit (node settled or link scanned)
+    bool      incremental;       // incremental SPF when only a few links changed
+} link_state_config;
+
+// Work done by one router since the last link_state_run()
+typedef struct ls_router_stats {
+    long      lsas_received;
+    long      lsas_installed;
+    long      lsas_sent;
+    long      duplicates;       // copies of an LSA already in the database
+    long      lsas_flushed;     // LSAs removed from the database at MaxAge
+    int       spf_full;
+    int       spf_incremental;
+    long      spf_work;         // nodes settled plus links scanned
+    double    cpu_us;           // simulated LSA processing and SPF time
+    long long converged_at;     // end of the router's last SPF run, -1 if none ran
+} ls_router_stats;
+
+typedef struct ls_router {
+    lsdb_entry*     lsdb;       // indexed by originator
+    int*            dist;       // SPF result from this router
+    int*            prev;
+    link_delta*     pending;    // changes not yet seen by SPF
+    int             pending_count;
+    int             pending_capacity;
+    bool            full_spf_needed;
+    bool            spf_scheduled;
+    long long       last_spf;   // start of the last SPF run, -1 before the first
+    long long       hold_us;    // current throttle hold time
+    ls_router_stats stats;
+} ls_router;
+
+typedef struct ls_event ls_event;
+
+typedef struct link_state_sim {
+    link_state_config config;
+    int         node_count;
+    ls_router*  routers;
+    const lsa** origin;        // latest LSA of every originator: the true topology
+    int**       neighbors;     // per node: nodes joined by a link in either direction
+    int*        neighbor_count;
+    int*        neighbor_capacity;
+    lsa*        allocated;
+
+    ls_event*   events;        // event pool
+    int         event_capacity;
+    int         free_event;    // head of the free list, -1 if empty
+    min_heap    queue;         // (time, event) pairs
+    long        event_sequence;
+    long        change_events; // queued events other than refresh and age timers
+    long long   now;           // simulated microseconds
+
+    min_heap    spf_heap;      // shared by every SPF run, the simulation is single-threaded
+    char*       scratch_mark;  // per-node scratch for incremental SPF
+} link_state_sim;
+
+// Outcome of one link_state_run()
+typedef struct ls_report {
+    long long start_us;        // time of the first change that altered an LSA
+    long long flooding_us;     // until the last LSA that altered a database was installed
+    long long convergence_us;  // until the last SPF run finished
+    long      lsa_messages;
+    int       spf_full;
+    int       spf_incremental;
+    long      total_work;
+    long      max_router_work;
+    int       busiest_router;
+    double    max_router_cpu_us;
+    double    mean_router_cpu_us;
+} ls_report;
+
+// Fill a configuration with defaults (1 ms hops, 50/200/5000 ms SPF throttle, incremental SPF)
+void init_link_state_config(link_state_config* config);
+
+// Start a converged simulation: every router holds every LSA and has run SPF once
+void link_state_init(link_state_sim* sim, csr_graph* graph, const link_state_config* config);
+void link_state_init_network(link_state_sim* sim, network_topology* network, const link_state_config* config);
+
+void link_state_free(link_state_sim* sim);
+
+// Schedule router `from` to set its link to `to` (weight 0 removes it) delay_us from now
+// Returns 0, or -1 for invalid nodes or weights
+int link_state_change_link(link_state_sim* sim, long long delay_us, int from, int to, int weight);
+
+// Schedule a change, delay_us from now, for every link where the network differs
+// from the simulation. Returns the number of changes scheduled
+int link_state_sync(link_state_sim* sim, network_topology* network, long long delay_us);
+
+// Process events until the network is quiet and summarize the work since the last run.
+// LSA refreshes and MaxAge flushes that fall due on the way are part of the run
+void link_state_run(link_state_sim* sim, ls_report* report);
+
+// Age in seconds of the originator's LSA in a router's database, -1 if it has none
+int link_state_lsa_age(const link_state_sim* sim, int router, int originator);
+
+// True if every router's distances match Dijkstra on the true topology
+bool link_state_verify(link_state_sim* sim);
+
+#endif /* LINK_STATE_H */
@@ -0,0 +1,57 @@
+/**
+ * lpm.h
+ * Longest-prefix-match table using the DIR-24-8 layout
+ */
+
+#ifndef LPM_H
+#define LPM_H
+
+#include <stdint.h>
+
+#define LPM_NO_ROUTE      0xFFFFFFFFu
+#define LPM_MAX_NEXT_HOP  0x00FFFFFFu   // next hops are stored in 24 bits
+#define LPM_TBL24_ENTRIES (1u << 24)
+#define LPM_TBL8_ENTRIES  256
+
+typedef struct lpm_route {
+    uint32_t prefix;    // host byte order, bits beyond length are ignored
+    uint8_t  length;    // 0..32
+    uint32_t next_hop;  // 0..LPM_MAX_NEXT_HOP
+} lpm_route;
+
+// tbl24 is indexed by the top 24 address bits; entries covering prefixes
+// longer than /24 point to a 256-entry tbl8 group indexed by the last byte.
+// Entry layout: bit 31 valid, bit 30 tbl8 group, bits 24-29 prefix length,
+// bits 0-23 next hop or group index.
+typedef struct lpm_table {
+    uint32_t* tbl24;
+    uint32_t* tbl8;
+    int       tbl8_groups;    // groups in use
+    int       tbl8_capacity;  // groups allocated
+    int       route_count;
+} lpm_table;
+
+// Initialize an empty table
+void lpm_init(lpm_table* table);
+
+// Release the table storage
+void lpm_free(lpm_table* table);
+
+// Insert or overwrite a route, in any order relative to other prefix lengths
+// Returns 0 on success, -1 if the route is invalid
+int lpm_add(lpm_table* table, uint32_t prefix, int length, uint32_t next_hop);
+
+// Next hop of the longest matching prefix, LPM_NO_ROUTE if nothing matches
+uint32_t lpm_lookup(const lpm_table* table, uint32_t address);
+
+// Look up `count` addresses at once
+void lpm_lookup_batch(const lpm_table* table, const uint32_t* addresses, uint32_t* next_hops, int count);
+
+// Load routes from a text file with one "a.b.c.d/len next_hop" per line
+// Returns the number of routes read (caller frees *routes), or -1 if the file cannot be opened
+int lpm_load_routes(const char* path, lpm_route** routes);
+
+// Generate `count` routes with a prefix-length mix resembling an Internet routing table
+void lpm_generate_routes(lpm_route** routes, int count, int next_hop_count, unsigned int seed);
+
+#endif /* LPM_H */
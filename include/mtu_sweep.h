@@ -0,0 +1,74 @@
+/**
+ * mtu_sweep.h
+ * Fragmentation overhead for every (MTU, payload size) pair without building packets
+ */
+
+#ifndef MTU_SWEEP_H
+#define MTU_SWEEP_H
+
+#include <stdbool.h>
+#include "ipv4.h"
+
+#define MTU_SWEEP_MIN_MTU 68     // smallest MTU every IPv4 link must support
+#define MTU_SWEEP_MAX_MTU 9000   // jumbo frames
+#define MTU_SWEEP_MAX_BINS 256
+
+// Layout of one datagram, as fragment_ipv4_packet() would produce it
+typedef struct fragment_layout {
+    int fragments;
+    int header_bytes;     // IPv4 header bytes across all fragments
+    int wire_bytes;       // payload + header bytes
+    int wasted_bytes;     // MTU capacity left unused: fragments * mtu - wire_bytes
+} fragment_layout;
+
+typedef struct mtu_sweep_config {
+    int mtu_min;
+    int mtu_max;
+    int payload_min;
+    int payload_max;
+    int payload_bins;     // heatmap columns, payload range split evenly (1..MTU_SWEEP_MAX_BINS)
+    int threads;          // worker threads, <= 0 to use every online core
+} mtu_sweep_config;
+
+// Totals over a range of payload sizes for one MTU
+typedef struct mtu_sweep_cell {
+    long long payload_bytes;
+    long long fragments;
+    long long header_bytes;
+    long long wasted_bytes;
+} mtu_sweep_cell;
+
+typedef struct mtu_sweep_result {
+    int mtu_min;
+    int mtu_count;
+    int payload_min;
+    int payload_max;
+    int payload_bins;
+    mtu_sweep_cell* totals;   // per MTU, over the whole payload range
+    mtu_sweep_cell* cells;    // per MTU and payload bin, mtu_count * payload_bins
+    int* max_fragments;       // per MTU
+    double elapsed_seconds;
+} mtu_sweep_result;
+
+// Fill a configuration with defaults (MTU 68..9000, payload 1..MAX_PAYLOAD_SIZE, 64 bins, all cores)
+void init_mtu_sweep_config(mtu_sweep_config* config);
+
+// Fragment layout of a payload_size byte datagram on an MTU, false if the MTU cannot carry it
+bool fragment_layout_of(int mtu, int payload_size, fragment_layout* layout);
+
+// First payload size of a heatmap bin (bin == payload_bins gives payload_max + 1)
+int mtu_sweep_bin_start(const mtu_sweep_result* result, int bin);
+
+// Run the sweep across threads. Returns 0 on success, -1 for an invalid configuration
+int run_mtu_sweep(const mtu_sweep_config* config, mtu_sweep_result* result);
+
+// Check sampled points of a sweep against fragment_ipv4_packet()
+// Returns the number of mismatching samples
+int mtu_sweep_verify(const mtu_sweep_result* result, int samples, unsigned int seed);
+
+// Write one CSV row per (MTU, payload bin). Returns 0 on success, -1 if the file cannot be written
+int mtu_sweep_write_csv(const mtu_sweep_result* result, const char* path);
+
+void mtu_sweep_free(mtu_sweep_result* result);
+
+#endif /* MTU_SWEEP_H */
@@ -0,0 +1,62 @@
+/**
+ * multicast.h
+ * One-to-many routing: distribution trees and fragment forwarding to receiver sets
+ */
+
+#ifndef MULTICAST_H
+#define MULTICAST_H
+
+#include <stdbool.h>
+#include "graph.h"
+#include "ipv4.h"
+#include "network.h"
+
+// Shortest-path tree of a source pruned to the links that lead to a receiver
+typedef struct multicast_tree {
+    int       source;
+    int       node_count;
+    int       receiver_count;   // distinct reachable receivers, the source excluded
+    int       unreachable;      // requested receivers without a route
+    int       link_count;       // links of the distribution tree
+    long long unicast_hops;     // links crossed by one unicast copy per receiver
+    int*      parent;           // per node: upstream node on the tree, -1 off the tree and for the source
+    int*      depth;            // per node: hops from the source, -1 off the tree
+    bool*     is_receiver;
+    int*      child_offsets;    // node_count + 1 entries, children of u are [child_offsets[u], child_offsets[u+1])
+    int*      children;         // link_count downstream nodes
+} multicast_tree;
+
+// Link usage of one datagram delivered over a tree, and of unicast replication
+typedef struct multicast_report {
+    int       fragments;
+    long long fragment_bytes;         // wire bytes of one copy of every fragment
+    long long transmissions;          // fragment copies sent over tree links
+    long long link_bytes;
+    long long unicast_transmissions;  // same receivers, one copy per receiver along its path
+    long long unicast_link_bytes;
+    long long deliveries;             // fragment copies that reached a receiver
+    double    savings;                // 1 - link_bytes / unicast_link_bytes
+} multicast_report;
+
+// Compute the shortest-path tree of source once and keep the paths to the receivers
+// (duplicates and the source itself are ignored). Returns the number of reachable
+// receivers, or -1 for an invalid source or receiver
+int multicast_tree_build(multicast_tree* tree, csr_graph* graph, int source, const int* receivers, int receiver_count);
+
+// Same for the links of a network topology
+int multicast_tree_build_topology(multicast_tree* tree, network_topology* network, int source,
+                                  const int* receivers, int receiver_count);
+
+// Release the arrays of a tree
+void multicast_tree_free(multicast_tree* tree);
+
+// Path from the source to one receiver on the tree, same contract as dijkstra()
+int multicast_tree_path(const multicast_tree* tree, int receiver, int** path);
+
+// Account for forwarding fragments down the tree, one copy per tree link: counts the
+// transmissions, link bytes and deliveries and compares them with sending every
+// receiver its own copy along the same routes. Nothing is sent or copied
+void multicast_forward(const multicast_tree* tree, const ipv4_fragment* fragments, int count,
+                       multicast_report* report);
+
+#endif /* MULTICAST_H */
@@ -5,6 +5,8 @@
 
 #define MAX_NODES 20
 
+struct route_cache;
+
 typedef struct network_topology
 {
     int node_count;
@@ -23,8 +25,9 @@ void create_test_topology(network_topology* network);
 // Create a custom topology based on user input
 void create_custom_topology(network_topology* network);
 
-// Modify the network topology (for dynamic routing simulation)
-void modify_network_topology(network_topology* network);
+// Modify the network topology (for dynamic routing simulation). Every edit is
+// applied as one transaction and the routes (may be NULL) are refreshed once
+void modify_network_topology(network_topology* network, struct route_cache* routes);
 
 // Check if node is valid in the given network
 bool is_valid_node(network_topology* network, int node);
@@ -0,0 +1,67 @@
+/**
+ * queue_sim.h
+ * Congestion simulation: fragments forwarded through bounded router output queues
+ */
+
+#ifndef QUEUE_SIM_H
+#define QUEUE_SIM_H
+
+#include <stdbool.h>
+#include "network.h"
+
+#define QUEUE_FAIR_BUCKETS 64    // flow buckets per output queue for fair queueing
+#define QUEUE_FAIR_QUANTUM 1500  // bytes a bucket may send per round
+
+// What an output queue does when a fragment does not fit
+typedef enum queue_policy {
+    QUEUE_TAIL_DROP,   // drop the arriving fragment
+    QUEUE_RED,         // drop early with a probability growing with the average queue
+    QUEUE_FAIR         // per-flow buckets served by deficit round robin, drop from the longest
+} queue_policy;
+
+typedef struct queue_sim_config {
+    queue_policy policy;
+    int          mtu;
+    int          payload_size;   // payload bytes of every datagram
+    double       offered_load;   // offered payload rate of all flows / link bandwidth
+    long long    bandwidth_bps;  // every link
+    int          buffer_bytes;   // output queue size of every link
+    long long    delay_ns;       // propagation delay per unit of link weight
+    int          flow_count;     // source/destination pairs, flow i offers a share ~ 1 / (i + 1)
+    double       duration_s;     // datagrams are generated for this long
+    unsigned int seed;
+} queue_sim_config;
+
+typedef struct queue_sim_report {
+    int       flows;              // flows with a route (may be fewer than requested)
+    long      datagrams_sent;
+    long      datagrams_delivered;
+    long      fragments_sent;
+    long      fragments_dropped;
+    long long wire_bytes;         // bytes transmitted on all links, including doomed fragments
+    long long goodput_bytes;      // payload of datagrams that arrived complete
+    double    fragment_loss;
+    double    datagram_loss;
+    double    amplification;      // datagram loss / fragment loss
+    double    goodput_bps;
+    double    light_flow_loss;    // datagram loss of the flow offering the least traffic
+    double    heavy_flow_loss;    // datagram loss of the flow offering the most
+    double    mean_delay_ms;      // creation to last fragment, delivered datagrams only
+    long      events;
+    double    elapsed_seconds;
+} queue_sim_report;
+
+// Fill a configuration with defaults (tail drop, MTU 1500, 4000 byte payloads, load 2.5, 100 Mb/s, 64 KB buffers)
+void init_queue_sim_config(queue_sim_config* config);
+
+// Parse a policy name ("tail", "red", "fq"), returns false if unknown
+bool parse_queue_policy(const char* name, queue_policy* policy);
+
+// Name of a policy for display
+const char* queue_policy_name(queue_policy policy);
+
+// Simulate the flows over the network's links until every fragment is delivered or dropped
+// Returns 0 on success, -1 for an invalid configuration or if no flow has a route
+int run_queue_sim(network_topology* network, const queue_sim_config* config, queue_sim_report* report);
+
+#endif /* QUEUE_SIM_H */
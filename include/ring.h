@@ -0,0 +1,44 @@
+/**
+ * ring.h
+ * Bounded lock-free single-producer/single-consumer ring buffer
+ */
+
+#ifndef RING_H
+#define RING_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define RING_CACHE_LINE 64
+
+typedef struct spsc_ring {
+    // Written by the producer only
+    _Alignas(RING_CACHE_LINE) atomic_size_t head;
+    // Written by the consumer only
+    _Alignas(RING_CACHE_LINE) atomic_size_t tail;
+
+    _Alignas(RING_CACHE_LINE) size_t mask;  // capacity - 1 (capacity is a power of two)
+    void** slots;
+} spsc_ring;
+
+// Initialize a ring holding at least `capacity` entries (rounded up to a power of two)
+// Returns false if the slot array could not be allocated
+bool spsc_ring_init(spsc_ring* ring, size_t capacity);
+
+// Release the slot array (the ring must no longer be in use)
+void spsc_ring_destroy(spsc_ring* ring);
+
+// Push an entry from the producer thread, returns false if the ring is full
+bool spsc_ring_push(spsc_ring* ring, void* item);
+
+// Pop an entry from the consumer thread, returns NULL if the ring is empty
+void* spsc_ring_pop(spsc_ring* ring);
+
+// Approximate number of queued entries (safe to call from any thread)
+size_t spsc_ring_size(spsc_ring* ring);
+
+// Total number of slots
+size_t spsc_ring_capacity(spsc_ring* ring);
+
+#endif /* RING_H */
@@ -0,0 +1,96 @@
+/**
+ * route_cache.h
+ * Shared per-source shortest-path trees and compact route handles
+ */
+
+#ifndef ROUTE_CACHE_H
+#define ROUTE_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "dense_graph.h"
+#include "graph.h"
+#include "network.h"
+
+#define ROUTE_MAX_NODES 0xFFFF   // node ids must fit in 16 bits
+#define ROUTE_NO_PREV   0xFFFF   // predecessor of the source and of unreachable nodes
+#define ROUTE_NO_TREE   0xFFFF   // tree id of a handle that names no route
+
+// What a fragment stores about its route: 4 bytes instead of a path copy
+typedef struct route_handle {
+    uint16_t tree;         // id of the source's shortest-path tree in the cache
+    uint16_t destination;
+} route_handle;
+
+// Predecessor array of one source, shared by every fragment routed from it
+typedef struct shortest_path_tree {
+    int       source;    // -1 while the id is free
+    int       refs;      // handles issued by route_cache_lookup() and not released
+    uint16_t* prev;
+} shortest_path_tree;
+
+typedef struct route_cache {
+    csr_graph graph;          // topology the current trees are computed on
+    int       owns_graph;     // graph was built by the cache and is freed with it
+    int       node_count;
+    dense_graph dense;        // matrix copy of graph when dense_preferred() picks it
+    bool        use_dense;
+
+    shortest_path_tree* trees;   // indexed by tree id
+    int                 tree_count;    // ids handed out so far, free ones included
+    int                 tree_capacity;
+    int*                free_ids;      // ids of freed trees, reused before new ones
+    int                 free_count;
+    bool                full_reported; // "cache full" printed once
+    int*                current; // per source: tree id for the current topology, -1 if not built
+} route_cache;
+
+// Handle naming no route
+extern const route_handle ROUTE_HANDLE_NONE;
+
+// Create a cache for a network topology / an existing CSR graph (not copied, must outlive the cache)
+void route_cache_init(route_cache* cache, network_topology* network);
+void route_cache_init_csr(route_cache* cache, csr_graph* graph);
+
+// Release every tree and the cache's own graph
+void route_cache_free(route_cache* cache);
+
+// Switch to a changed topology with the same nodes; handles issued earlier keep
+// expanding to their old routes until they are released
+void route_cache_update(route_cache* cache, network_topology* network);
+
+// A link whose weight changed, 0 meaning no link
+typedef struct route_link_change {
+    int from;
+    int to;
+    int old_weight;
+    int new_weight;
+} route_link_change;
+
+// Switch to a topology that differs from the cached one by `changes`, recomputing
+// at once only the current trees the changes can alter; the others stay in use.
+// A superseded tree is freed, or once its last handle is released.
+// Returns the number of trees recomputed
+int route_cache_update_links(route_cache* cache, network_topology* network,
+                             const route_link_change* changes, int count);
+
+// Route from source to destination, computing the source tree on first use
+// Returns ROUTE_HANDLE_NONE if the destination is unreachable, or if ROUTE_NO_TREE
+// trees are all still referenced (reported once on stderr)
+route_handle route_cache_lookup(route_cache* cache, int source, int destination);
+
+// Give back a handle that is no longer needed. A tree superseded by a topology
+// change is freed, and its id reused, once no handle references it. Handles that
+// are never released keep their tree for the life of the cache
+void route_cache_release(route_cache* cache, route_handle route);
+
+// Number of nodes on the route (hops + 1), -1 for ROUTE_HANDLE_NONE
+int route_path_length(const route_cache* cache, route_handle route);
+
+// Expand a route into a freshly allocated node array, same contract as dijkstra()
+int route_expand_path(const route_cache* cache, route_handle route, int** path);
+
+// Bytes held by the live trees of the cache
+long route_cache_memory(const route_cache* cache);
+
+#endif /* ROUTE_CACHE_H */
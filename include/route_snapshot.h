@@ -0,0 +1,112 @@
+/**
+ * route_snapshot.h
+ * Binary snapshots of a topology and its shortest-path trees, used in place through mmap
+ */
+
+#ifndef ROUTE_SNAPSHOT_H
+#define ROUTE_SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "graph.h"
+
+#define ROUTE_SNAPSHOT_MAGIC     "IPV4RTSN"
+#define ROUTE_SNAPSHOT_VERSION   2
+#define ROUTE_SNAPSHOT_ALIGNMENT 4096        // every section starts on a page boundary
+#define ROUTE_SNAPSHOT_NONE      0xFFFFFFFFu // predecessor / next hop of unreachable nodes
+#define ROUTE_SNAPSHOT_ANY_TOPOLOGY 0        // topology hash accepting every snapshot
+
+// Status codes of snapshot operations
+#define ROUTE_SNAPSHOT_OK             0
+#define ROUTE_SNAPSHOT_ERR_IO        -1   // file cannot be created, opened or mapped
+#define ROUTE_SNAPSHOT_ERR_INVALID   -2   // bad magic, version, layout or header checksum, or bad arguments
+#define ROUTE_SNAPSHOT_ERR_CHECKSUM  -3   // section data does not match its checksum
+#define ROUTE_SNAPSHOT_ERR_STALE     -4   // snapshot was built for a different topology or source set
+
+// Sections of the file, each an array of 32-bit words
+typedef enum snapshot_section_id {
+    SNAPSHOT_OFFSETS,     // node_count + 1 CSR offsets
+    SNAPSHOT_TARGETS,     // edge_count CSR targets
+    SNAPSHOT_WEIGHTS,     // edge_count CSR weights
+    SNAPSHOT_SOURCES,     // tree_count source nodes
+    SNAPSHOT_TREE_INDEX,  // node_count tree ids, ROUTE_SNAPSHOT_NONE if the node has no tree
+    SNAPSHOT_PREV,        // tree_count * node_count predecessors, one row per tree
+    SNAPSHOT_NEXT_HOP,    // tree_count * node_count first hops, one row per tree
+    SNAPSHOT_SECTION_COUNT
+} snapshot_section_id;
+
+typedef struct snapshot_section {
+    uint64_t offset;      // from the start of the file, multiple of ROUTE_SNAPSHOT_ALIGNMENT
+    uint64_t size;        // bytes, without padding
+    uint64_t checksum;
+} snapshot_section;
+
+// First page of the file; every field is in host byte order
+typedef struct route_snapshot_header {
+    char             magic[8];
+    uint32_t         version;
+    uint32_t         byte_order;      // 0x01020304 as written by the host
+    uint32_t         alignment;
+    uint32_t         node_count;
+    uint32_t         edge_count;
+    uint32_t         tree_count;
+    uint32_t         max_weight;
+    uint32_t         reserved;
+    uint64_t         topology_hash;
+    uint64_t         sources_hash;    // route_snapshot_sources_hash() of the tree sources
+    uint64_t         file_size;
+    snapshot_section sections[SNAPSHOT_SECTION_COUNT];
+    uint64_t         header_checksum; // over the header with this field zero
+} route_snapshot_header;
+
+// An open snapshot; every pointer refers to the read-only mapping
+typedef struct route_snapshot {
+    void*                        map;
+    size_t                       map_size;
+    const route_snapshot_header* header;
+    csr_graph                    graph;       // read only, never csr_free() it
+    int                          node_count;
+    int                          tree_count;
+    const uint32_t*              sources;
+    const uint32_t*              tree_index;
+    const uint32_t*              prev;
+    const uint32_t*              next_hop;
+} route_snapshot;
+
+// 64-bit FNV-1a hash of the node count, edges and weights of a graph
+uint64_t route_snapshot_topology_hash(const csr_graph* graph);
+
+// 64-bit FNV-1a hash of a set of sources, independent of their order
+uint64_t route_snapshot_sources_hash(const int* sources, int source_count);
+
+// Compute the trees of `sources` on the graph and write graph and trees to path
+// (through a temporary file renamed into place). Returns ROUTE_SNAPSHOT_OK,
+// ROUTE_SNAPSHOT_ERR_IO, or ROUTE_SNAPSHOT_ERR_INVALID for bad or duplicate sources
+int route_snapshot_write(const char* path, csr_graph* graph, const int* sources, int source_count);
+
+// Map a snapshot read-only. The header is always checked; verify_data also checks
+// every section (reading the whole file). topology_hash must match the snapshot's
+// unless it is ROUTE_SNAPSHOT_ANY_TOPOLOGY. Returns ROUTE_SNAPSHOT_OK or an error code
+int route_snapshot_open(route_snapshot* snapshot, const char* path, uint64_t topology_hash, bool verify_data);
+
+// Unmap a snapshot
+void route_snapshot_close(route_snapshot* snapshot);
+
+// Open the snapshot at path if it matches the graph and holds the trees of exactly
+// these sources, otherwise rebuild it for the sources and open the new file.
+// *rebuilt tells which happened (may be NULL)
+int route_snapshot_load_or_build(route_snapshot* snapshot, const char* path, csr_graph* graph,
+                                 const int* sources, int source_count, bool* rebuilt);
+
+// Description of a status code
+const char* route_snapshot_error(int status);
+
+// First hop from router towards destination (the router itself for its own node)
+// Returns -1 if the router has no tree in the snapshot or the destination is unreachable
+int route_snapshot_next_hop(const route_snapshot* snapshot, int router, int destination);
+
+// Shortest path from source to destination, same contract as dijkstra()
+int route_snapshot_path(const route_snapshot* snapshot, int source, int destination, int** path);
+
+#endif /* ROUTE_SNAPSHOT_H */
@@ -0,0 +1,66 @@
+/**
+ * session_log.h
+ * Record and replay of interactive sessions: every input and topology event in a binary log
+ */
+
+#ifndef SESSION_LOG_H
+#define SESSION_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "network.h"
+
+typedef enum session_mode {
+    SESSION_LIVE,     // inputs come from stdin, nothing is logged
+    SESSION_RECORD,   // inputs come from stdin and are appended to the log
+    SESSION_REPLAY    // inputs come from the log, console output is discarded
+} session_mode;
+
+// Where the time of a session goes; inputs cost nothing when replaying
+typedef enum session_phase {
+    SESSION_PHASE_SETUP,        // topology, packet and fragmentation
+    SESSION_PHASE_ROUTING,      // route lookups and fragment display
+    SESSION_PHASE_TOPOLOGY,     // topology changes, fast reroute and link-state reports
+    SESSION_PHASE_CONGESTION,   // congestion simulation of the chosen MTU
+    SESSION_PHASE_COUNT
+} session_phase;
+
+typedef struct session_report {
+    session_mode mode;
+    long         inputs;               // values read (or replayed)
+    long         topology_events;
+    long         log_bytes;
+    uint64_t     digest;               // FNV-1a over every result fed to session_digest()
+    uint64_t     recorded_digest;      // digest stored in the log (replay only)
+    bool         diverged;             // replayed topology or digest differs from the recording
+    double       phase_seconds[SESSION_PHASE_COUNT];
+    double       total_seconds;
+} session_report;
+
+// Start recording to / replaying from a log file; returns 0, or -1 if it cannot be
+// opened or is not a session log. Replay discards stdout until session_finish()
+int session_record_start(const char* path);
+int session_replay_start(const char* path);
+
+// Input wrappers used instead of scanf: "%d", " %c" and "%<size-1>s". Return 1 if a
+// value was read, 0 if not (as scanf would). A replay that runs out of inputs exits
+int session_read_int(int* value);
+int session_read_char(char* value);
+int session_read_word(char* buffer, int size);
+
+// Topology event: the whole topology after it was created or changed. Recorded in
+// the log and checked against the recording when replaying
+void session_topology(const network_topology* network);
+
+// Fold a result into the session digest
+void session_digest(const void* data, size_t size);
+
+// Charge the time from now on to a phase
+void session_set_phase(session_phase phase);
+
+// End the session: store (record) or check (replay) the digest, restore stdout and
+// fill the report. Returns 0, or -1 if a replay diverged from its recording
+int session_finish(session_report* report);
+
+#endif /* SESSION_LOG_H */
@@ -0,0 +1,90 @@
+/**
+ * topology_rcu.h
+ * Versioned immutable topology snapshots with read-copy-update publication
+ */
+
+#ifndef TOPOLOGY_RCU_H
+#define TOPOLOGY_RCU_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "graph.h"
+#include "network.h"
+
+#define TOPOLOGY_BLOCK_NODES 64  // nodes per copy-on-write adjacency block
+#define RCU_MAX_READERS 64
+
+// Adjacency lists of TOPOLOGY_BLOCK_NODES consecutive nodes, never modified
+// once published; versions that did not touch these nodes share the block
+typedef struct adjacency_block {
+    int  refcount;                            // versions referencing the block (writer only)
+    int  offsets[TOPOLOGY_BLOCK_NODES + 1];   // edges of local node i are [offsets[i], offsets[i+1])
+    int* targets;
+    int* weights;
+} adjacency_block;
+
+typedef struct topology_version {
+    unsigned long     version;
+    int               node_count;
+    int               block_count;
+    adjacency_block** blocks;
+
+    // Reclamation bookkeeping (writer only)
+    unsigned long            retire_epoch;
+    struct topology_version* next_retired;
+} topology_version;
+
+// A single edge update: weight > 0 adds or reweights from -> to, weight 0 removes it
+typedef struct topology_change {
+    int from;
+    int to;
+    int weight;
+} topology_change;
+
+typedef struct rcu_reader {
+    _Alignas(64) atomic_ulong epoch;  // epoch announced while pinned, 0 when quiescent
+} rcu_reader;
+
+typedef struct topology_store {
+    _Atomic(topology_version*) current;
+    atomic_ulong               global_epoch;
+    atomic_int                 reader_count;
+    rcu_reader                 readers[RCU_MAX_READERS];
+
+    pthread_mutex_t   writer_lock;
+    topology_version* retired;        // versions waiting for readers to move on
+    unsigned long     published;
+    unsigned long     reclaimed;
+    unsigned long     blocks_copied;
+} topology_store;
+
+// Create a store whose first version is the given network / CSR graph
+void topology_store_init(topology_store* store, network_topology* network);
+void topology_store_init_csr(topology_store* store, csr_graph* graph);
+
+// Free every version (no reader may be pinned)
+void topology_store_destroy(topology_store* store);
+
+// Register a reader thread, returns its slot or -1 if all slots are taken
+int topology_register_reader(topology_store* store);
+
+// Pin the current version for the reader; it stays valid until the unlock
+const topology_version* topology_read_lock(topology_store* store, int reader);
+void topology_read_unlock(topology_store* store, int reader);
+
+// Apply a batch of changes as one new version, published atomically
+// Returns the new version number, or 0 if a change was invalid (nothing is published)
+unsigned long topology_store_apply(topology_store* store, const topology_change* changes, int count);
+
+// Free retired versions no pinned reader can still see, returns how many were freed.
+// Takes the writer lock, so it may run while another thread applies changes
+int topology_store_reclaim(topology_store* store);
+
+// Weight of from -> to in a version, 0 if there is no such edge
+int topology_version_weight(const topology_version* version, int from, int to);
+
+// Shortest path on a pinned version, same contract as dijkstra() but silent
+// on unreachable destinations; returns the path length or -1
+int topology_version_route(const topology_version* version, int source, int destination, int** path);
+
+#endif /* TOPOLOGY_RCU_H */
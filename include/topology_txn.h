@@ -0,0 +1,63 @@
+/**
+ * topology_txn.h
+ * Batched topology updates: staged link changes applied atomically with one route refresh
+ */
+
+#ifndef TOPOLOGY_TXN_H
+#define TOPOLOGY_TXN_H
+
+#include "network.h"
+#include "route_cache.h"
+
+typedef enum topology_op {
+    TOPOLOGY_ADD_LINK,      // the link must not exist yet
+    TOPOLOGY_REMOVE_LINK,   // the link must exist
+    TOPOLOGY_SET_WEIGHT     // the link must exist
+} topology_op;
+
+typedef struct topology_edit {
+    topology_op op;
+    int         from;
+    int         to;
+    int         weight;     // ignored by TOPOLOGY_REMOVE_LINK
+} topology_edit;
+
+// Changes staged against one topology; nothing is visible until the commit
+typedef struct topology_txn {
+    network_topology* network;
+    topology_edit*    changes;
+    int               count;
+    int               capacity;
+} topology_txn;
+
+typedef struct topology_txn_result {
+    int         applied;             // changes applied, 0 if the batch was rejected
+    int         links_changed;       // distinct links whose weight differs afterwards
+    int         failed_change;       // index of the first invalid change, -1 if none
+    const char* error;               // why it is invalid, NULL if none
+    int         trees_recomputed;
+    double      apply_seconds;       // validation and the topology swap
+    double      recompute_seconds;   // the single route refresh
+} topology_txn_result;
+
+// Start an empty transaction on a topology
+void topology_txn_begin(topology_txn* txn, network_topology* network);
+
+// Stage one change; changes are checked in order at commit, each against the
+// topology left by the ones before it
+void topology_txn_add_link(topology_txn* txn, int from, int to, int weight);
+void topology_txn_remove_link(topology_txn* txn, int from, int to);
+void topology_txn_set_weight(topology_txn* txn, int from, int to, int weight);
+
+// Validate every staged change and apply them all or none. On success the routes
+// (may be NULL) are refreshed once, recomputing only the trees the changes affect.
+// Returns 0, or -1 if a change is invalid (see result). The transaction is empty afterwards
+int topology_txn_commit(topology_txn* txn, route_cache* routes, topology_txn_result* result);
+
+// Drop the staged changes
+void topology_txn_abort(topology_txn* txn);
+
+// Release the transaction's storage
+void topology_txn_free(topology_txn* txn);
+
+#endif /* TOPOLOGY_TXN_H */
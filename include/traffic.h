@@ -0,0 +1,72 @@
+/**
+ * traffic.h
+ * Multi-threaded traffic generator: generate -> fragment -> route -> sink
+ */
+
+#ifndef TRAFFIC_H
+#define TRAFFIC_H
+
+#include <stdbool.h>
+#include "network.h"
+#include "ipv4.h"
+#include "wire.h"
+
+#define TRAFFIC_MAX_BATCH 256
+#define TRAFFIC_STAGE_COUNT 4
+
+// Datagram size distributions
+typedef enum flow_mix {
+    FLOW_MIX_IMIX,        // 40/576/1500 byte datagrams in a 7:4:1 ratio
+    FLOW_MIX_UNIFORM,     // payload uniform in 1..MAX_PAYLOAD_SIZE
+    FLOW_MIX_HEAVY_TAIL   // Pareto distributed payload, capped at MAX_PAYLOAD_SIZE
+} flow_mix;
+
+typedef struct traffic_config {
+    flow_mix mix;
+    long     datagram_count;  // total datagrams to generate
+    int      mtu;
+    int      flow_count;      // number of distinct source/destination pairs
+    int      batch_size;      // datagrams per batch (1..TRAFFIC_MAX_BATCH)
+    int      queue_capacity;  // batches per inter-stage ring
+    bool     virtual_payload; // carry payload descriptors instead of payload bytes
+    int      output_fd;       // the sink writes wire fragments here with writev, -1 for none
+    unsigned int seed;
+} traffic_config;
+
+// Counters for one pipeline stage
+typedef struct stage_stats {
+    const char* name;
+    long   datagrams;        // datagrams handled by this stage
+    long   fragments;        // fragments handled by this stage
+    long   batches;
+    double busy_seconds;     // time spent working (not waiting on a queue)
+    double wait_seconds;     // time spent waiting for input or for space downstream
+    double avg_occupancy;    // average input queue occupancy seen on each pop
+    int    queue_capacity;   // capacity of the input queue (0 for the generator)
+} stage_stats;
+
+typedef struct traffic_report {
+    stage_stats stages[TRAFFIC_STAGE_COUNT];
+    double elapsed_seconds;
+    long   datagrams;        // routed datagrams delivered to the sink
+    long   fragments;        // their fragments
+    long   wire_bytes;       // sum of fragment total lengths delivered to the sink
+    long   unroutable;       // datagrams for which no path was found
+    wire_stats output;       // writes of the sink, all zero without an output
+    int    output_error;     // errno of a failed write, 0 if none
+} traffic_report;
+
+// Fill a configuration with defaults (IMIX, 1M datagrams, MTU 1500, real payloads, no output)
+void init_traffic_config(traffic_config* config);
+
+// Parse a flow mix name ("imix", "uniform", "heavy"), returns false if unknown
+bool parse_flow_mix(const char* name, flow_mix* mix);
+
+// Name of a flow mix for display
+const char* flow_mix_name(flow_mix mix);
+
+// Run the staged pipeline over the network, each stage on its own thread
+// Returns 0 on success, -1 if the pipeline could not be set up
+int run_traffic_pipeline(network_topology* network, const traffic_config* config, traffic_report* report);
+
+#endif /* TRAFFIC_H */
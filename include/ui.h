@@ -8,6 +8,12 @@
  
  #include "network.h"
  #include "ipv4.h"
+ #include "traffic.h"
+ #include "mtu_sweep.h"
+ #include "link_state.h"
+ #include "queue_sim.h"
+ #include "fast_reroute.h"
+ #include "session_log.h"
  
  // Display the welcome banner and program information
  void display_welcome_banner();
@@ -27,7 +33,26 @@
  // Display fragment information
  void display_fragment_info(ipv4_fragment* fragment, int fragment_num);
  
- // Display the route path for a fragment
- void display_route_path(ipv4_fragment* fragment);
+ // Display the route path for a fragment, expanded from its shared shortest-path tree
+ void display_route_path(const route_cache* routes, ipv4_fragment* fragment);
+ 
+ // Display per-stage throughput and queue occupancy of a traffic run
+ void display_traffic_report(const traffic_config* config, const traffic_report* report);
+ 
+ // Display common MTUs and an overhead heatmap of an MTU sweep
+ void display_mtu_sweep(const mtu_sweep_result* result);
+ 
+ // Display convergence time and the per-router work of a link-state run
+ // (every router if max_routers <= 0, otherwise the busiest ones)
+ void display_link_state_report(const link_state_sim* sim, const ls_report* report, int max_routers);
+ 
+ // Display one congestion run as a table row, preceded by the column names if header is set
+ void display_queue_sim_report(const queue_sim_config* config, const queue_sim_report* report, bool header);
+ 
+ // Display the fragments lost while routers reconverge after links failed, with and without fast reroute
+ void display_frr_report(const frr_sim_report* report);
+ 
+ // Display the digest and per-phase timings of a recorded or replayed session
+ void display_session_report(const session_report* report);
  
  #endif /* UI_H */
\ No newline at end of file
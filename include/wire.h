@@ -0,0 +1,54 @@
+/**
+ * wire.h
+ * Scatter-gather emission of fragments to a file descriptor with writev
+ */
+
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+#include "ipv4.h"
+
+#define WIRE_MAX_IOV        1024          // iovecs per writev call (IOV_MAX on Linux)
+#define WIRE_ARENA_SIZE     (256 * 1024)  // payload bytes generated for virtual fragments per flush
+
+typedef struct wire_stats {
+    long      datagrams;
+    long      fragments;
+    long      syscalls;   // writev calls, including ones that wrote only part of a batch
+    long long bytes;
+} wire_stats;
+
+// Bounded output queue: each fragment is two iovecs, its serialized header and
+// a pointer to its data; the queue is written with writev once it is full
+typedef struct wire_writer {
+    int           fd;
+    struct iovec* iov;
+    int           iov_count;
+    int           iov_capacity;
+    uint8_t*      headers;          // IPV4_HEADER_SIZE bytes per queued fragment
+    uint8_t*      arena;            // bytes of queued virtual fragments
+    size_t        arena_used;
+    int           error;            // errno of the first failed write, 0 if none
+    wire_stats    stats;
+} wire_writer;
+
+// Create a writer queueing up to max_fragments fragments (1..WIRE_MAX_IOV / 2) per writev
+void wire_writer_init(wire_writer* writer, int fd, int max_fragments);
+
+// Flush and release the queue (the descriptor is not closed)
+// Returns 0, or -1 if any write failed
+int wire_writer_free(wire_writer* writer);
+
+// Queue the fragments of a packet, flushing whenever the queue fills. Fragment data
+// points into packet->payload (or the fragment's own copy) and is not copied, so it
+// must stay valid until the next wire_flush(). Returns 0, or -1 after a write error
+int wire_emit(wire_writer* writer, const ipv4_packet* packet, const ipv4_fragment* fragments, int count);
+
+// Write everything queued, resuming after partial writes
+// Returns 0, or -1 if a write failed (the queue is dropped)
+int wire_flush(wire_writer* writer);
+
+#endif /* WIRE_H */
@@ -0,0 +1,1344 @@
+/**
+ * bench.c
+ * Benchmark drivers selected from the command line
+ */
+
+#include <pthread.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../include/bench.h"
+#include "../include/delta_stepping.h"
+#include "../include/dense_graph.h"
+#include "../include/fast_reroute.h"
+#include "../include/graph.h"
+#include "../include/ipv4.h"
+#include "../include/link_state.h"
+#include "../include/lpm.h"
+#include "../include/multicast.h"
+#include "../include/route_cache.h"
+#include "../include/route_snapshot.h"
+#include "../include/topology_rcu.h"
+#include "../include/topology_txn.h"
+#include "../include/wire.h"
+
+double bench_now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// SSSP scaling benchmark: network_sim --bench-sssp [nodes] [degree] [max_weight]
+int run_sssp_benchmark(int argc, char* argv[])
+{
+    int nodes = (argc > 2) ? atoi(argv[2]) : 1000000;
+    int degree = (argc > 3) ? atoi(argv[3]) : 8;
+    int max_weight = (argc > 4) ? atoi(argv[4]) : 100;
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (nodes < 2) {
+        printf("Number of nodes must be at least 2\n");
+        return EXIT_FAILURE;
+    }
+
+    csr_graph graph;
+    csr_generate_random(&graph, nodes, degree, max_weight, 42);
+    printf("Generated graph: %d nodes, %d edges, weights 1-%d\n",
+           nodes, graph.edge_count, max_weight);
+
+    int* ref_dist = (int*)malloc(nodes * sizeof(int));
+    int* ref_prev = (int*)malloc(nodes * sizeof(int));
+    int* dist = (int*)malloc(nodes * sizeof(int));
+    int* prev = (int*)malloc(nodes * sizeof(int));
+    if (ref_dist == NULL || ref_prev == NULL || dist == NULL || prev == NULL) {
+        fprintf(stderr, "Memory allocation failed for benchmark\n");
+        exit(EXIT_FAILURE);
+    }
+
+    double start = bench_now_seconds();
+    dijkstra_csr(&graph, 0, ref_dist, ref_prev);
+    double sequential = bench_now_seconds() - start;
+    printf("Sequential Dijkstra: %.3f s\n\n", sequential);
+
+    delta_stepping_config config;
+    init_delta_stepping_config(&config);
+    config.min_nodes = 0;
+
+    printf("  Threads   Delta   Time(s)   Speedup   Matches Dijkstra\n");
+    for (int threads = 1;; threads *= 2) {
+        if (threads > cores) threads = cores;
+        config.threads = threads;
+
+        start = bench_now_seconds();
+        int delta = delta_stepping(&graph, 0, &config, dist, prev);
+        double elapsed = bench_now_seconds() - start;
+
+        bool same = memcmp(dist, ref_dist, nodes * sizeof(int)) == 0 &&
+                    memcmp(prev, ref_prev, nodes * sizeof(int)) == 0;
+        printf("  %7d %7d %9.3f %8.2fx   %s\n", threads, delta, elapsed,
+               sequential / elapsed, same ? "yes" : "NO");
+
+        if (threads == cores) break;
+    }
+
+    free(ref_dist);
+    free(ref_prev);
+    free(dist);
+    free(prev);
+    csr_free(&graph);
+    return EXIT_SUCCESS;
+}
+
+typedef struct rcu_bench {
+    topology_store* store;
+    csr_graph*      graph;     // initial topology, used to pick edges to change
+    int             batch_size;
+    atomic_bool     stop;
+} rcu_bench;
+
+typedef struct rcu_bench_reader {
+    rcu_bench*    bench;
+    unsigned int  seed;
+    long          queries;
+    long          routed;
+} rcu_bench_reader;
+
+typedef struct rcu_bench_writer {
+    rcu_bench* bench;
+    long       changes;
+    double     apply_seconds;
+} rcu_bench_writer;
+
+static unsigned int bench_random(unsigned int* state)
+{
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void* rcu_reader_main(void* arg)
+{
+    rcu_bench_reader* reader = (rcu_bench_reader*)arg;
+    rcu_bench* bench = reader->bench;
+    int slot = topology_register_reader(bench->store);
+    int n = bench->graph->node_count;
+
+    while (!atomic_load_explicit(&bench->stop, memory_order_relaxed)) {
+        int source = bench_random(&reader->seed) % n;
+        int destination = bench_random(&reader->seed) % n;
+
+        const topology_version* version = topology_read_lock(bench->store, slot);
+        int* path = NULL;
+        int length = topology_version_route(version, source, destination, &path);
+        topology_read_unlock(bench->store, slot);
+
+        if (length > 0) {
+            reader->routed++;
+            free(path);
+        }
+        reader->queries++;
+    }
+    return NULL;
+}
+
+static void* rcu_writer_main(void* arg)
+{
+    rcu_bench_writer* writer = (rcu_bench_writer*)arg;
+    rcu_bench* bench = writer->bench;
+    csr_graph* graph = bench->graph;
+    unsigned int seed = 12345;
+
+    topology_change* batch = (topology_change*)malloc(bench->batch_size * sizeof(topology_change));
+    if (batch == NULL) {
+        fprintf(stderr, "Memory allocation failed for benchmark\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Node u -> u+1 edges keep the graph connected, so only reweight the rest
+    while (!atomic_load_explicit(&bench->stop, memory_order_relaxed)) {
+        for (int i = 0; i < bench->batch_size; i++) {
+            int u = bench_random(&seed) % graph->node_count;
+            int degree = graph->offsets[u + 1] - graph->offsets[u];
+            int e = graph->offsets[u] + (degree > 1 ? 1 + bench_random(&seed) % (degree - 1) : 0);
+            batch[i].from = u;
+            batch[i].to = graph->targets[e];
+            batch[i].weight = (bench_random(&seed) % 4 == 0) ? 0 : 1 + bench_random(&seed) % graph->max_weight;
+        }
+
+        double start = bench_now_seconds();
+        topology_store_apply(bench->store, batch, bench->batch_size);
+        writer->apply_seconds += bench_now_seconds() - start;
+        writer->changes += bench->batch_size;
+    }
+
+    free(batch);
+    return NULL;
+}
+
+int run_rcu_benchmark(int argc, char* argv[])
+{
+    int nodes = (argc > 2) ? atoi(argv[2]) : 100000;
+    int reader_count = (argc > 3) ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    double seconds = (argc > 4) ? atof(argv[4]) : 3.0;
+    int batch_size = (argc > 5) ? atoi(argv[5]) : 1;
+
+    if (nodes < 2 || reader_count < 1 || reader_count >= RCU_MAX_READERS || batch_size < 1) {
+        printf("Usage: --bench-rcu [nodes>=2] [readers 1-%d] [seconds] [batch>=1]\n", RCU_MAX_READERS - 1);
+        return EXIT_FAILURE;
+    }
+
+    csr_graph graph;
+    csr_generate_random(&graph, nodes, 4, 100, 42);
+
+    topology_store store;
+    topology_store_init_csr(&store, &graph);
+
+    rcu_bench bench;
+    bench.store = &store;
+    bench.graph = &graph;
+    bench.batch_size = batch_size;
+    atomic_init(&bench.stop, false);
+
+    rcu_bench_reader* readers = (rcu_bench_reader*)calloc(reader_count, sizeof(rcu_bench_reader));
+    pthread_t* threads = (pthread_t*)malloc((reader_count + 1) * sizeof(pthread_t));
+    if (readers == NULL || threads == NULL) {
+        fprintf(stderr, "Memory allocation failed for benchmark\n");
+        exit(EXIT_FAILURE);
+    }
+
+    rcu_bench_writer writer = { &bench, 0, 0.0 };
+
+    printf("Topology: %d nodes, %d edges; %d reader thread(s), 1 writer, batches of %d change(s)\n",
+           nodes, graph.edge_count, reader_count, batch_size);
+
+    double start = bench_now_seconds();
+    for (int i = 0; i < reader_count; i++) {
+        readers[i].bench = &bench;
+        readers[i].seed = 1000 + i;
+        pthread_create(&threads[i], NULL, rcu_reader_main, &readers[i]);
+    }
+    pthread_create(&threads[reader_count], NULL, rcu_writer_main, &writer);
+
+    struct timespec duration;
+    duration.tv_sec = (time_t)seconds;
+    duration.tv_nsec = (long)((seconds - (time_t)seconds) * 1e9);
+    nanosleep(&duration, NULL);
+    atomic_store(&bench.stop, true);
+
+    for (int i = 0; i <= reader_count; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = bench_now_seconds() - start;
+
+    long queries = 0, routed = 0;
+    for (int i = 0; i < reader_count; i++) {
+        queries += readers[i].queries;
+        routed += readers[i].routed;
+    }
+
+    printf("\n=== RCU Topology Benchmark (%.2f s) ===\n", elapsed);
+    printf("Route queries: %ld (%.0f/s, %ld routed)\n", queries, queries / elapsed, routed);
+    printf("Link changes applied: %ld (%.0f/s, %.1f us per batch)\n", writer.changes,
+           writer.changes / elapsed,
+           writer.changes ? 1e6 * writer.apply_seconds / (writer.changes / batch_size) : 0.0);
+    printf("Versions published: %lu, reclaimed: %lu, still retired: %lu\n",
+           store.published, store.reclaimed, store.published - 1 - store.reclaimed);
+    printf("Adjacency blocks copied per version: %.2f of %d\n",
+           store.published > 1 ? (double)store.blocks_copied / (store.published - 1) : 0.0,
+           (nodes + TOPOLOGY_BLOCK_NODES - 1) / TOPOLOGY_BLOCK_NODES);
+
+    free(readers);
+    free(threads);
+    topology_store_destroy(&store);
+    csr_free(&graph);
+    return EXIT_SUCCESS;
+}
+
+static double lpm_lookup_rate(const lpm_table* table, const uint32_t* addresses, uint32_t* next_hops,
+                              int count, int rounds, unsigned long* checksum)
+{
+    double start = bench_now_seconds();
+    for (int r = 0; r < rounds; r++) {
+        lpm_lookup_batch(table, addresses, next_hops, count);
+        *checksum += next_hops[r % count];
+    }
+    return (double)count * rounds / (bench_now_seconds() - start);
+}
+
+int run_lpm_benchmark(int argc, char* argv[])
+{
+    lpm_route* routes = NULL;
+    int route_count = -1;
+
+    if (argc > 2) {
+        route_count = lpm_load_routes(argv[2], &routes);
+        if (route_count >= 0) {
+            printf("Loaded %d routes from %s\n", route_count, argv[2]);
+        }
+    }
+    if (route_count < 0) {
+        int count = (argc > 2) ? atoi(argv[2]) : 900000;
+        if (count < 1) {
+            printf("Usage: --bench-lpm [route_file | route_count]\n");
+            return EXIT_FAILURE;
+        }
+        lpm_generate_routes(&routes, count, 64, 42);
+        route_count = count;
+        printf("Generated %d routes with an Internet-like prefix length mix\n", route_count);
+    }
+
+    lpm_table table;
+    lpm_init(&table);
+    double start = bench_now_seconds();
+    for (int i = 0; i < route_count; i++) {
+        lpm_add(&table, routes[i].prefix, routes[i].length, routes[i].next_hop);
+    }
+    double build = bench_now_seconds() - start;
+
+    printf("Build time: %.3f s, tbl8 groups: %d, table memory: %.1f MB\n", build, table.tbl8_groups,
+           (LPM_TBL24_ENTRIES + (double)table.tbl8_capacity * LPM_TBL8_ENTRIES) * sizeof(uint32_t) / 1e6);
+
+    const int count = 1 << 22;
+    uint32_t* addresses = (uint32_t*)malloc(count * sizeof(uint32_t));
+    uint32_t* next_hops = (uint32_t*)malloc(count * sizeof(uint32_t));
+    if (addresses == NULL || next_hops == NULL) {
+        fprintf(stderr, "Memory allocation failed for benchmark\n");
+        exit(EXIT_FAILURE);
+    }
+
+    unsigned long checksum = 0;
+    unsigned int seed = 7;
+
+    // Uniformly random destinations
+    for (int i = 0; i < count; i++) {
+        addresses[i] = bench_random(&seed);
+    }
+    double random_rate = lpm_lookup_rate(&table, addresses, next_hops, count, 8, &checksum);
+
+    // Destinations inside the loaded prefixes, as seen by a router carrying real traffic
+    for (int i = 0; i < count; i++) {
+        const lpm_route* route = &routes[bench_random(&seed) % route_count];
+        uint32_t host_bits = (route->length == 32) ? 0 : (bench_random(&seed) & (0xFFFFFFFFu >> route->length));
+        addresses[i] = route->prefix | host_bits;
+    }
+    double routed_rate = lpm_lookup_rate(&table, addresses, next_hops, count, 8, &checksum);
+
+    long matched = 0;
+    for (int i = 0; i < count; i++) {
+        if (next_hops[i] != LPM_NO_ROUTE) matched++;
+    }
+
+    printf("\n=== LPM Lookup Benchmark (single core) ===\n");
+    printf("Random addresses:        %8.1f M lookups/s\n", random_rate / 1e6);
+    printf("Addresses in the table:  %8.1f M lookups/s (%.1f%% matched)\n",
+           routed_rate / 1e6, 100.0 * matched / count);
+    printf("(checksum %lu)\n", checksum);
+
+    free(addresses);
+    free(next_hops);
+    free(routes);
+    lpm_free(&table);
+    return EXIT_SUCCESS;
+}
+
+// Route storage benchmark: network_sim --bench-routes [fragments] [nodes] [sources]
+int run_route_benchmark(int argc, char* argv[])
+{
+    long fragments = (argc > 2) ? atol(argv[2]) : 2000000;
+    int nodes = (argc > 3) ? atoi(argv[3]) : 20000;
+    int sources = (argc > 4) ? atoi(argv[4]) : 64;
+
+    if (fragments < 1 || nodes < 2 || nodes > ROUTE_MAX_NODES || sources < 1 || sources > nodes) {
+        printf("Usage: --bench-routes [fragments] [nodes 2..%d] [sources <= nodes]\n", ROUTE_MAX_NODES);
+        return EXIT_FAILURE;
+    }
+
+    csr_graph graph;
+    csr_generate_random(&graph, nodes, 4, 100, 42);
+    printf("Routing %ld fragments from %d sources over %d nodes\n", fragments, sources, nodes);
+
+    int* source_of = (int*)malloc(fragments * sizeof(int));
+    int* dest_of = (int*)malloc(fragments * sizeof(int));
+    if (source_of == NULL || dest_of == NULL) {
+        fprintf(stderr, "Memory allocation failed for benchmark\n");
+        exit(EXIT_FAILURE);
+    }
+    unsigned int seed = 7;
+    for (long i = 0; i < fragments; i++) {
+        source_of[i] = (int)(bench_random(&seed) % sources);
+        dest_of[i] = (int)(bench_random(&seed) % nodes);
+    }
+
+    // Per-fragment copies: each fragment owns a pointer, a length and its own path array
+    int** paths = (int**)malloc(fragments * sizeof(int*));
+    int* path_lengths = (int*)malloc(fragments * sizeof(int));
+    int** source_dist = (int**)calloc(sources, sizeof(int*));
+    int** source_prev = (int**)calloc(sources, sizeof(int*));
+    if (paths == NULL || path_lengths == NULL || source_dist == NULL || source_prev == NULL) {
+        fprintf(stderr, "Memory allocation failed for benchmark\n");
+        exit(EXIT_FAILURE);
+    }
+
+    double start = bench_now_seconds();
+    long copy_bytes = 0;
+    for (long i = 0; i < fragments; i++) {
+        int s = source_of[i];
+        if (source_prev[s] == NULL) {
+            source_dist[s] = (int*)malloc(nodes * sizeof(int));
+            source_prev[s] = (int*)malloc(nodes * sizeof(int));
+            dijkstra_csr(&graph, s, source_dist[s], source_prev[s]);
+        }
+        int length = 0;
+        for (int v = dest_of[i]; v != -1; v = source_prev[s][v]) length++;
+        paths[i] = (int*)malloc(length * sizeof(int));
+        for (int v = dest_of[i], j = length - 1; v != -1; v = source_prev[s][v], j--) {
+            paths[i][j] = v;
+        }
+        path_lengths[i] = length;
+        copy_bytes += sizeof(int*) + sizeof(int) + (long)length * sizeof(int);
+    }
+    double copy_seconds = bench_now_seconds() - start;
+
+    // Shared trees: each fragment holds a 4-byte handle into its source's tree
+    route_handle* handles = (route_handle*)malloc(fragments * sizeof(route_handle));
+    if (handles == NULL) {
+        fprintf(stderr, "Memory allocation failed for benchmark\n");
+        exit(EXIT_FAILURE);
+    }
+    route_cache cache;
+    route_cache_init_csr(&cache, &graph);
+    start = bench_now_seconds();
+    for (long i = 0; i < fragments; i++) {
+        handles[i] = route_cache_lookup(&cache, source_of[i], dest_of[i]);
+    }
+    double handle_seconds = bench_now_seconds() - start;
+    long handle_bytes = fragments * (long)sizeof(route_handle) + route_cache_memory(&cache);
+
+    // Both representations must describe the same routes
+    long mismatches = 0;
+    for (long i = 0; i < fragments; i += 997) {
+        int* path = NULL;
+        int length = route_expand_path(&cache, handles[i], &path);
+        if (length != path_lengths[i] || memcmp(path, paths[i], length * sizeof(int)) != 0) {
+            mismatches++;
+        }
+        free(path);
+    }
+
+    printf("\n=== Route Storage Benchmark ===\n");
+    printf("%-22s %12s %14s %10s\n", "Representation", "Bytes/frag", "Total MB", "Time (s)");
+    printf("%-22s %12.1f %14.1f %10.3f\n", "Per-fragment paths",
+           (double)copy_bytes / fragments, copy_bytes / 1e6, copy_seconds);
+    printf("%-22s %12.1f %14.1f %10.3f\n", "Shared trees+handles",
+           (double)handle_bytes / fragments, handle_bytes / 1e6, handle_seconds);
+    printf("Path copies exclude malloc overhead; trees: %d (%.1f KB each)\n",
+           cache.tree_count, nodes * sizeof(uint16_t) / 1e3);
+    printf("Sampled routes that differ: %ld\n", mismatches);
+
+    for (long i = 0; i < fragments; i++) {
+        free(paths[i]);
+    }
+    for (int s = 0; s < sources; s++) {
+        free(source_dist[s]);
+        free(source_prev[s]);
+    }
+    free(paths);
+    free(path_lengths);
+    free(source_dist);
+    free(source_prev);
+    free(handles);
+    free(source_of);
+    free(dest_of);
+    route_cache_free(&cache);
+    csr_free(&graph);
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Totals of one link-state benchmark pass
+typedef struct link_state_summary {
+    long long convergence_total;
+    long long convergence_max;
+    long long flooding_total;
+    long      messages;
+    long      work;
+    int       full;
+    int       incremental;
+    double    cpu_mean_total;
+    double    cpu_max;
+    double    elapsed;
+    bool      correct;
+} link_state_summary;
+
+// Apply the same random link changes one after another, each followed by convergence
+static void link_state_pass(csr_graph* graph, const link_state_config* config, int changes,
+                            long long interval_us, bool print_changes, link_state_summary* summary)
+{
+    link_state_sim sim;
+    link_state_init(&sim, graph, config);
+    memset(summary, 0, sizeof(*summary));
+    unsigned int seed = 99;
+
+    double start = bench_now_seconds();
+    for (int c = 0; c < changes; c++) {
+        // Change, remove or restore the first link of a random router
+        int from = (int)(bench_random(&seed) % graph->node_count);
+        int to = graph->targets[graph->offsets[from]];
+        int weight = (bench_random(&seed) % 5 == 0) ? 0 : 1 + (int)(bench_random(&seed) % graph->max_weight);
+        link_state_change_link(&sim, interval_us, from, to, weight);
+
+        ls_report report;
+        link_state_run(&sim, &report);
+        if (print_changes && c < 10) {
+            printf("  %5d -> %-5d weight %-4d converged in %9.3f ms, %6ld LSAs, SPF %d full / %d incremental\n",
+                   from, to, weight, report.convergence_us / 1000.0, report.lsa_messages,
+                   report.spf_full, report.spf_incremental);
+        }
+
+        summary->convergence_total += report.convergence_us;
+        if (report.convergence_us > summary->convergence_max) summary->convergence_max = report.convergence_us;
+        summary->flooding_total += report.flooding_us;
+        summary->messages += report.lsa_messages;
+        summary->work += report.total_work;
+        summary->full += report.spf_full;
+        summary->incremental += report.spf_incremental;
+        summary->cpu_mean_total += report.mean_router_cpu_us;
+        if (report.max_router_cpu_us > summary->cpu_max) summary->cpu_max = report.max_router_cpu_us;
+    }
+    summary->elapsed = bench_now_seconds() - start;
+    summary->correct = link_state_verify(&sim);
+    link_state_free(&sim);
+}
+
+// Link-state benchmark: network_sim --bench-link-state [nodes] [degree] [changes] [interval_ms]
+int run_link_state_benchmark(int argc, char* argv[])
+{
+    int nodes = (argc > 2) ? atoi(argv[2]) : 1000;
+    int degree = (argc > 3) ? atoi(argv[3]) : 4;
+    int changes = (argc > 4) ? atoi(argv[4]) : 20;
+    double interval_ms = (argc > 5) ? atof(argv[5]) : 20000.0;
+
+    if (nodes < 2 || degree < 1 || changes < 1 || interval_ms < 0) {
+        printf("Usage: --bench-link-state [nodes >= 2] [degree >= 1] [changes >= 1] [interval_ms >= 0]\n");
+        return EXIT_FAILURE;
+    }
+
+    csr_graph graph;
+    csr_generate_random(&graph, nodes, degree, 100, 42);
+
+    link_state_config config;
+    init_link_state_config(&config);
+    long long interval_us = (long long)(interval_ms * 1000);
+    printf("%d routers, %d links, %d link changes %.1f ms apart\n", nodes, graph.edge_count, changes, interval_ms);
+    printf("SPF throttle: initial %.0f ms, hold %.0f ms, max wait %.0f ms; hop delay %.1f ms\n\n",
+           config.spf_initial_us / 1000.0, config.spf_hold_us / 1000.0, config.spf_max_wait_us / 1000.0,
+           config.link_delay_us / 1000.0);
+
+    link_state_summary summaries[2];
+    printf("First changes (incremental SPF):\n");
+    config.incremental = true;
+    link_state_pass(&graph, &config, changes, interval_us, true, &summaries[0]);
+    config.incremental = false;
+    link_state_pass(&graph, &config, changes, interval_us, false, &summaries[1]);
+
+    printf("\n%-12s %9s %9s %9s %9s %6s %6s %10s %9s %9s %7s %s\n", "SPF", "Flood ms", "Conv ms",
+           "Max conv", "LSAs", "Full", "Incr", "Work", "CPU us", "Max CPU", "Wall s", "Routes");
+    for (int i = 0; i < 2; i++) {
+        const link_state_summary* summary = &summaries[i];
+        printf("%-12s %9.3f %9.3f %9.3f %9ld %6d %6d %10ld %9.1f %9.1f %7.2f %s\n",
+               i == 0 ? "incremental" : "full",
+               summary->flooding_total / 1000.0 / changes, summary->convergence_total / 1000.0 / changes,
+               summary->convergence_max / 1000.0, summary->messages / changes, summary->full,
+               summary->incremental, summary->work / changes, summary->cpu_mean_total / changes,
+               summary->cpu_max, summary->elapsed, summary->correct ? "ok" : "WRONG");
+    }
+    printf("(Flood, Conv, LSAs, Work and CPU us are means per change; CPU us is per router,\n"
+           " Max CPU the busiest router in any change)\n");
+
+    csr_free(&graph);
+    return (summaries[0].correct && summaries[1].correct) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Snapshot benchmark: network_sim --bench-snapshot [nodes] [degree] [sources] [path]
+int run_snapshot_benchmark(int argc, char* argv[])
+{
+    int nodes = (argc > 2) ? atoi(argv[2]) : 100000;
+    int degree = (argc > 3) ? atoi(argv[3]) : 8;
+    int source_count = (argc > 4) ? atoi(argv[4]) : 64;
+    const char* path = (argc > 5) ? argv[5] : "/tmp/network_sim_routes.snap";
+
+    if (nodes < 2 || degree < 1 || source_count < 1 || source_count > nodes) {
+        printf("Usage: --bench-snapshot [nodes >= 2] [degree >= 1] [sources <= nodes] [path]\n");
+        return EXIT_FAILURE;
+    }
+
+    double start = bench_now_seconds();
+    csr_graph graph;
+    csr_generate_random(&graph, nodes, degree, 100, 42);
+    double generate_seconds = bench_now_seconds() - start;
+
+    int* sources = (int*)malloc(source_count * sizeof(int));
+    int* dist = (int*)malloc(nodes * sizeof(int));
+    int* prev = (int*)malloc(nodes * sizeof(int));
+    if (sources == NULL || dist == NULL || prev == NULL) {
+        fprintf(stderr, "Memory allocation failed for benchmark\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < source_count; i++) {
+        sources[i] = (int)((long long)i * nodes / source_count);
+    }
+    printf("%d nodes, %d edges, trees for %d sources, snapshot %s\n", nodes, graph.edge_count, source_count, path);
+
+    // Cold start: no usable snapshot, every tree is computed and written
+    remove(path);
+    route_snapshot snapshot;
+    bool rebuilt;
+    start = bench_now_seconds();
+    int status = route_snapshot_load_or_build(&snapshot, path, &graph, sources, source_count, &rebuilt);
+    double cold_seconds = bench_now_seconds() - start;
+    if (status != ROUTE_SNAPSHOT_OK) {
+        printf("Snapshot failed: %s\n", route_snapshot_error(status));
+        return EXIT_FAILURE;
+    }
+    size_t file_size = snapshot.map_size;
+    route_snapshot_close(&snapshot);
+
+    // Warm start: hash the topology, map the file, check the header
+    start = bench_now_seconds();
+    status = route_snapshot_load_or_build(&snapshot, path, &graph, sources, source_count, &rebuilt);
+    double warm_seconds = bench_now_seconds() - start;
+    bool warm_ok = (status == ROUTE_SNAPSHOT_OK && !rebuilt);
+
+    // Lookups straight from the mapping, checked against freshly computed trees
+    unsigned int seed = 11;
+    long lookups = 1000000;
+    long reachable = 0;
+    start = bench_now_seconds();
+    for (long i = 0; i < lookups; i++) {
+        int router = sources[bench_random(&seed) % source_count];
+        reachable += (route_snapshot_next_hop(&snapshot, router, (int)(bench_random(&seed) % nodes)) >= 0);
+    }
+    double lookup_seconds = bench_now_seconds() - start;
+
+    long mismatches = 0;
+    for (int i = 0; i < source_count && i < 4; i++) {
+        dijkstra_csr(&graph, sources[i], dist, prev);
+        const uint32_t* row = snapshot.prev + (size_t)snapshot.tree_index[sources[i]] * nodes;
+        for (int v = 0; v < nodes; v++) {
+            if (row[v] != (uint32_t)prev[v]) mismatches++;
+        }
+    }
+    route_snapshot_close(&snapshot);
+
+    // Full verification reads every page
+    start = bench_now_seconds();
+    int verified = route_snapshot_open(&snapshot, path, route_snapshot_topology_hash(&graph), true);
+    double verify_seconds = bench_now_seconds() - start;
+    route_snapshot_close(&snapshot);
+
+    // One changed weight must invalidate the snapshot
+    graph.weights[0]++;
+    int stale = route_snapshot_open(&snapshot, path, route_snapshot_topology_hash(&graph), false);
+    graph.weights[0]--;
+    if (stale == ROUTE_SNAPSHOT_OK) route_snapshot_close(&snapshot);
+
+    printf("\n=== Route Snapshot Benchmark ===\n");
+    printf("%-34s %12.3f ms\n", "Generate topology", generate_seconds * 1e3);
+    printf("%-34s %12.3f ms\n", "Cold start (compute + write)", cold_seconds * 1e3);
+    printf("%-34s %12.3f ms  %s\n", "Warm start (hash + mmap)", warm_seconds * 1e3, warm_ok ? "reused" : "REBUILT");
+    printf("%-34s %12.3f ms  %s\n", "Open with full verification", verify_seconds * 1e3,
+           route_snapshot_error(verified));
+    printf("%-34s %12.1f ns  (%.1f%% reachable)\n", "Next-hop lookup", lookup_seconds * 1e9 / lookups,
+           100.0 * reachable / lookups);
+    printf("Snapshot size: %.1f MB, speedup %.0fx\n", file_size / 1e6, cold_seconds / warm_seconds);
+    printf("Trees match Dijkstra: %s, changed topology detected: %s\n",
+           mismatches == 0 ? "yes" : "NO", stale == ROUTE_SNAPSHOT_ERR_STALE ? "yes" : "NO");
+
+    free(sources);
+    free(dist);
+    free(prev);
+    csr_free(&graph);
+    bool ok = warm_ok && verified == ROUTE_SNAPSHOT_OK && mismatches == 0 && stale == ROUTE_SNAPSHOT_ERR_STALE;
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Header benchmark: network_sim --bench-headers [datagrams] [mtu] [rounds]
+int run_header_benchmark(int argc, char* argv[])
+{
+    int datagrams = (argc > 2) ? atoi(argv[2]) : 200000;
+    int mtu = (argc > 3) ? atoi(argv[3]) : 1500;
+    int rounds = (argc > 4) ? atoi(argv[4]) : 20;
+
+    if (datagrams < 1 || mtu < IPV4_HEADER_SIZE + 8 || rounds < 1 || rounds > 60) {
+        printf("Usage: --bench-headers [datagrams >= 1] [mtu >= %d] [rounds 1..60]\n", IPV4_HEADER_SIZE + 8);
+        return EXIT_FAILURE;
+    }
+
+    // Payloads of 1000..20000 bytes, so most datagrams are fragmented
+    unsigned int seed = 3;
+    ipv4_packet* packets = (ipv4_packet*)malloc(datagrams * sizeof(ipv4_packet));
+    if (packets == NULL) {
+        fprintf(stderr, "Memory allocation failed for benchmark\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int d = 0; d < datagrams; d++) {
+        create_ipv4_packet_virtual(&packets[d], d, d + 1, 1000 + (int)(bench_random(&seed) % 19001),
+                                   PAYLOAD_PATTERN_SEQUENTIAL, 0);
+    }
+
+    // Array of structs: what fragment_ipv4_packet() returns, gathered into one array
+    long capacity = 1024;
+    long aos_count = 0;
+    ipv4_fragment* aos = (ipv4_fragment*)malloc(capacity * sizeof(ipv4_fragment));
+    double start = bench_now_seconds();
+    for (int d = 0; d < datagrams; d++) {
+        ipv4_fragment* fragments;
+        int count = fragment_ipv4_packet(&packets[d], mtu, &fragments);
+        if (aos_count + count > capacity) {
+            while (aos_count + count > capacity) capacity *= 2;
+            aos = (ipv4_fragment*)realloc(aos, capacity * sizeof(ipv4_fragment));
+        }
+        if (aos == NULL) {
+            fprintf(stderr, "Memory allocation failed for benchmark\n");
+            exit(EXIT_FAILURE);
+        }
+        memcpy(aos + aos_count, fragments, count * sizeof(ipv4_fragment));
+        aos_count += count;
+        free(fragments);
+    }
+    double aos_emit = bench_now_seconds() - start;
+
+    // Structure of arrays: emitted straight into the batch
+    fragment_batch batch;
+    fragment_batch_init(&batch, 1024);
+    start = bench_now_seconds();
+    for (int d = 0; d < datagrams; d++) {
+        fragment_ipv4_packet_batch(&packets[d], mtu, &batch);
+    }
+    double soa_emit = bench_now_seconds() - start;
+    printf("%d datagrams of 1000-20000 bytes at MTU %d: %ld fragments, %d rounds per kernel\n",
+           datagrams, mtu, aos_count, rounds);
+
+    start = bench_now_seconds();
+    for (int r = 0; r < rounds; r++) {
+        for (long i = 0; i < aos_count; i++) {
+            aos[i].header.checksum = 0;
+            aos[i].header.checksum = calculate_checksum(&aos[i].header);
+        }
+    }
+    double aos_checksum = (bench_now_seconds() - start) / rounds;
+
+    start = bench_now_seconds();
+    for (int r = 0; r < rounds; r++) {
+        fragment_batch_checksum(&batch, 0, batch.count);
+    }
+    double soa_checksum = (bench_now_seconds() - start) / rounds;
+
+    start = bench_now_seconds();
+    for (int r = 0; r < rounds; r++) {
+        for (long i = 0; i < aos_count; i++) {
+            if (aos[i].header.ttl > 0) {
+                aos[i].header.ttl--;
+                aos[i].header.checksum = checksum_after_ttl_decrement(aos[i].header.checksum);
+            }
+        }
+    }
+    double aos_ttl = (bench_now_seconds() - start) / rounds;
+
+    start = bench_now_seconds();
+    for (int r = 0; r < rounds; r++) {
+        fragment_batch_decrement_ttl(&batch);
+    }
+    double soa_ttl = (bench_now_seconds() - start) / rounds;
+
+    // Both layouts must hold the same headers, with valid checksums
+    long mismatches = (batch.count != aos_count);
+    for (long i = 0; i < aos_count && mismatches == 0; i++) {
+        ipv4_header header;
+        fragment_batch_header(&batch, (int)i, &header);
+        if (memcmp(&header, &aos[i].header, sizeof(header)) != 0 || calculate_checksum(&header) != header.checksum) {
+            mismatches++;
+        }
+    }
+
+    double per = 1e9 / aos_count;
+    printf("\n=== Fragment Header Benchmark (ns per fragment) ===\n");
+    printf("%-28s %12s %12s %9s\n", "Operation", "Array", "Batch", "Speedup");
+    printf("%-28s %12.2f %12.2f %8.1fx\n", "Fragment (emit headers)", aos_emit * per, soa_emit * per,
+           aos_emit / soa_emit);
+    printf("%-28s %12.2f %12.2f %8.1fx\n", "Checksum", aos_checksum * per, soa_checksum * per,
+           aos_checksum / soa_checksum);
+    printf("%-28s %12.2f %12.2f %8.1fx\n", "TTL decrement + checksum", aos_ttl * per, soa_ttl * per,
+           aos_ttl / soa_ttl);
+    printf("Bytes per fragment: array %zu, batch %zu; headers identical: %s\n", sizeof(ipv4_fragment),
+           4 * sizeof(uint16_t) + 3 * sizeof(uint8_t) + 3 * sizeof(uint32_t), mismatches == 0 ? "yes" : "NO");
+
+    free(packets);
+    free(aos);
+    fragment_batch_free(&batch);
+    return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Reads a pipe until the writer closes it
+static void* drain_pipe(void* arg)
+{
+    int fd = *(int*)arg;
+    static char buffer[1 << 20];
+    while (true) {
+        ssize_t count = read(fd, buffer, sizeof(buffer));
+        if (count == 0 || (count < 0 && errno != EINTR)) break;
+    }
+    return NULL;
+}
+
+typedef struct wire_pass {
+    double    seconds;
+    long      syscalls;
+    long long bytes;
+    bool      failed;
+} wire_pass;
+
+// One pass over all datagrams: either one buffer and write() per fragment, or writev batches
+static void run_wire_pass(const char* target, ipv4_packet* packets, ipv4_fragment** fragments,
+                          const int* counts, int datagrams, bool gather, wire_pass* pass)
+{
+    int fd;
+    int pipe_fds[2];
+    pthread_t reader;
+    bool use_pipe = (strcmp(target, "pipe") == 0);
+    if (use_pipe) {
+        if (pipe(pipe_fds) != 0 || pthread_create(&reader, NULL, drain_pipe, &pipe_fds[0]) != 0) {
+            pass->failed = true;
+            return;
+        }
+        fd = pipe_fds[1];
+    } else {
+        fd = open(target, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            pass->failed = true;
+            return;
+        }
+    }
+
+    memset(pass, 0, sizeof(*pass));
+    double start = bench_now_seconds();
+    if (gather) {
+        wire_writer writer;
+        wire_writer_init(&writer, fd, WIRE_MAX_IOV / 2);
+        for (int d = 0; d < datagrams; d++) {
+            wire_emit(&writer, &packets[d], fragments[d], counts[d]);
+        }
+        pass->failed = (wire_writer_free(&writer) != 0);
+        pass->syscalls = writer.stats.syscalls;
+        pass->bytes = writer.stats.bytes;
+    } else {
+        for (int d = 0; d < datagrams && !pass->failed; d++) {
+            for (int i = 0; i < counts[d]; i++) {
+                const ipv4_fragment* fragment = &fragments[d][i];
+                size_t length = fragment->header.total_len;
+                uint8_t* buffer = (uint8_t*)malloc(length);
+                if (buffer == NULL) {
+                    fprintf(stderr, "Memory allocation failed for benchmark\n");
+                    exit(EXIT_FAILURE);
+                }
+                ipv4_serialize_header(&fragment->header, buffer);
+                memcpy(buffer + IPV4_HEADER_SIZE, fragment->data, fragment->data_size);
+                for (size_t done = 0; done < length; ) {
+                    ssize_t written = write(fd, buffer + done, length - done);
+                    pass->syscalls++;
+                    if (written < 0 && errno != EINTR) {
+                        pass->failed = true;
+                        break;
+                    }
+                    if (written > 0) done += (size_t)written;
+                }
+                pass->bytes += (long long)length;
+                free(buffer);
+            }
+        }
+    }
+    close(fd);
+    if (use_pipe) {
+        pthread_join(reader, NULL);
+        close(pipe_fds[0]);
+    }
+    pass->seconds = bench_now_seconds() - start;
+}
+
+// Wire emission benchmark: network_sim --bench-wire [datagrams] [mtu] [pipe | output_file]
+int run_wire_benchmark(int argc, char* argv[])
+{
+    int datagrams = (argc > 2) ? atoi(argv[2]) : 50000;
+    int mtu = (argc > 3) ? atoi(argv[3]) : 1500;
+    const char* target = (argc > 4) ? argv[4] : "/dev/null";
+
+    if (datagrams < 1 || mtu < IPV4_HEADER_SIZE + 8 || mtu > MAX_IPV4_PACKET_SIZE) {
+        printf("Usage: --bench-wire [datagrams >= 1] [mtu %d..%d] [pipe | output_file]\n",
+               IPV4_HEADER_SIZE + 8, MAX_IPV4_PACKET_SIZE);
+        return EXIT_FAILURE;
+    }
+
+    // Real payloads of 40..9000 bytes, fragmented once up front
+    unsigned int seed = 5;
+    ipv4_packet* packets = (ipv4_packet*)malloc(datagrams * sizeof(ipv4_packet));
+    ipv4_fragment** fragments = (ipv4_fragment**)malloc(datagrams * sizeof(ipv4_fragment*));
+    int* counts = (int*)malloc(datagrams * sizeof(int));
+    if (packets == NULL || fragments == NULL || counts == NULL) {
+        fprintf(stderr, "Memory allocation failed for benchmark\n");
+        exit(EXIT_FAILURE);
+    }
+    long fragment_total = 0;
+    for (int d = 0; d < datagrams; d++) {
+        create_ipv4_packet(&packets[d], d, d + 1, 40 + (int)(bench_random(&seed) % 8961));
+        counts[d] = fragment_ipv4_packet(&packets[d], mtu, &fragments[d]);
+        fragment_total += counts[d];
+    }
+    printf("%d datagrams of 40-9000 bytes at MTU %d: %ld fragments, written to %s\n",
+           datagrams, mtu, fragment_total, target);
+
+    wire_pass passes[2];
+    run_wire_pass(target, packets, fragments, counts, datagrams, false, &passes[0]);
+    run_wire_pass(target, packets, fragments, counts, datagrams, true, &passes[1]);
+
+    printf("\n=== Wire Emission Benchmark ===\n");
+    printf("%-26s %12s %10s %14s %12s\n", "Method", "MB/s", "Time (s)", "Syscalls", "Calls/dgram");
+    for (int i = 0; i < 2; i++) {
+        printf("%-26s %12.1f %10.3f %14ld %12.3f%s\n", i == 0 ? "Buffer + write per frag" : "iovec batches + writev",
+               passes[i].bytes / passes[i].seconds / 1e6, passes[i].seconds, passes[i].syscalls,
+               (double)passes[i].syscalls / datagrams, passes[i].failed ? "  (write failed)" : "");
+    }
+    bool same = (passes[0].bytes == passes[1].bytes);
+    printf("Bytes written: %lld (%s)\n", passes[1].bytes, same ? "identical" : "DIFFERENT");
+
+    for (int d = 0; d < datagrams; d++) {
+        for (int i = 0; i < counts[d]; i++) {
+            free(fragments[d][i].data);
+        }
+        free(fragments[d]);
+        free(packets[d].payload);
+    }
+    free(packets);
+    free(fragments);
+    free(counts);
+    return (same && !passes[0].failed && !passes[1].failed) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Time dijkstra_dense() with canonical predecessors over `sources`, checking each
+// tree against the heap-based reference; returns seconds per tree, -1 if unsupported
+static double dense_pass(const dense_graph* dense, dense_kernel kernel, int sources,
+                         const int* ref_dist, const int* ref_prev, int* dist, int* prev, bool* same)
+{
+    if (!dense_kernel_supported(kernel)) return -1;
+    int n = dense->node_count;
+    double start = bench_now_seconds();
+    for (int s = 0; s < sources; s++) {
+        dijkstra_dense(dense, s, -1, dist, prev, kernel, true);
+        if (memcmp(dist, ref_dist + (size_t)s * n, n * sizeof(int)) != 0 ||
+            memcmp(prev, ref_prev + (size_t)s * n, n * sizeof(int)) != 0) {
+            *same = false;
+        }
+    }
+    return (bench_now_seconds() - start) / sources;
+}
+
+// Heap versus matrix Dijkstra crossover: network_sim --bench-dense [max_nodes]
+int run_dense_benchmark(int argc, char* argv[])
+{
+    int max_nodes = (argc > 2) ? atoi(argv[2]) : 2048;
+    if (max_nodes < 64 || max_nodes > DENSE_MAX_NODES) {
+        printf("Usage: --bench-dense [max_nodes 64..%d]\n", DENSE_MAX_NODES);
+        return EXIT_FAILURE;
+    }
+
+    static const int densities[] = { 1, 5, 10, 25, 50 };   // percent of all node pairs
+    const int density_count = (int)(sizeof(densities) / sizeof(densities[0]));
+    const dense_kernel kernels[] = { DENSE_KERNEL_SCALAR, DENSE_KERNEL_SSE41, DENSE_KERNEL_AVX2 };
+
+    printf("Best kernel on this CPU: %s\n\n", dense_kernel_name(dense_best_kernel()));
+    printf("  Nodes  Density     Edges   Heap(us)  Scalar(us)  SSE4.1(us)   AVX2(us)   Speedup   Picks   Match\n");
+
+    for (int n = 64; n <= max_nodes; n *= 2) {
+        int sources = (n <= 256) ? n : 256;
+        int* ref_dist = (int*)malloc((size_t)sources * n * sizeof(int));
+        int* ref_prev = (int*)malloc((size_t)sources * n * sizeof(int));
+        int* dist = (int*)malloc(n * sizeof(int));
+        int* prev = (int*)malloc(n * sizeof(int));
+        if (ref_dist == NULL || ref_prev == NULL || dist == NULL || prev == NULL) {
+            fprintf(stderr, "Memory allocation failed for benchmark\n");
+            exit(EXIT_FAILURE);
+        }
+
+        for (int d = 0; d < density_count; d++) {
+            int degree = n * densities[d] / 100;
+            if (degree < 1) degree = 1;
+
+            csr_graph graph;
+            csr_generate_random(&graph, n, degree, 100, 42 + n + d);
+            dense_graph dense;
+            dense_from_csr(&dense, &graph);
+
+            double start = bench_now_seconds();
+            for (int s = 0; s < sources; s++) {
+                dijkstra_csr(&graph, s, ref_dist + (size_t)s * n, ref_prev + (size_t)s * n);
+            }
+            double heap = (bench_now_seconds() - start) / sources;
+
+            bool same = true;
+            double times[3];
+            double best = heap;
+            for (int k = 0; k < 3; k++) {
+                times[k] = dense_pass(&dense, kernels[k], sources, ref_dist, ref_prev, dist, prev, &same);
+                if (times[k] > 0 && times[k] < best) best = times[k];
+            }
+
+            printf("  %5d  %6d%%  %8d  %9.1f", n, densities[d], graph.edge_count, heap * 1e6);
+            for (int k = 0; k < 3; k++) {
+                if (times[k] < 0) printf("  %10s", "-");
+                else printf("  %10.1f", times[k] * 1e6);
+            }
+            printf("  %7.2fx   %5s   %s\n", heap / best,
+                   dense_preferred(n, graph.edge_count) ? "dense" : "heap", same ? "yes" : "NO");
+
+            dense_free(&dense);
+            csr_free(&graph);
+        }
+
+        free(ref_dist);
+        free(ref_prev);
+        free(dist);
+        free(prev);
+    }
+    return EXIT_SUCCESS;
+}
+
+// Multicast link usage: network_sim --bench-multicast [nodes] [degree] [payload] [mtu]
+int run_multicast_benchmark(int argc, char* argv[])
+{
+    int nodes = (argc > 2) ? atoi(argv[2]) : 100000;
+    int degree = (argc > 3) ? atoi(argv[3]) : 4;
+    int payload = (argc > 4) ? atoi(argv[4]) : 8000;
+    int mtu = (argc > 5) ? atoi(argv[5]) : 1500;
+
+    if (nodes < 2 || degree < 1 || payload < 1 || payload > MAX_PAYLOAD_SIZE || mtu < IPV4_HEADER_SIZE + 8) {
+        printf("Usage: --bench-multicast [nodes >= 2] [degree >= 1] [payload 1..%d] [mtu >= %d]\n",
+               MAX_PAYLOAD_SIZE, IPV4_HEADER_SIZE + 8);
+        return EXIT_FAILURE;
+    }
+
+    csr_graph graph;
+    csr_generate_random(&graph, nodes, degree, 100, 42);
+
+    ipv4_packet packet;
+    ipv4_fragment* fragments;
+    create_ipv4_packet_virtual(&packet, 0, 0, payload, PAYLOAD_PATTERN_SEQUENTIAL, 0);
+    int count = fragment_ipv4_packet(&packet, mtu, &fragments);
+    printf("Graph: %d nodes, %d edges; datagram: %d bytes in %d fragments (MTU %d)\n\n",
+           nodes, graph.edge_count, payload, count, mtu);
+
+    // Receivers drawn without repetition from every node but the source
+    int* order = (int*)malloc(nodes * sizeof(int));
+    if (order == NULL) {
+        fprintf(stderr, "Memory allocation failed for benchmark\n");
+        exit(EXIT_FAILURE);
+    }
+    unsigned int seed = 11;
+    for (int v = 0; v < nodes; v++) {
+        order[v] = v;
+    }
+    for (int v = nodes - 1; v > 1; v--) {
+        int j = 1 + (int)(bench_random(&seed) % (unsigned int)v);
+        int t = order[v];
+        order[v] = order[j];
+        order[j] = t;
+    }
+
+    printf("  Receivers   Build(ms)   Tree links   Unicast hops   Tree MB   Unicast MB   Saved   Unreachable\n");
+    for (int receivers = 10;; receivers *= 10) {
+        if (receivers > nodes - 1) receivers = nodes - 1;
+
+        multicast_tree tree;
+        double start = bench_now_seconds();
+        multicast_tree_build(&tree, &graph, 0, order + 1, receivers);
+        double elapsed = bench_now_seconds() - start;
+
+        multicast_report report;
+        multicast_forward(&tree, fragments, count, &report);
+        printf("  %9d %11.1f %12d %14lld %9.2f %12.2f %6.1f%%   %11d\n", receivers, elapsed * 1e3,
+               tree.link_count, tree.unicast_hops, report.link_bytes / 1e6,
+               report.unicast_link_bytes / 1e6, report.savings * 100, tree.unreachable);
+        multicast_tree_free(&tree);
+
+        if (receivers == nodes - 1) break;
+    }
+
+    free(order);
+    free(fragments);
+    csr_free(&graph);
+    return EXIT_SUCCESS;
+}
+
+// Random graph whose links work in both directions with the same weight
+static void bench_symmetric_graph(csr_graph* graph, int nodes, int degree, int max_weight, unsigned int seed)
+{
+    csr_graph directed;
+    csr_generate_random(&directed, nodes, degree, max_weight, seed);
+
+    int edges = 2 * directed.edge_count;
+    graph->node_count = nodes;
+    graph->edge_count = 0;
+    graph->max_weight = directed.max_weight;
+    graph->offsets = (int*)calloc(nodes + 1, sizeof(int));
+    graph->targets = (int*)malloc(edges * sizeof(int));
+    graph->weights = (int*)malloc(edges * sizeof(int));
+    if (graph->offsets == NULL || graph->targets == NULL || graph->weights == NULL) {
+        fprintf(stderr, "Memory allocation failed for benchmark\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int u = 0; u < nodes; u++) {
+        for (int k = directed.offsets[u]; k < directed.offsets[u + 1]; k++) {
+            if (directed.targets[k] == u) continue;
+            graph->offsets[u + 1]++;
+            graph->offsets[directed.targets[k] + 1]++;
+        }
+    }
+    for (int u = 0; u < nodes; u++) {
+        graph->offsets[u + 1] += graph->offsets[u];
+    }
+    int* fill = (int*)malloc(nodes * sizeof(int));
+    if (fill == NULL) {
+        fprintf(stderr, "Memory allocation failed for benchmark\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(fill, graph->offsets, nodes * sizeof(int));
+    for (int u = 0; u < nodes; u++) {
+        for (int k = directed.offsets[u]; k < directed.offsets[u + 1]; k++) {
+            int v = directed.targets[k];
+            if (v == u) continue;
+            graph->targets[fill[u]] = v;
+            graph->weights[fill[u]++] = directed.weights[k];
+            graph->targets[fill[v]] = u;
+            graph->weights[fill[v]++] = directed.weights[k];
+        }
+    }
+    graph->edge_count = graph->offsets[nodes];
+    free(fill);
+    csr_free(&directed);
+}
+
+// Fragments lost while reconverging, with and without backups:
+// network_sim --bench-frr [nodes] [degree] [failures]
+int run_frr_benchmark(int argc, char* argv[])
+{
+    int nodes = (argc > 2) ? atoi(argv[2]) : 300;
+    int degree = (argc > 3) ? atoi(argv[3]) : 2;
+    int failures = (argc > 4) ? atoi(argv[4]) : 20;
+
+    if (nodes < 3 || nodes > 4000 || degree < 1 || failures < 1) {
+        printf("Usage: --bench-frr [nodes 3..4000] [degree >= 1] [failures >= 1]\n");
+        return EXIT_FAILURE;
+    }
+
+    csr_graph graph;
+    bench_symmetric_graph(&graph, nodes, degree, 20, 42);
+    printf("Graph: %d nodes, %d bidirectional links\n\n", nodes, graph.edge_count / 2);
+
+    // Coverage of the routes: how many have a backup of each kind
+    const frr_protection modes[] = { FRR_LFA, FRR_REMOTE_LFA };
+    const char* mode_names[] = { "LFA", "Remote LFA" };
+    printf("  %-12s %10s %10s %10s %10s %10s %9s\n",
+           "Protection", "Routes", "LFA", "Node LFA", "Remote", "Covered", "Build(s)");
+    for (int m = 0; m < 2; m++) {
+        frr_table table;
+        frr_table_build(&table, &graph, modes[m]);
+        long covered = table.lfa + table.node_lfa + table.remote_lfa;
+        printf("  %-12s %10ld %10ld %10ld %10ld %9.1f%% %9.3f\n", mode_names[m], table.routes,
+               table.lfa, table.node_lfa, table.remote_lfa,
+               table.routes > 0 ? 100.0 * covered / table.routes : 0.0, table.build_seconds);
+        frr_table_free(&table);
+    }
+
+    // Fail random links (both directions) one at a time; every affected flow sends while routers reconverge
+    frr_sim_config config;
+    init_frr_sim_config(&config);
+    frr_outcome totals[3] = { { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } };
+    long long convergence = 0;
+    long affected = 0;
+    unsigned int seed = 23;
+    for (int f = 0; f < failures; f++) {
+        int u = (int)(bench_random(&seed) % (unsigned int)nodes);
+        int k = graph.offsets[u] + (int)(bench_random(&seed) % (unsigned int)(graph.offsets[u + 1] - graph.offsets[u]));
+        link_delta link[2] = { { u, graph.targets[k] }, { graph.targets[k], u } };
+
+        for (int m = 0; m < 2; m++) {
+            frr_sim_report report;
+            config.protection = modes[m];
+            frr_simulate_failure(&graph, link, 2, &config, &report);
+            if (m == 0) {
+                convergence += report.convergence_us;
+                affected += report.affected_pairs;
+                totals[0].sent += report.unprotected.sent;
+                totals[0].delivered += report.unprotected.delivered;
+                totals[0].dropped += report.unprotected.dropped;
+                totals[0].looped += report.unprotected.looped;
+            }
+            totals[m + 1].sent += report.fast_reroute.sent;
+            totals[m + 1].delivered += report.fast_reroute.delivered;
+            totals[m + 1].dropped += report.fast_reroute.dropped;
+            totals[m + 1].looped += report.fast_reroute.looped;
+            totals[m + 1].repaired += report.fast_reroute.repaired;
+        }
+    }
+
+    printf("\n%d link failures, %ld affected flows, mean reconvergence %.1f ms, one fragment every %lld us\n\n",
+           failures, affected, convergence / 1000.0 / failures, config.fragment_interval_us);
+    printf("  %-12s %10s %10s %10s %10s %10s %8s\n",
+           "Protection", "Sent", "Delivered", "Dropped", "Looped", "Repaired", "Lost");
+    const char* names[] = { "None", "LFA", "Remote LFA" };
+    for (int m = 0; m < 3; m++) {
+        long lost = totals[m].dropped + totals[m].looped;
+        printf("  %-12s %10ld %10ld %10ld %10ld %10ld %7.2f%%\n", names[m], totals[m].sent,
+               totals[m].delivered, totals[m].dropped, totals[m].looped, totals[m].repaired,
+               totals[m].sent > 0 ? 100.0 * lost / totals[m].sent : 0.0);
+    }
+
+    csr_free(&graph);
+    return EXIT_SUCCESS;
+}
+
+// Generate `count` random changes that are each valid after the ones before them
+static void bench_random_changes(topology_edit* edits, const network_topology* network, int count, unsigned int* seed)
+{
+    network_topology staged = *network;
+    int n = staged.node_count;
+    for (int i = 0; i < count; i++) {
+        int from = (int)(bench_random(seed) % (unsigned int)n);
+        int to = (from + 1 + (int)(bench_random(seed) % (unsigned int)(n - 1))) % n;
+        int weight = 1 + (int)(bench_random(seed) % 20);
+        topology_op op;
+        if (staged.graph[from][to] == 0) {
+            op = TOPOLOGY_ADD_LINK;
+        } else if (bench_random(seed) % 4 == 0) {
+            op = TOPOLOGY_REMOVE_LINK;
+            weight = 0;
+        } else {
+            op = TOPOLOGY_SET_WEIGHT;
+        }
+        staged.graph[from][to] = weight;
+        edits[i] = (topology_edit){ op, from, to, weight };
+    }
+}
+
+// Stage one generated change through the public transaction calls
+static void bench_stage_change(topology_txn* txn, const topology_edit* edit)
+{
+    switch (edit->op) {
+        case TOPOLOGY_ADD_LINK:    topology_txn_add_link(txn, edit->from, edit->to, edit->weight); break;
+        case TOPOLOGY_REMOVE_LINK: topology_txn_remove_link(txn, edit->from, edit->to); break;
+        case TOPOLOGY_SET_WEIGHT:  topology_txn_set_weight(txn, edit->from, edit->to, edit->weight); break;
+    }
+}
+
+// Route every source of a cache so that all trees are current; the handles are
+// dropped again so superseded trees can be freed
+static void bench_warm_routes(route_cache* routes)
+{
+    for (int source = 0; source < routes->node_count; source++) {
+        route_cache_release(routes, route_cache_lookup(routes, source, 0));
+    }
+}
+
+// Batched topology transactions against one commit per change:
+// network_sim --bench-txn [rounds]
+int run_txn_benchmark(int argc, char* argv[])
+{
+    int rounds = (argc > 2) ? atoi(argv[2]) : 200;
+    if (rounds < 1) {
+        printf("Usage: --bench-txn [rounds >= 1]\n");
+        return EXIT_FAILURE;
+    }
+
+    const int batch_sizes[] = { 1, 4, 16, 64, 256 };
+    printf("Random %d-node topologies, all %d route trees current before each batch, %d rounds\n\n",
+           MAX_NODES, MAX_NODES, rounds);
+    printf("  %6s | %11s %11s %8s | %11s %11s %8s | %7s\n", "Batch",
+           "Apply(us)", "Routes(us)", "Trees", "Apply(us)", "Routes(us)", "Trees", "Speedup");
+    printf("  %6s | %-32s | %-32s |\n", "", "one commit per change", "one transaction");
+
+    unsigned int seed = 7;
+    for (int b = 0; b < (int)(sizeof(batch_sizes) / sizeof(batch_sizes[0])); b++) {
+        int count = batch_sizes[b];
+        double single_apply = 0, single_routes = 0, batch_apply = 0, batch_routes = 0;
+        long single_trees = 0, batch_trees = 0;
+
+        for (int r = 0; r < rounds; r++) {
+            network_topology network;
+            init_network_topology(&network, MAX_NODES);
+            for (int u = 0; u < MAX_NODES; u++) {
+                add_connection(&network, u, (u + 1) % MAX_NODES, 1 + (int)(bench_random(&seed) % 20));
+                for (int k = 0; k < 2; k++) {
+                    int v = (int)(bench_random(&seed) % MAX_NODES);
+                    if (v != u) add_connection(&network, u, v, 1 + (int)(bench_random(&seed) % 20));
+                }
+            }
+            topology_edit edits[256];   // the largest batch size
+            bench_random_changes(edits, &network, count, &seed);
+
+            // Alternate which variant runs first so neither always meets cold caches
+            route_cache routes;
+            for (int pass = 0; pass < 2; pass++) {
+                if ((pass + r) % 2 == 0) {
+                    // Each change committed on its own, routes refreshed after every one
+                    network_topology single = network;
+                    route_cache_init(&routes, &single);
+                    bench_warm_routes(&routes);
+                    topology_txn txn;
+                    topology_txn_begin(&txn, &single);
+                    for (int i = 0; i < count; i++) {
+                        topology_txn_result result;
+                        bench_stage_change(&txn, &edits[i]);
+                        topology_txn_commit(&txn, &routes, &result);
+                        single_apply += result.apply_seconds;
+                        single_routes += result.recompute_seconds;
+                        single_trees += result.trees_recomputed;
+                    }
+                    topology_txn_free(&txn);
+                    route_cache_free(&routes);
+                } else {
+                    // The whole batch in one transaction
+                    network_topology batched = network;
+                    route_cache_init(&routes, &batched);
+                    bench_warm_routes(&routes);
+                    topology_txn txn;
+                    topology_txn_begin(&txn, &batched);
+                    for (int i = 0; i < count; i++) {
+                        bench_stage_change(&txn, &edits[i]);
+                    }
+                    topology_txn_result result;
+                    topology_txn_commit(&txn, &routes, &result);
+                    topology_txn_free(&txn);
+                    batch_apply += result.apply_seconds;
+                    batch_routes += result.recompute_seconds;
+                    batch_trees += result.trees_recomputed;
+                    route_cache_free(&routes);
+                }
+            }
+        }
+
+        double single_total = single_apply + single_routes;
+        double batch_total = batch_apply + batch_routes;
+        printf("  %6d | %11.2f %11.2f %8.1f | %11.2f %11.2f %8.1f | %6.1fx\n", count,
+               single_apply * 1e6 / rounds, single_routes * 1e6 / rounds, (double)single_trees / rounds,
+               batch_apply * 1e6 / rounds, batch_routes * 1e6 / rounds, (double)batch_trees / rounds,
+               batch_total > 0 ? single_total / batch_total : 0.0);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,354 @@
+/**
+ * delta_stepping.c
+ * Parallel delta-stepping single-source shortest paths (Meyer & Sanders)
+ *
+ * Nodes are kept in buckets of width delta by tentative distance. The lowest
+ * non-empty bucket is settled by repeatedly relaxing its light edges
+ * (weight <= delta) until it stops refilling, then the heavy edges of every
+ * node removed from it are relaxed once. Relaxations run on a fixed pool of
+ * threads, update dist[] with an atomic minimum and record improved nodes in
+ * thread-local buffers that the coordinating thread sorts into buckets.
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../include/delta_stepping.h"
+
+enum { PHASE_LIGHT, PHASE_HEAVY, PHASE_PREV, PHASE_EXIT };
+
+typedef struct node_buffer {
+    int* items;
+    int  size;
+    int  capacity;
+} node_buffer;
+
+typedef struct ds_shared {
+    csr_graph* graph;
+    int        delta;
+    int        thread_count;
+    int*       dist;
+    int*       prev;
+
+    // Current phase, written by the coordinator between barriers
+    int        phase;
+    long long  bucket;      // index of the bucket being settled
+    const int* work;        // frontier (light) or settled set (heavy)
+    int        work_size;
+
+    node_buffer*      improved;  // one request buffer per thread
+    pthread_barrier_t start;
+    pthread_barrier_t done;
+} ds_shared;
+
+typedef struct ds_worker {
+    ds_shared* shared;
+    int        id;
+} ds_worker;
+
+static void buffer_push(node_buffer* buffer, int value)
+{
+    if (buffer->size == buffer->capacity) {
+        buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 256;
+        buffer->items = (int*)realloc(buffer->items, buffer->capacity * sizeof(int));
+        if (buffer->items == NULL) {
+            fprintf(stderr, "Memory allocation failed in delta-stepping\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    buffer->items[buffer->size++] = value;
+}
+
+// Atomically lower *slot to value, returns true if this call improved it
+static bool atomic_relax(int* slot, long long value)
+{
+    if (value >= GRAPH_UNREACHABLE) {
+        return false;
+    }
+
+    int current = __atomic_load_n(slot, __ATOMIC_RELAXED);
+    while (value < current) {
+        if (__atomic_compare_exchange_n(slot, &current, (int)value, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void run_phase(ds_shared* s, int id)
+{
+    int chunk = (s->work_size + s->thread_count - 1) / s->thread_count;
+    int lo = id * chunk;
+    int hi = (lo + chunk < s->work_size) ? lo + chunk : s->work_size;
+
+    csr_graph* g = s->graph;
+    node_buffer* out = &s->improved[id];
+
+    for (int i = lo; i < hi; i++) {
+        if (s->phase == PHASE_PREV) {
+            // Canonical predecessor: smallest u on a shortest path to v
+            int u = i;
+            int du = s->dist[u];
+            if (du == GRAPH_UNREACHABLE) continue;
+            for (int e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+                int v = g->targets[e];
+                if (v != u && s->dist[v] != 0 && (long long)du + g->weights[e] == s->dist[v]) {
+                    int current = __atomic_load_n(&s->prev[v], __ATOMIC_RELAXED);
+                    while (u < current &&
+                           !__atomic_compare_exchange_n(&s->prev[v], &current, u, true,
+                                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                    }
+                }
+            }
+            continue;
+        }
+
+        int u = s->work[i];
+        int du = __atomic_load_n(&s->dist[u], __ATOMIC_RELAXED);
+
+        if (s->phase == PHASE_LIGHT) {
+            if (du / s->delta != s->bucket) continue; // stale bucket entry
+            for (int e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+                if (g->weights[e] <= s->delta &&
+                    atomic_relax(&s->dist[g->targets[e]], (long long)du + g->weights[e])) {
+                    buffer_push(out, g->targets[e]);
+                }
+            }
+        } else {
+            for (int e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+                if (g->weights[e] > s->delta &&
+                    atomic_relax(&s->dist[g->targets[e]], (long long)du + g->weights[e])) {
+                    buffer_push(out, g->targets[e]);
+                }
+            }
+        }
+    }
+}
+
+static void* worker_main(void* arg)
+{
+    ds_worker* worker = (ds_worker*)arg;
+    ds_shared* s = worker->shared;
+
+    while (true) {
+        pthread_barrier_wait(&s->start);
+        if (s->phase == PHASE_EXIT) break;
+        run_phase(s, worker->id);
+        pthread_barrier_wait(&s->done);
+    }
+    return NULL;
+}
+
+// Run one phase on every thread, the caller acting as thread 0
+static void dispatch(ds_shared* s, int phase, const int* work, int work_size)
+{
+    s->phase = phase;
+    s->work = work;
+    s->work_size = work_size;
+
+    if (s->thread_count == 1) {
+        run_phase(s, 0);
+        return;
+    }
+
+    pthread_barrier_wait(&s->start);
+    run_phase(s, 0);
+    pthread_barrier_wait(&s->done);
+}
+
+void init_delta_stepping_config(delta_stepping_config* config)
+{
+    config->delta = 0;
+    config->threads = 0;
+    config->min_nodes = DELTA_STEPPING_MIN_NODES;
+}
+
+int delta_stepping_auto_delta(csr_graph* graph)
+{
+    if (graph->node_count == 0 || graph->edge_count == 0) {
+        return 1;
+    }
+
+    long long weight_sum = 0;
+    for (int e = 0; e < graph->edge_count; e++) {
+        weight_sum += graph->weights[e];
+    }
+
+    double mean_weight = (double)weight_sum / graph->edge_count;
+    double mean_degree = (double)graph->edge_count / graph->node_count;
+    int delta = (int)(2.0 * mean_weight / mean_degree);
+
+    return (delta < 1) ? 1 : delta;
+}
+
+int delta_stepping(csr_graph* graph, int source, const delta_stepping_config* config, int* dist, int* prev)
+{
+    int n = graph->node_count;
+
+    if (n < config->min_nodes || source < 0 || source >= n) {
+        dijkstra_csr(graph, source, dist, prev);
+        return 0;
+    }
+
+    ds_shared s;
+    s.graph = graph;
+    s.delta = (config->delta > 0) ? config->delta : delta_stepping_auto_delta(graph);
+    s.thread_count = (config->threads > 0) ? config->threads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (s.thread_count < 1) s.thread_count = 1;
+    s.dist = dist;
+    s.prev = prev;
+    s.bucket = 0;
+    s.improved = (node_buffer*)calloc(s.thread_count, sizeof(node_buffer));
+
+    // Pending distances always lie within max_weight of the current bucket,
+    // so a ring of this many buckets never wraps onto a live one
+    int bucket_count = graph->max_weight / s.delta + 2;
+    node_buffer* buckets = (node_buffer*)calloc(bucket_count, sizeof(node_buffer));
+    int* frontier_stamp = (int*)calloc(n, sizeof(int));
+    int* settled_stamp = (int*)calloc(n, sizeof(int));
+
+    if (s.improved == NULL || buckets == NULL || frontier_stamp == NULL || settled_stamp == NULL) {
+        fprintf(stderr, "Memory allocation failed in delta-stepping\n");
+        exit(EXIT_FAILURE);
+    }
+
+    pthread_t* threads = NULL;
+    ds_worker* workers = NULL;
+    if (s.thread_count > 1) {
+        pthread_barrier_init(&s.start, NULL, s.thread_count);
+        pthread_barrier_init(&s.done, NULL, s.thread_count);
+        threads = (pthread_t*)malloc(s.thread_count * sizeof(pthread_t));
+        workers = (ds_worker*)malloc(s.thread_count * sizeof(ds_worker));
+        if (threads == NULL || workers == NULL) {
+            fprintf(stderr, "Memory allocation failed in delta-stepping\n");
+            exit(EXIT_FAILURE);
+        }
+        for (int t = 1; t < s.thread_count; t++) {
+            workers[t].shared = &s;
+            workers[t].id = t;
+            if (pthread_create(&threads[t], NULL, worker_main, &workers[t]) != 0) {
+                fprintf(stderr, "Failed to start delta-stepping worker thread\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        dist[i] = GRAPH_UNREACHABLE;
+    }
+    dist[source] = 0;
+    buffer_push(&buckets[0], source);
+
+    node_buffer frontier = { NULL, 0, 0 };
+    node_buffer settled = { NULL, 0, 0 };
+    int frontier_epoch = 0;
+    int settled_epoch = 0;
+
+    while (true) {
+        // Advance to the lowest non-empty bucket
+        int step = 0;
+        while (step < bucket_count && buckets[(s.bucket + step) % bucket_count].size == 0) {
+            step++;
+        }
+        if (step == bucket_count) break;
+        s.bucket += step;
+
+        node_buffer* current = &buckets[s.bucket % bucket_count];
+        frontier.size = 0;
+        frontier_epoch++;
+        for (int i = 0; i < current->size; i++) {
+            int v = current->items[i];
+            if (dist[v] / s.delta == s.bucket && frontier_stamp[v] != frontier_epoch) {
+                frontier_stamp[v] = frontier_epoch;
+                buffer_push(&frontier, v);
+            }
+        }
+        current->size = 0;
+
+        settled.size = 0;
+        settled_epoch++;
+
+        // Light edges can refill the current bucket, so iterate until it stays empty
+        while (frontier.size > 0) {
+            for (int i = 0; i < frontier.size; i++) {
+                int v = frontier.items[i];
+                if (settled_stamp[v] != settled_epoch) {
+                    settled_stamp[v] = settled_epoch;
+                    buffer_push(&settled, v);
+                }
+            }
+
+            dispatch(&s, PHASE_LIGHT, frontier.items, frontier.size);
+
+            frontier.size = 0;
+            frontier_epoch++;
+            for (int t = 0; t < s.thread_count; t++) {
+                node_buffer* improved = &s.improved[t];
+                for (int i = 0; i < improved->size; i++) {
+                    int v = improved->items[i];
+                    long long b = dist[v] / s.delta;
+                    if (b == s.bucket) {
+                        if (frontier_stamp[v] != frontier_epoch) {
+                            frontier_stamp[v] = frontier_epoch;
+                            buffer_push(&frontier, v);
+                        }
+                    } else {
+                        buffer_push(&buckets[b % bucket_count], v);
+                    }
+                }
+                improved->size = 0;
+            }
+        }
+
+        // Heavy edges always land in later buckets
+        dispatch(&s, PHASE_HEAVY, settled.items, settled.size);
+        for (int t = 0; t < s.thread_count; t++) {
+            node_buffer* improved = &s.improved[t];
+            for (int i = 0; i < improved->size; i++) {
+                int v = improved->items[i];
+                buffer_push(&buckets[(dist[v] / s.delta) % bucket_count], v);
+            }
+            improved->size = 0;
+        }
+
+        s.bucket++;
+    }
+
+    for (int i = 0; i < n; i++) {
+        prev[i] = GRAPH_UNREACHABLE;
+    }
+    dispatch(&s, PHASE_PREV, NULL, n);
+    for (int i = 0; i < n; i++) {
+        if (prev[i] == GRAPH_UNREACHABLE) prev[i] = -1;
+    }
+
+    if (s.thread_count > 1) {
+        s.phase = PHASE_EXIT;
+        pthread_barrier_wait(&s.start);
+        for (int t = 1; t < s.thread_count; t++) {
+            pthread_join(threads[t], NULL);
+        }
+        pthread_barrier_destroy(&s.start);
+        pthread_barrier_destroy(&s.done);
+        free(threads);
+        free(workers);
+    }
+
+    for (int b = 0; b < bucket_count; b++) {
+        free(buckets[b].items);
+    }
+    for (int t = 0; t < s.thread_count; t++) {
+        free(s.improved[t].items);
+    }
+    free(buckets);
+    free(s.improved);
+    free(frontier.items);
+    free(settled.items);
+    free(frontier_stamp);
+    free(settled_stamp);
+
+    return s.delta;
+}
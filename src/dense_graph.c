@@ -0,0 +1,299 @@
+/**
+ * dense_graph.c
+ * Adjacency-matrix graphs and a vectorized Dijkstra for small, dense topologies
+ *
+ * With a linear-scan priority queue every step of Dijkstra is one pass over a
+ * matrix row and the distance array: relax the row of the node just settled
+ * and pick the closest unsettled node for the next step. Both happen in the
+ * same pass, 4 or 8 nodes per instruction, without a branch per node.
+ * Settled nodes need no mask: with positive weights no path through a later
+ * node can be as short, so they are never relaxed again. For the same reason
+ * every tight predecessor of a node is settled before it, which lets the
+ * canonical (smallest) predecessor be kept on the fly.
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/dense_graph.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DENSE_X86 1
+#include <immintrin.h>
+#endif
+
+void dense_from_topology(dense_graph* graph, network_topology* network)
+{
+    graph->node_count = network->node_count;
+    graph->stride = MAX_NODES;
+    graph->weights = &network->graph[0][0];
+    graph->owns_weights = false;
+    graph->edge_count = 0;
+    for (int u = 0; u < network->node_count; u++) {
+        for (int v = 0; v < network->node_count; v++) {
+            graph->edge_count += (network->graph[u][v] > 0);
+        }
+    }
+}
+
+void dense_from_csr(dense_graph* graph, const csr_graph* csr)
+{
+    int n = csr->node_count;
+    if (n > DENSE_MAX_NODES) {
+        fprintf(stderr, "Graph too large for a dense matrix (%d nodes)\n", n);
+        exit(EXIT_FAILURE);
+    }
+
+    // Rows padded to whole 32-byte vectors
+    graph->node_count = n;
+    graph->stride = (n + 7) & ~7;
+    graph->owns_weights = true;
+    size_t bytes = (size_t)n * graph->stride * sizeof(int);
+    graph->weights = (int*)aligned_alloc(32, bytes > 0 ? bytes : 32);
+    if (graph->weights == NULL) {
+        fprintf(stderr, "Memory allocation failed for dense graph\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(graph->weights, 0, bytes);
+
+    graph->edge_count = 0;
+    for (int u = 0; u < n; u++) {
+        int* row = graph->weights + (size_t)u * graph->stride;
+        for (int e = csr->offsets[u]; e < csr->offsets[u + 1]; e++) {
+            int v = csr->targets[e];
+            int w = csr->weights[e];
+            if (w <= 0) continue;
+            if (row[v] == 0) graph->edge_count++;
+            if (row[v] == 0 || w < row[v]) row[v] = w;
+        }
+    }
+}
+
+void dense_free(dense_graph* graph)
+{
+    if (graph->owns_weights) {
+        free(graph->weights);
+    }
+    graph->weights = NULL;
+    graph->node_count = 0;
+    graph->edge_count = 0;
+}
+
+bool dense_preferred(int node_count, long edge_count)
+{
+    // Crossover measured with --bench-dense: with AVX2 the matrix wins from about
+    // 3% of all node pairs, with SSE4.1 from about 6%; the scalar loop never pays
+    if (node_count > DENSE_MAX_NODES) return false;
+    long pairs = (long)node_count * node_count;
+    switch (dense_best_kernel()) {
+        case DENSE_KERNEL_AVX2:  return edge_count * 32 >= pairs;
+        case DENSE_KERNEL_SSE41: return edge_count * 16 >= pairs;
+        default:                 return false;
+    }
+}
+
+bool dense_kernel_supported(dense_kernel kernel)
+{
+#ifdef DENSE_X86
+    __builtin_cpu_init();
+    if (kernel == DENSE_KERNEL_AVX2) return __builtin_cpu_supports("avx2");
+    if (kernel == DENSE_KERNEL_SSE41) return __builtin_cpu_supports("sse4.1");
+#else
+    if (kernel == DENSE_KERNEL_AVX2 || kernel == DENSE_KERNEL_SSE41) return false;
+#endif
+    return true;
+}
+
+dense_kernel dense_best_kernel(void)
+{
+    if (dense_kernel_supported(DENSE_KERNEL_AVX2)) return DENSE_KERNEL_AVX2;
+    if (dense_kernel_supported(DENSE_KERNEL_SSE41)) return DENSE_KERNEL_SSE41;
+    return DENSE_KERNEL_SCALAR;
+}
+
+const char* dense_kernel_name(dense_kernel kernel)
+{
+    switch (kernel) {
+        case DENSE_KERNEL_AUTO:   return "auto";
+        case DENSE_KERNEL_SCALAR: return "scalar";
+        case DENSE_KERNEL_SSE41:  return "SSE4.1";
+        case DENSE_KERNEL_AVX2:   return "AVX2";
+    }
+    return "unknown";
+}
+
+// Relax the row of u, then return the first unsettled node with the smallest key (-1 if none)
+static int relax_select_scalar(const int* row, int n, int u, int dist_u, int* dist, int* key, int* prev,
+                               bool canonical)
+{
+    int best = INT_MAX;
+    int best_node = -1;
+    for (int v = 0; v < n; v++) {
+        int w = row[v];
+        int candidate = dist_u + w;
+        if (w > 0 && (candidate < dist[v] || (canonical && candidate == dist[v] && u < prev[v]))) {
+            dist[v] = candidate;
+            key[v] = candidate;
+            prev[v] = u;
+        }
+        if (key[v] < best) {
+            best = key[v];
+            best_node = v;
+        }
+    }
+    return best_node;
+}
+
+// Lanes keep their first minimum; across lanes the smallest node wins a tie
+static int reduce_lanes(const int* values, const int* nodes, int lanes, int* best)
+{
+    int best_node = -1;
+    *best = INT_MAX;
+    for (int l = 0; l < lanes; l++) {
+        if (nodes[l] >= 0 && (values[l] < *best || (values[l] == *best && nodes[l] < best_node))) {
+            *best = values[l];
+            best_node = nodes[l];
+        }
+    }
+    return best_node;
+}
+
+#ifdef DENSE_X86
+__attribute__((target("sse4.1")))
+static int relax_select_sse41(const int* row, int n, int u, int dist_u, int* dist, int* key, int* prev,
+                              bool canonical)
+{
+    const __m128i base = _mm_set1_epi32(dist_u);
+    const __m128i source = _mm_set1_epi32(u);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i step = _mm_set1_epi32(4);
+    __m128i node = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i best = _mm_set1_epi32(INT_MAX);
+    __m128i best_node = _mm_set1_epi32(-1);
+
+    int v = 0;
+    for (; v + 4 <= n; v += 4) {
+        __m128i w = _mm_loadu_si128((const __m128i*)(row + v));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dist + v));
+        __m128i k = _mm_loadu_si128((const __m128i*)(key + v));
+        __m128i candidate = _mm_add_epi32(base, w);
+        __m128i shorter = _mm_cmpgt_epi32(d, candidate);
+        if (canonical) {
+            __m128i p = _mm_loadu_si128((const __m128i*)(prev + v));
+            shorter = _mm_or_si128(shorter, _mm_and_si128(_mm_cmpeq_epi32(d, candidate), _mm_cmpgt_epi32(p, source)));
+        }
+        __m128i improve = _mm_and_si128(_mm_cmpgt_epi32(w, zero), shorter);
+        if (!_mm_testz_si128(improve, improve)) {
+            _mm_storeu_si128((__m128i*)(dist + v), _mm_blendv_epi8(d, candidate, improve));
+            k = _mm_blendv_epi8(k, candidate, improve);
+            _mm_storeu_si128((__m128i*)(key + v), k);
+            __m128i p = _mm_loadu_si128((const __m128i*)(prev + v));
+            _mm_storeu_si128((__m128i*)(prev + v), _mm_blendv_epi8(p, source, improve));
+        }
+        __m128i less = _mm_cmplt_epi32(k, best);
+        best = _mm_blendv_epi8(best, k, less);
+        best_node = _mm_blendv_epi8(best_node, node, less);
+        node = _mm_add_epi32(node, step);
+    }
+
+    int values[4], nodes[4], best_value;
+    _mm_storeu_si128((__m128i*)values, best);
+    _mm_storeu_si128((__m128i*)nodes, best_node);
+    int selected = reduce_lanes(values, nodes, 4, &best_value);
+
+    // The tail holds the highest-numbered nodes, so only a strictly smaller key wins
+    int tail = relax_select_scalar(row + v, n - v, u, dist_u, dist + v, key + v, prev + v, canonical);
+    if (tail >= 0 && key[v + tail] < best_value) selected = v + tail;
+    return selected;
+}
+
+__attribute__((target("avx2")))
+static int relax_select_avx2(const int* row, int n, int u, int dist_u, int* dist, int* key, int* prev,
+                             bool canonical)
+{
+    const __m256i base = _mm256_set1_epi32(dist_u);
+    const __m256i source = _mm256_set1_epi32(u);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i node = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i best = _mm256_set1_epi32(INT_MAX);
+    __m256i best_node = _mm256_set1_epi32(-1);
+
+    int v = 0;
+    for (; v + 8 <= n; v += 8) {
+        __m256i w = _mm256_loadu_si256((const __m256i*)(row + v));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dist + v));
+        __m256i k = _mm256_loadu_si256((const __m256i*)(key + v));
+        __m256i candidate = _mm256_add_epi32(base, w);
+        __m256i shorter = _mm256_cmpgt_epi32(d, candidate);
+        if (canonical) {
+            __m256i p = _mm256_loadu_si256((const __m256i*)(prev + v));
+            shorter = _mm256_or_si256(shorter, _mm256_and_si256(_mm256_cmpeq_epi32(d, candidate),
+                                                                _mm256_cmpgt_epi32(p, source)));
+        }
+        __m256i improve = _mm256_and_si256(_mm256_cmpgt_epi32(w, zero), shorter);
+        if (!_mm256_testz_si256(improve, improve)) {
+            _mm256_storeu_si256((__m256i*)(dist + v), _mm256_blendv_epi8(d, candidate, improve));
+            k = _mm256_blendv_epi8(k, candidate, improve);
+            _mm256_storeu_si256((__m256i*)(key + v), k);
+            __m256i p = _mm256_loadu_si256((const __m256i*)(prev + v));
+            _mm256_storeu_si256((__m256i*)(prev + v), _mm256_blendv_epi8(p, source, improve));
+        }
+        __m256i less = _mm256_cmpgt_epi32(best, k);
+        best = _mm256_blendv_epi8(best, k, less);
+        best_node = _mm256_blendv_epi8(best_node, node, less);
+        node = _mm256_add_epi32(node, step);
+    }
+
+    int values[8], nodes[8], best_value;
+    _mm256_storeu_si256((__m256i*)values, best);
+    _mm256_storeu_si256((__m256i*)nodes, best_node);
+    int selected = reduce_lanes(values, nodes, 8, &best_value);
+
+    int tail = relax_select_scalar(row + v, n - v, u, dist_u, dist + v, key + v, prev + v, canonical);
+    if (tail >= 0 && key[v + tail] < best_value) selected = v + tail;
+    return selected;
+}
+#endif
+
+void dijkstra_dense(const dense_graph* graph, int source, int target, int* dist, int* prev,
+                    dense_kernel kernel, bool canonical)
+{
+    int n = graph->node_count;
+    int* key = (int*)malloc(n * sizeof(int));   // dist[] of unsettled nodes, INT_MAX once settled
+    if (key == NULL) {
+        fprintf(stderr, "Memory allocation failed in Dijkstra's algorithm\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < n; v++) {
+        dist[v] = INT_MAX;
+        prev[v] = -1;
+        key[v] = INT_MAX;
+    }
+    dist[source] = 0;
+
+    if (kernel == DENSE_KERNEL_AUTO || !dense_kernel_supported(kernel)) {
+        kernel = (kernel == DENSE_KERNEL_AUTO) ? dense_best_kernel() : DENSE_KERNEL_SCALAR;
+    }
+
+    // The source is the first node settled; every pass settles the next one
+    int u = source;
+    while (u >= 0 && u != target) {
+        const int* row = graph->weights + (size_t)u * graph->stride;
+        key[u] = INT_MAX;
+#ifdef DENSE_X86
+        if (kernel == DENSE_KERNEL_AVX2) {
+            u = relax_select_avx2(row, n, u, dist[u], dist, key, prev, canonical);
+            continue;
+        }
+        if (kernel == DENSE_KERNEL_SSE41) {
+            u = relax_select_sse41(row, n, u, dist[u], dist, key, prev, canonical);
+            continue;
+        }
+#endif
+        u = relax_select_scalar(row, n, u, dist[u], dist, key, prev, canonical);
+    }
+
+    free(key);
+}
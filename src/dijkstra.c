@@ -7,6 +7,7 @@
  #include <stdlib.h>
  #include <stdbool.h>
  #include <limits.h>
+ #include "include/dense_graph.h"
  #include "include/dijkstra.h"
  
  int dijkstra(network_topology* network, int source, int destination, int** path) {
@@ -18,61 +19,23 @@
      int n = network->node_count;
      int* dist = (int*)malloc(n * sizeof(int));
      int* prev = (int*)malloc(n * sizeof(int));
-     bool* visited = (bool*)malloc(n * sizeof(bool));
      
-     if (dist == NULL || prev == NULL || visited == NULL) {
+     if (dist == NULL || prev == NULL) {
          fprintf(stderr, "Memory allocation failed in Dijkstra's algorithm\n");
          exit(EXIT_FAILURE);
      }
      
-     // Initialize arrays
-     for (int i = 0; i < n; i++) {
-         dist[i] = INT_MAX;
-         prev[i] = -1;
-         visited[i] = false;
-     }
-     
-     dist[source] = 0;
-     
-     // Main Dijkstra algorithm
-     for (int count = 0; count < n; count++) {
-         // Find the unvisited node with minimum distance
-         int min_dist = INT_MAX;
-         int min_node = -1;
-         
-         for (int v = 0; v < n; v++) {
-             if (!visited[v] && dist[v] < min_dist) {
-                 min_dist = dist[v];
-                 min_node = v;
-             }
-         }
-         
-         // If no node found or we reached the destination, break
-         if (min_node == -1 || min_node == destination) break;
-         
-         // Mark the node as visited
-         visited[min_node] = true;
-         
-         // Update distances to adjacent nodes
-         for (int v = 0; v < n; v++) {
-             // Check if there's a connection and if we can improve the path
-             if (network->graph[min_node][v] > 0 && 
-                 !visited[v] && 
-                 dist[min_node] != INT_MAX && 
-                 dist[min_node] + network->graph[min_node][v] < dist[v]) {
-                 
-                 dist[v] = dist[min_node] + network->graph[min_node][v];
-                 prev[v] = min_node;
-             }
-         }
-     }
+     // Each step relaxes a whole matrix row and picks the next node in one
+     // vectorized pass, stopping once the destination is settled
+     dense_graph matrix;
+     dense_from_topology(&matrix, network);
+     dijkstra_dense(&matrix, source, destination, dist, prev, DENSE_KERNEL_AUTO, false);
      
      // Check if destination is reachable
      if (dist[destination] == INT_MAX) {
          printf("No path exists from node %d to node %d.\n", source, destination);
          free(dist);
          free(prev);
-         free(visited);
          return -1;
      }
      
@@ -107,7 +70,6 @@
      // Free temporary arrays
      free(dist);
      free(prev);
-     free(visited);
      
      return count;
  }
\ No newline at end of file
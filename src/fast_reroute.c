@@ -0,0 +1,358 @@
+/**
+ * fast_reroute.c
+ * Loop-free alternates and remote LFAs precomputed for fast reroute on link failure
+ *
+ * With D the destination, S the router and E its primary next hop, a neighbor
+ * N is a loop-free alternate if dist(N, D) < dist(N, S) + dist(S, D): none of
+ * N's shortest paths to D come back through S, so none use the link S -> E.
+ * It also protects against the failure of E if dist(N, D) < dist(N, E) + dist(E, D).
+ * Where no neighbor qualifies, a remote LFA is a node P that S reaches without
+ * the link (dist(S, P) < cost(S, E) + dist(E, P)) and whose own path to D avoids
+ * S; the packet is tunneled to P and forwarded normally from there.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../include/fast_reroute.h"
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void* frr_alloc(size_t bytes)
+{
+    void* p = malloc(bytes > 0 ? bytes : 1);
+    if (p == NULL) {
+        fprintf(stderr, "Memory allocation failed for fast reroute\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+#define FRR_INFINITY (1LL << 40)   // beyond any sum of real distances
+
+// Distance as a wide integer, FRR_INFINITY if unreachable
+static long long span(const frr_table* table, int from, int to)
+{
+    int d = table->dist[(size_t)from * table->node_count + to];
+    return (d == GRAPH_UNREACHABLE) ? FRR_INFINITY : d;
+}
+
+// First hop of every route of one source from its shortest-path tree
+static void first_hops(int source, const int* prev, int n, int* next_hop, int* stack)
+{
+    for (int v = 0; v < n; v++) {
+        next_hop[v] = -2;   // not computed yet
+    }
+    next_hop[source] = source;
+    for (int v = 0; v < n; v++) {
+        int top = 0;
+        int x = v;
+        while (next_hop[x] == -2 && prev[x] >= 0 && prev[x] != source) {
+            stack[top++] = x;
+            x = prev[x];
+        }
+        int hop = (next_hop[x] != -2) ? next_hop[x] : (prev[x] == source ? x : -1);
+        next_hop[x] = hop;
+        while (top > 0) {
+            next_hop[stack[--top]] = hop;
+        }
+    }
+}
+
+// Pick the backup of router s towards d, whose primary next hop is e
+static void choose_backup(frr_table* table, csr_graph* graph, frr_protection protection, int s, int d, int e)
+{
+    int n = table->node_count;
+    size_t index = (size_t)s * n + d;
+    long long s_to_d = span(table, s, d);
+
+    int best = -1;
+    long long best_cost = 0;
+    bool best_node = false;
+    long long link_cost = -1;   // cheapest parallel link s -> e
+    for (int k = graph->offsets[s]; k < graph->offsets[s + 1]; k++) {
+        int neighbor = graph->targets[k];
+        if (neighbor == e) {
+            if (link_cost < 0 || graph->weights[k] < link_cost) link_cost = graph->weights[k];
+            continue;
+        }
+        if (neighbor == s) continue;
+        long long n_to_d = span(table, neighbor, d);
+        if (n_to_d >= FRR_INFINITY) continue;
+        if (n_to_d >= span(table, neighbor, s) + s_to_d) continue;   // may loop back through s
+
+        bool node = (e != d) && n_to_d < span(table, neighbor, e) + span(table, e, d);
+        long long cost = graph->weights[k] + n_to_d;
+        if (best < 0 || (node && !best_node) || (node == best_node && cost < best_cost)) {
+            best = neighbor;
+            best_cost = cost;
+            best_node = node;
+        }
+    }
+    if (best >= 0) {
+        table->backup_hop[index] = best;
+        table->backup[index] = best_node ? FRR_BACKUP_NODE_LFA : FRR_BACKUP_LFA;
+        if (best_node) table->node_lfa++;
+        else table->lfa++;
+        return;
+    }
+    if (protection != FRR_REMOTE_LFA || link_cost < 0) return;
+
+    // Remote LFA: the cheapest repair node in s's P-space whose path to d avoids s
+    int repair = -1;
+    for (int p = 0; p < n; p++) {
+        if (p == s) continue;
+        long long s_to_p = span(table, s, p);
+        long long p_to_d = span(table, p, d);
+        if (s_to_p >= FRR_INFINITY || p_to_d >= FRR_INFINITY) continue;
+        if (s_to_p >= link_cost + span(table, e, p)) continue;
+        if (p_to_d >= span(table, p, s) + s_to_d) continue;
+        if (repair < 0 || s_to_p + p_to_d < best_cost) {
+            repair = p;
+            best_cost = s_to_p + p_to_d;
+        }
+    }
+    if (repair >= 0) {
+        table->backup_hop[index] = table->next_hop[(size_t)s * n + repair];
+        table->repair_node[index] = repair;
+        table->backup[index] = FRR_BACKUP_REMOTE_LFA;
+        table->remote_lfa++;
+    }
+}
+
+void frr_table_build(frr_table* table, csr_graph* graph, frr_protection protection)
+{
+    int n = graph->node_count;
+    size_t cells = (size_t)n * n;
+    double start = now_seconds();
+
+    table->node_count = n;
+    table->dist = (int*)frr_alloc(cells * sizeof(int));
+    table->next_hop = (int*)frr_alloc(cells * sizeof(int));
+    table->backup_hop = (int*)frr_alloc(cells * sizeof(int));
+    table->repair_node = (int*)frr_alloc(cells * sizeof(int));
+    table->backup = (uint8_t*)frr_alloc(cells);
+    table->routes = 0;
+    table->lfa = 0;
+    table->node_lfa = 0;
+    table->remote_lfa = 0;
+
+    int* prev = (int*)frr_alloc(n * sizeof(int));
+    int* stack = (int*)frr_alloc(n * sizeof(int));
+    for (int s = 0; s < n; s++) {
+        dijkstra_csr(graph, s, table->dist + (size_t)s * n, prev);
+        first_hops(s, prev, n, table->next_hop + (size_t)s * n, stack);
+    }
+    free(prev);
+    free(stack);
+
+    // Backups need every router's distances, so they follow the trees
+    for (int s = 0; s < n; s++) {
+        for (int d = 0; d < n; d++) {
+            size_t index = (size_t)s * n + d;
+            table->backup_hop[index] = -1;
+            table->repair_node[index] = -1;
+            table->backup[index] = FRR_BACKUP_NONE;
+
+            int e = table->next_hop[index];
+            if (e < 0 || e == s) continue;
+            table->routes++;
+            if (protection != FRR_NONE) {
+                choose_backup(table, graph, protection, s, d, e);
+            }
+        }
+    }
+    table->build_seconds = now_seconds() - start;
+}
+
+void frr_table_free(frr_table* table)
+{
+    free(table->dist);
+    free(table->next_hop);
+    free(table->backup_hop);
+    free(table->repair_node);
+    free(table->backup);
+    table->dist = NULL;
+    table->next_hop = NULL;
+    table->backup_hop = NULL;
+    table->repair_node = NULL;
+    table->backup = NULL;
+    table->node_count = 0;
+}
+
+int frr_next_hop(const frr_table* table, int router, int destination, bool primary_down, int* tunnel_to)
+{
+    size_t index = (size_t)router * table->node_count + destination;
+    *tunnel_to = -1;
+    if (!primary_down) {
+        return table->next_hop[index];
+    }
+    *tunnel_to = table->repair_node[index];
+    return table->backup_hop[index];
+}
+
+void init_frr_sim_config(frr_sim_config* config)
+{
+    config->protection = FRR_REMOTE_LFA;
+    config->fragment_interval_us = 100;
+    init_link_state_config(&config->link_state);
+}
+
+static bool link_failed(const link_delta* failed, int failed_count, int from, int to)
+{
+    for (int i = 0; i < failed_count; i++) {
+        if (failed[i].from == from && failed[i].to == to) return true;
+    }
+    return false;
+}
+
+// Copy of a graph without the failed links
+static void remove_links(csr_graph* out, const csr_graph* graph, const link_delta* failed, int failed_count)
+{
+    int n = graph->node_count;
+    out->node_count = n;
+    out->max_weight = graph->max_weight;
+    out->offsets = (int*)frr_alloc((n + 1) * sizeof(int));
+    out->targets = (int*)frr_alloc(graph->edge_count * sizeof(int));
+    out->weights = (int*)frr_alloc(graph->edge_count * sizeof(int));
+
+    int kept = 0;
+    for (int u = 0; u < n; u++) {
+        out->offsets[u] = kept;
+        for (int k = graph->offsets[u]; k < graph->offsets[u + 1]; k++) {
+            if (link_failed(failed, failed_count, u, graph->targets[k])) continue;
+            out->targets[kept] = graph->targets[k];
+            out->weights[kept] = graph->weights[k];
+            kept++;
+        }
+    }
+    out->offsets[n] = kept;
+    out->edge_count = kept;
+}
+
+// Forward one fragment injected at time t; routers switch to the new table once their SPF has run
+static void forward_fragment(const frr_table* old_table, const frr_table* new_table, const long long* converged_at,
+                             const link_delta* failed, int failed_count, bool protect, long long hop_us,
+                             int source, int destination, long long t, frr_outcome* outcome)
+{
+    int n = old_table->node_count;
+    int router = source;
+    int target = destination;
+    bool repaired = false;
+    outcome->sent++;
+
+    for (int hops = 0; router != destination; hops++) {
+        if (router == target) {
+            target = destination;   // end of a repair tunnel
+            continue;
+        }
+        if (hops >= FRR_HOP_LIMIT) {
+            outcome->looped++;
+            return;
+        }
+
+        bool converged = converged_at[router] >= 0 && t >= converged_at[router];
+        const frr_table* table = converged ? new_table : old_table;
+        int next = table->next_hop[(size_t)router * n + target];
+        if (next >= 0 && link_failed(failed, failed_count, router, next)) {
+            // Only an old route can still point at the failed link
+            int tunnel_to = -1;
+            next = protect ? frr_next_hop(old_table, router, target, true, &tunnel_to) : -1;
+            if (tunnel_to >= 0) {
+                if (target != destination) next = -1;   // no tunnel inside a tunnel
+                else target = tunnel_to;
+            }
+            repaired = (next >= 0);
+        }
+        if (next < 0) {
+            outcome->dropped++;
+            return;
+        }
+        router = next;
+        t += hop_us;
+    }
+
+    outcome->delivered++;
+    if (repaired) outcome->repaired++;
+}
+
+int frr_simulate_failure(csr_graph* graph, const link_delta* failed, int failed_count,
+                         const frr_sim_config* config, frr_sim_report* report)
+{
+    int n = graph->node_count;
+    for (int i = 0; i < failed_count; i++) {
+        bool present = false;
+        if (failed[i].from >= 0 && failed[i].from < n) {
+            for (int k = graph->offsets[failed[i].from]; k < graph->offsets[failed[i].from + 1]; k++) {
+                if (graph->targets[k] == failed[i].to) present = true;
+            }
+        }
+        if (!present) return -1;
+    }
+
+    frr_table old_table, new_table;
+    csr_graph after;
+    frr_table_build(&old_table, graph, config->protection);
+    remove_links(&after, graph, failed, failed_count);
+    frr_table_build(&new_table, &after, FRR_NONE);
+
+    // Reconvergence: when each router installs routes without the failed links
+    link_state_sim sim;
+    ls_report ls_result;
+    link_state_init(&sim, graph, &config->link_state);
+    for (int i = 0; i < failed_count; i++) {
+        link_state_change_link(&sim, 0, failed[i].from, failed[i].to, 0);
+    }
+    link_state_run(&sim, &ls_result);
+    long long* converged_at = (long long*)frr_alloc(n * sizeof(long long));
+    for (int r = 0; r < n; r++) {
+        long long at = sim.routers[r].stats.converged_at;
+        converged_at[r] = (at >= 0) ? at - ls_result.start_us : -1;
+    }
+    link_state_free(&sim);
+
+    report->convergence_us = ls_result.convergence_us;
+    report->affected_pairs = 0;
+    report->protected_routes = 0;
+    report->unprotected = (frr_outcome){ 0, 0, 0, 0, 0 };
+    report->fast_reroute = (frr_outcome){ 0, 0, 0, 0, 0 };
+
+    // Flows whose route crossed a failed link, and routes with a backup at that link
+    int* pairs = (int*)frr_alloc((size_t)n * n * sizeof(int));
+    for (int s = 0; s < n; s++) {
+        for (int d = 0; d < n; d++) {
+            if (s == d || old_table.next_hop[(size_t)s * n + d] < 0) continue;
+            for (int r = s; r != d; r = old_table.next_hop[(size_t)r * n + d]) {
+                int next = old_table.next_hop[(size_t)r * n + d];
+                if (link_failed(failed, failed_count, r, next)) {
+                    pairs[report->affected_pairs++] = s * n + d;
+                    if (old_table.backup_hop[(size_t)r * n + d] >= 0) report->protected_routes++;
+                    break;
+                }
+            }
+        }
+    }
+
+    // One fragment every interval, cycling through the affected flows, until every router has converged
+    long long hop_us = config->link_state.link_delay_us;
+    long long interval = config->fragment_interval_us > 0 ? config->fragment_interval_us : 1;
+    for (long long t = 0, k = 0; report->affected_pairs > 0 && t < report->convergence_us; t += interval, k++) {
+        int pair = pairs[k % report->affected_pairs];
+        forward_fragment(&old_table, &new_table, converged_at, failed, failed_count, false, hop_us,
+                         pair / n, pair % n, t, &report->unprotected);
+        forward_fragment(&old_table, &new_table, converged_at, failed, failed_count, true, hop_us,
+                         pair / n, pair % n, t, &report->fast_reroute);
+    }
+
+    free(pairs);
+    free(converged_at);
+    frr_table_free(&old_table);
+    frr_table_free(&new_table);
+    csr_free(&after);
+    return 0;
+}
@@ -0,0 +1,186 @@
+/**
+ * forwarding.c
+ * Per-router IPv4 forwarding tables built from shortest-path trees
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/forwarding.h"
+#include "../include/graph.h"
+
+uint32_t node_prefix(int node)
+{
+    return NODE_PREFIX_BASE | ((uint32_t)node << (32 - NODE_PREFIX_LENGTH));
+}
+
+uint32_t node_address(int node)
+{
+    return node_prefix(node) | 1;
+}
+
+int address_to_node(network_topology* network, uint32_t address)
+{
+    if ((address & 0xFF000000u) != NODE_PREFIX_BASE) {
+        return -1;
+    }
+
+    int node = (int)((address & 0x00FFFFFFu) >> (32 - NODE_PREFIX_LENGTH));
+    return is_valid_node(network, node) ? node : -1;
+}
+
+void format_ipv4_address(uint32_t address, char* buffer)
+{
+    sprintf(buffer, "%u.%u.%u.%u",
+            (address >> 24) & 0xFF, (address >> 16) & 0xFF,
+            (address >> 8) & 0xFF, address & 0xFF);
+}
+
+void forwarding_build(forwarding_plane* plane, network_topology* network)
+{
+    int n = network->node_count;
+    plane->node_count = n;
+    plane->next_hop = (int*)malloc((n > 0 ? (size_t)n * n : 1) * sizeof(int));
+    if (plane->next_hop == NULL) {
+        fprintf(stderr, "Memory allocation failed for forwarding tables\n");
+        exit(EXIT_FAILURE);
+    }
+
+    lpm_init(&plane->prefixes);
+    for (int node = 0; node < n; node++) {
+        lpm_add(&plane->prefixes, node_prefix(node), NODE_PREFIX_LENGTH, node);
+    }
+
+    csr_graph graph;
+    csr_from_topology(&graph, network);
+    int dist[MAX_NODES], prev[MAX_NODES];
+
+    for (int router = 0; router < n; router++) {
+        int* row = &plane->next_hop[router * n];
+        dijkstra_csr(&graph, router, dist, prev);
+        for (int dest = 0; dest < n; dest++) {
+            if (dest == router) {
+                row[dest] = router;
+                continue;
+            }
+            if (dist[dest] == GRAPH_UNREACHABLE) {
+                row[dest] = -1;
+                continue;
+            }
+
+            // Walk the tree back to the node just after the router
+            int hop = dest;
+            while (prev[hop] != router) {
+                hop = prev[hop];
+            }
+            row[dest] = hop;
+        }
+    }
+
+    csr_free(&graph);
+}
+
+void forwarding_update(forwarding_plane* plane, route_cache* routes)
+{
+    int n = plane->node_count;
+    for (int router = 0; router < n; router++) {
+        int* row = &plane->next_hop[router * n];
+        route_handle own = route_cache_lookup(routes, router, router);
+        if (own.tree == ROUTE_NO_TREE) {
+            // Route cache full: no routes from this router until it has room again
+            for (int dest = 0; dest < n; dest++) {
+                row[dest] = (dest == router) ? router : -1;
+            }
+            continue;
+        }
+
+        const uint16_t* prev = routes->trees[own.tree].prev;
+        for (int dest = 0; dest < n; dest++) {
+            if (dest == router) {
+                row[dest] = router;
+                continue;
+            }
+            if (prev[dest] == ROUTE_NO_PREV) {
+                row[dest] = -1;
+                continue;
+            }
+
+            // Walk the tree back to the node just after the router
+            int hop = dest;
+            while (prev[hop] != router) {
+                hop = prev[hop];
+            }
+            row[dest] = hop;
+        }
+        route_cache_release(routes, own);
+    }
+}
+
+void forwarding_free(forwarding_plane* plane)
+{
+    lpm_free(&plane->prefixes);
+    free(plane->next_hop);
+    plane->next_hop = NULL;
+    plane->node_count = 0;
+}
+
+int forwarding_next_hop(const forwarding_plane* plane, int router, uint32_t dest_ip)
+{
+    if (router < 0 || router >= plane->node_count) {
+        return -1;
+    }
+
+    uint32_t owner = lpm_lookup(&plane->prefixes, dest_ip);
+    return (owner == LPM_NO_ROUTE) ? -1 : plane->next_hop[router * plane->node_count + (int)owner];
+}
+
+int forwarding_egress(const forwarding_plane* plane, int source, uint32_t dest_ip)
+{
+    // A loop-free route visits every router at most once
+    int router = source;
+    for (int hops = 0; hops < plane->node_count; hops++) {
+        int next_hop = forwarding_next_hop(plane, router, dest_ip);
+        if (next_hop < 0) {
+            return -1;
+        }
+        if (next_hop == router) {
+            return router; // router owns the destination prefix
+        }
+        router = next_hop;
+    }
+    return -1; // forwarding loop
+}
+
+int forwarding_route(const forwarding_plane* plane, int source, uint32_t dest_ip, int** path)
+{
+    // A loop-free route visits every router at most once
+    int hops[MAX_NODES];
+    int count = 0;
+    int router = source;
+
+    while (count < plane->node_count) {
+        int next_hop = forwarding_next_hop(plane, router, dest_ip);
+        if (next_hop < 0) {
+            return -1;
+        }
+
+        hops[count++] = router;
+        if (next_hop == router) {
+            break; // router owns the destination prefix
+        }
+        router = next_hop;
+    }
+
+    if (count == 0 || forwarding_next_hop(plane, hops[count - 1], dest_ip) != hops[count - 1]) {
+        return -1; // forwarding loop
+    }
+
+    *path = (int*)malloc(count * sizeof(int));
+    if (*path == NULL) {
+        fprintf(stderr, "Memory allocation failed for path\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < count; i++) {
+        (*path)[i] = hops[i];
+    }
+    return count;
+}
@@ -0,0 +1,150 @@
+/**
+ * graph.c
+ * Compressed sparse row graphs and sequential shortest paths over them
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/graph.h"
+#include "../include/heap.h"
+
+static void csr_alloc(csr_graph* graph, int node_count, int edge_count)
+{
+    graph->node_count = node_count;
+    graph->edge_count = edge_count;
+    graph->offsets = (int*)malloc((node_count + 1) * sizeof(int));
+    graph->targets = (int*)malloc((edge_count > 0 ? edge_count : 1) * sizeof(int));
+    graph->weights = (int*)malloc((edge_count > 0 ? edge_count : 1) * sizeof(int));
+    graph->max_weight = 0;
+
+    if (graph->offsets == NULL || graph->targets == NULL || graph->weights == NULL) {
+        fprintf(stderr, "Memory allocation failed for CSR graph\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void csr_from_topology(csr_graph* graph, network_topology* network)
+{
+    int n = network->node_count;
+    int edges = 0;
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            if (network->graph[i][j] > 0) edges++;
+        }
+    }
+
+    csr_alloc(graph, n, edges);
+
+    int e = 0;
+    for (int i = 0; i < n; i++) {
+        graph->offsets[i] = e;
+        for (int j = 0; j < n; j++) {
+            if (network->graph[i][j] > 0) {
+                graph->targets[e] = j;
+                graph->weights[e] = network->graph[i][j];
+                if (network->graph[i][j] > graph->max_weight) {
+                    graph->max_weight = network->graph[i][j];
+                }
+                e++;
+            }
+        }
+    }
+    graph->offsets[n] = e;
+}
+
+void csr_generate_random(csr_graph* graph, int node_count, int degree, int max_weight, unsigned int seed)
+{
+    if (degree < 1) degree = 1;
+    if (max_weight < 1) max_weight = 1;
+
+    csr_alloc(graph, node_count, node_count * degree);
+
+    // xorshift32 keeps generation reproducible for a given seed
+    unsigned int state = seed ? seed : 0x9E3779B9u;
+    for (int u = 0; u < node_count; u++) {
+        int base = u * degree;
+        graph->offsets[u] = base;
+
+        graph->targets[base] = (u + 1) % node_count;
+        for (int k = 0; k < degree; k++) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            if (k > 0) {
+                graph->targets[base + k] = state % node_count;
+            }
+            graph->weights[base + k] = 1 + (int)((state >> 8) % max_weight);
+        }
+    }
+    graph->offsets[node_count] = node_count * degree;
+    graph->max_weight = max_weight;
+}
+
+void csr_free(csr_graph* graph)
+{
+    free(graph->offsets);
+    free(graph->targets);
+    free(graph->weights);
+    graph->offsets = NULL;
+    graph->targets = NULL;
+    graph->weights = NULL;
+    graph->node_count = 0;
+    graph->edge_count = 0;
+}
+
+void dijkstra_csr(csr_graph* graph, int source, int* dist, int* prev)
+{
+    int n = graph->node_count;
+    for (int i = 0; i < n; i++) {
+        dist[i] = GRAPH_UNREACHABLE;
+    }
+    if (source < 0 || source >= n) {
+        sssp_canonical_prev(graph, dist, prev);
+        return;
+    }
+
+    min_heap heap;
+    heap_init(&heap, 1024);
+
+    dist[source] = 0;
+    heap_push(&heap, 0, source);
+
+    heap_entry top;
+    while (heap_pop(&heap, &top)) {
+        int u = top.value;
+        if (top.key != dist[u]) continue; // stale entry
+
+        for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+            long long candidate = top.key + graph->weights[e];
+            int v = graph->targets[e];
+            if (candidate < dist[v]) {
+                dist[v] = (int)candidate;
+                heap_push(&heap, candidate, v);
+            }
+        }
+    }
+
+    heap_free(&heap);
+    sssp_canonical_prev(graph, dist, prev);
+}
+
+void sssp_canonical_prev(csr_graph* graph, const int* dist, int* prev)
+{
+    int n = graph->node_count;
+    for (int v = 0; v < n; v++) {
+        prev[v] = -1;
+    }
+
+    // Scanning u in increasing order makes the first match the smallest one
+    for (int u = 0; u < n; u++) {
+        if (dist[u] == GRAPH_UNREACHABLE) continue;
+        for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+            int v = graph->targets[e];
+            if (prev[v] == -1 && v != u && dist[v] != 0 &&
+                (long long)dist[u] + graph->weights[e] == dist[v]) {
+                prev[v] = u;
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/**
+ * heap.c
+ * Binary min-heap of (key, value) pairs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/heap.h"
+
+void heap_init(min_heap* heap, int capacity)
+{
+    heap->capacity = (capacity > 0) ? capacity : 16;
+    heap->size = 0;
+    heap->entries = (heap_entry*)malloc(heap->capacity * sizeof(heap_entry));
+    if (heap->entries == NULL) {
+        fprintf(stderr, "Memory allocation failed for heap\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void heap_free(min_heap* heap)
+{
+    free(heap->entries);
+    heap->entries = NULL;
+    heap->size = 0;
+    heap->capacity = 0;
+}
+
+void heap_push(min_heap* heap, long long key, int value)
+{
+    if (heap->size == heap->capacity) {
+        heap->capacity *= 2;
+        heap->entries = (heap_entry*)realloc(heap->entries, heap->capacity * sizeof(heap_entry));
+        if (heap->entries == NULL) {
+            fprintf(stderr, "Memory allocation failed for heap\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Sift up
+    int i = heap->size++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (heap->entries[parent].key <= key) break;
+        heap->entries[i] = heap->entries[parent];
+        i = parent;
+    }
+    heap->entries[i].key = key;
+    heap->entries[i].value = value;
+}
+
+bool heap_pop(min_heap* heap, heap_entry* entry)
+{
+    if (heap->size == 0) {
+        return false;
+    }
+
+    *entry = heap->entries[0];
+    heap_entry last = heap->entries[--heap->size];
+
+    // Sift the last entry down from the root
+    int i = 0;
+    while (true) {
+        int child = 2 * i + 1;
+        if (child >= heap->size) break;
+        if (child + 1 < heap->size && heap->entries[child + 1].key < heap->entries[child].key) {
+            child++;
+        }
+        if (last.key <= heap->entries[child].key) break;
+        heap->entries[i] = heap->entries[child];
+        i = child;
+    }
+    heap->entries[i] = last;
+    return true;
+}
@@ -3,9 +3,13 @@
 #include <string.h>
 #include "../include/ipv4.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 static uint16_t packet_id = 1000;
 
-void create_ipv4_packet(ipv4_packet* packet, int source, int destination, int payload_size)
+static int init_ipv4_header(ipv4_packet* packet, int source, int destination, int payload_size)
 {
     if (payload_size <=0 || payload_size> MAX_PAYLOAD_SIZE)
     {
@@ -25,17 +29,37 @@ void create_ipv4_packet(ipv4_packet* packet, int source, int destination, int pa
     packet->header.source_ip=source;
     packet->header.dest_ip=destination;
 
+    packet->payload_size= payload_size;
+
+    packet->header.checksum= 0;
+    packet->header.checksum= calculate_checksum(&packet->header);
+
+    return payload_size;
+}
+
+void create_ipv4_packet(ipv4_packet* packet, int source, int destination, int payload_size)
+{
+    payload_size = init_ipv4_header(packet, source, destination, payload_size);
+
+    packet->content.pattern = PAYLOAD_PATTERN_SEQUENTIAL;
+    packet->content.seed = 0;
+    packet->content.offset = 0;
+
     packet->payload = (uint8_t*)(malloc(payload_size));
     //Later: Add error incase malloc fails
 
-    for (int i = 0; i < payload_size; i++) {
-        packet->payload[i] = i % 256;
-    }
+    materialize_payload(&packet->content, packet->payload, payload_size);
+}
 
-    packet->payload_size= payload_size;
+void create_ipv4_packet_virtual(ipv4_packet* packet, int source, int destination, int payload_size,
+                                payload_pattern pattern, uint32_t seed)
+{
+    init_ipv4_header(packet, source, destination, payload_size);
 
-    packet->header.checksum= 0;
-    packet->header.checksum= calculate_checksum(&packet->header);
+    packet->content.pattern = pattern;
+    packet->content.seed = seed;
+    packet->content.offset = 0;
+    packet->payload = NULL;
 }
 
 int fragment_ipv4_packet(ipv4_packet* packet, int mtu, ipv4_fragment** fragments)
@@ -50,17 +74,22 @@ int fragment_ipv4_packet(ipv4_packet* packet, int mtu, ipv4_fragment** fragments
     
         (*fragments)[0].header = packet->header;
         (*fragments)[0].data_size = packet->payload_size;
-        (*fragments)[0].data = (uint8_t*)malloc(packet->payload_size);
-        if ((*fragments)[0].data == NULL) {
-            printf("Memory allocation failed\n");
-            free(*fragments);
-            return 0;
-        }
+        (*fragments)[0].content = packet->content;
+        (*fragments)[0].data = NULL;
+
+        if (packet->payload != NULL) //virtual packets keep only the descriptor
+        {
+            (*fragments)[0].data = (uint8_t*)malloc(packet->payload_size);
+            if ((*fragments)[0].data == NULL) {
+                printf("Memory allocation failed\n");
+                free(*fragments);
+                return 0;
+            }
 
-        memcpy((*fragments)[0].data, packet->payload, packet->payload_size);
+            memcpy((*fragments)[0].data, packet->payload, packet->payload_size);
+        }
 
-        (*fragments)[0].path_length = 0;
-        (*fragments)[0].path = NULL;
+        (*fragments)[0].route = ROUTE_HANDLE_NONE;
 
         return 1; //return 1 fragment(original one)
     }
@@ -99,22 +128,28 @@ int fragment_ipv4_packet(ipv4_packet* packet, int mtu, ipv4_fragment** fragments
             
             //allocate and copy fragment data
             (*fragments)[i].data_size = fragment_size;
-            (*fragments)[i].data = (uint8_t*)malloc(fragment_size);
-            if ((*fragments)[i].data == NULL) {
-                printf("Memory allocation failed\n");
-                // Free previously allocated fragments
-                for (int j = 0; j < i; j++) {
-                    free((*fragments)[j].data);
+            (*fragments)[i].content = packet->content;
+            (*fragments)[i].content.offset += offset;
+            (*fragments)[i].data = NULL;
+
+            if (packet->payload != NULL) //virtual packets keep only the descriptor
+            {
+                (*fragments)[i].data = (uint8_t*)malloc(fragment_size);
+                if ((*fragments)[i].data == NULL) {
+                    printf("Memory allocation failed\n");
+                    // Free previously allocated fragments
+                    for (int j = 0; j < i; j++) {
+                        free((*fragments)[j].data);
+                    }
+                    free(*fragments);
+                    return 0;
                 }
-                free(*fragments);
-                return 0;
-            }
 
-            memcpy((*fragments)[i].data, packet->payload + offset, fragment_size);
+                memcpy((*fragments)[i].data, packet->payload + offset, fragment_size);
+            }
 
             //path info
-            (*fragments)[i].path_length = 0;
-            (*fragments)[i].path = NULL;
+            (*fragments)[i].route = ROUTE_HANDLE_NONE;
 
             //recalc checksum for this fragment
             (*fragments)[i].header.checksum = 0;
@@ -129,10 +164,436 @@ int fragment_ipv4_packet(ipv4_packet* packet, int mtu, ipv4_fragment** fragments
     }
 }
 
+void fragment_batch_init(fragment_batch* batch, int capacity)
+{
+    memset(batch, 0, sizeof(*batch));
+    if (capacity > 0) {
+        batch->capacity = capacity;
+        batch->total_len = (uint16_t*)malloc(capacity * sizeof(uint16_t));
+        batch->identifier = (uint16_t*)malloc(capacity * sizeof(uint16_t));
+        batch->flags_frag_offset = (uint16_t*)malloc(capacity * sizeof(uint16_t));
+        batch->checksum = (uint16_t*)malloc(capacity * sizeof(uint16_t));
+        batch->tos = (uint8_t*)malloc(capacity);
+        batch->ttl = (uint8_t*)malloc(capacity);
+        batch->protocol = (uint8_t*)malloc(capacity);
+        batch->source_ip = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+        batch->dest_ip = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+        batch->data_offset = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+        if (batch->total_len == NULL || batch->identifier == NULL || batch->flags_frag_offset == NULL ||
+            batch->checksum == NULL || batch->tos == NULL || batch->ttl == NULL || batch->protocol == NULL ||
+            batch->source_ip == NULL || batch->dest_ip == NULL || batch->data_offset == NULL) {
+            fprintf(stderr, "Memory allocation failed for fragment batch\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void fragment_batch_free(fragment_batch* batch)
+{
+    free(batch->total_len);
+    free(batch->identifier);
+    free(batch->flags_frag_offset);
+    free(batch->checksum);
+    free(batch->tos);
+    free(batch->ttl);
+    free(batch->protocol);
+    free(batch->source_ip);
+    free(batch->dest_ip);
+    free(batch->data_offset);
+    memset(batch, 0, sizeof(*batch));
+}
+
+static void* grow_array(void* array, int capacity, size_t element)
+{
+    array = realloc(array, capacity * element);
+    if (array == NULL) {
+        fprintf(stderr, "Memory allocation failed for fragment batch\n");
+        exit(EXIT_FAILURE);
+    }
+    return array;
+}
+
+static void fragment_batch_reserve(fragment_batch* batch, int needed)
+{
+    if (needed <= batch->capacity) {
+        return;
+    }
+    int capacity = batch->capacity ? batch->capacity : 64;
+    while (capacity < needed) capacity *= 2;
+
+    batch->total_len = (uint16_t*)grow_array(batch->total_len, capacity, sizeof(uint16_t));
+    batch->identifier = (uint16_t*)grow_array(batch->identifier, capacity, sizeof(uint16_t));
+    batch->flags_frag_offset = (uint16_t*)grow_array(batch->flags_frag_offset, capacity, sizeof(uint16_t));
+    batch->checksum = (uint16_t*)grow_array(batch->checksum, capacity, sizeof(uint16_t));
+    batch->tos = (uint8_t*)grow_array(batch->tos, capacity, 1);
+    batch->ttl = (uint8_t*)grow_array(batch->ttl, capacity, 1);
+    batch->protocol = (uint8_t*)grow_array(batch->protocol, capacity, 1);
+    batch->source_ip = (uint32_t*)grow_array(batch->source_ip, capacity, sizeof(uint32_t));
+    batch->dest_ip = (uint32_t*)grow_array(batch->dest_ip, capacity, sizeof(uint32_t));
+    batch->data_offset = (uint32_t*)grow_array(batch->data_offset, capacity, sizeof(uint32_t));
+    batch->capacity = capacity;
+}
+
+//lengths, flags and data offsets of fragments 0..count-1 of a datagram, all full-sized
+static void layout_fragments(uint16_t* total_len, uint16_t* flags, uint32_t* data_offset, int count, int per_fragment)
+{
+    int i = 0;
+
+#ifdef __SSE2__
+    //8 fragments per step; offsets in 8-byte units stay below 8192, so 16-bit lanes suffice
+    const __m128i lane = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m128i units = _mm_set1_epi16((short)(per_fragment / 8));
+    const __m128i more = _mm_set1_epi16(0x2000);
+    const __m128i length = _mm_set1_epi16((short)(IPV4_HEADER_SIZE + per_fragment));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        __m128i offset_units = _mm_mullo_epi16(_mm_add_epi16(_mm_set1_epi16((short)i), lane), units);
+        _mm_storeu_si128((__m128i*)(flags + i), _mm_or_si128(more, offset_units));
+        _mm_storeu_si128((__m128i*)(total_len + i), length);
+        _mm_storeu_si128((__m128i*)(data_offset + i), _mm_slli_epi32(_mm_unpacklo_epi16(offset_units, zero), 3));
+        _mm_storeu_si128((__m128i*)(data_offset + i + 4), _mm_slli_epi32(_mm_unpackhi_epi16(offset_units, zero), 3));
+    }
+#endif
+
+    for (; i < count; i++) {
+        total_len[i] = (uint16_t)(IPV4_HEADER_SIZE + per_fragment);
+        flags[i] = (uint16_t)(0x2000 | (i * per_fragment / 8));
+        data_offset[i] = (uint32_t)(i * per_fragment);
+    }
+}
+
+int fragment_ipv4_packet_batch(const ipv4_packet* packet, int mtu, fragment_batch* batch)
+{
+    int per_fragment = (mtu - IPV4_HEADER_SIZE) & ~0x7;
+    bool fragmented = packet->header.total_len > mtu;
+    if (fragmented && per_fragment <= 0) {
+        return 0;
+    }
+
+    int count = fragmented ? (packet->payload_size + per_fragment - 1) / per_fragment : 1;
+    fragment_batch_reserve(batch, batch->count + count);
+    int first = batch->count;
+    int end = first + count;
+
+    for (int i = first; i < end; i++) {
+        batch->identifier[i] = packet->header.identifier;
+        batch->tos[i] = packet->header.tos;
+        batch->ttl[i] = packet->header.ttl;
+        batch->protocol[i] = packet->header.protocol;
+        batch->source_ip[i] = packet->header.source_ip;
+        batch->dest_ip[i] = packet->header.dest_ip;
+    }
+
+    if (!fragmented) {
+        batch->total_len[first] = packet->header.total_len;
+        batch->flags_frag_offset[first] = packet->header.flags_frag_offset;
+        batch->data_offset[first] = 0;
+    } else {
+        layout_fragments(batch->total_len + first, batch->flags_frag_offset + first, batch->data_offset + first,
+                         count, per_fragment);
+        //the last fragment carries the rest and clears More Fragments
+        batch->total_len[end - 1] = (uint16_t)(IPV4_HEADER_SIZE + packet->payload_size - (count - 1) * per_fragment);
+        batch->flags_frag_offset[end - 1] &= 0x1FFF;
+    }
+
+    batch->count = end;
+    fragment_batch_checksum(batch, first, count);
+    return count;
+}
+
+static uint16_t batch_checksum_one(const fragment_batch* batch, int i)
+{
+    uint32_t sum = (0x4500u | batch->tos[i]) + batch->total_len[i] + batch->identifier[i] +
+                   batch->flags_frag_offset[i] + ((uint32_t)batch->ttl[i] << 8 | batch->protocol[i]) +
+                   (batch->source_ip[i] >> 16) + (batch->source_ip[i] & 0xFFFF) +
+                   (batch->dest_ip[i] >> 16) + (batch->dest_ip[i] & 0xFFFF);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum += sum >> 16;
+    return (uint16_t)~sum;
+}
+
+#ifdef __SSE2__
+//zero-extend the low / high four 16-bit lanes to 32 bits
+#define WIDEN_LO(v) _mm_unpacklo_epi16((v), _mm_setzero_si128())
+#define WIDEN_HI(v) _mm_unpackhi_epi16((v), _mm_setzero_si128())
+
+//one's complement sum of four 32-bit addresses as 16-bit halves
+static __m128i address_words(const uint32_t* address)
+{
+    __m128i value = _mm_loadu_si128((const __m128i*)address);
+    return _mm_add_epi32(_mm_srli_epi32(value, 16), _mm_and_si128(value, _mm_set1_epi32(0xFFFF)));
+}
+
+//fold four 32-bit sums and return their complement, in the low 16 bits of each lane
+static __m128i fold_complement(__m128i sum)
+{
+    sum = _mm_add_epi32(_mm_and_si128(sum, _mm_set1_epi32(0xFFFF)), _mm_srli_epi32(sum, 16));
+    sum = _mm_add_epi32(sum, _mm_srli_epi32(sum, 16));
+    //sign-extend the complemented low half so the signed pack keeps the bit pattern
+    return _mm_srai_epi32(_mm_slli_epi32(_mm_xor_si128(sum, _mm_set1_epi32(-1)), 16), 16);
+}
+#endif
+
+void fragment_batch_checksum(fragment_batch* batch, int first, int count)
+{
+    int i = first;
+    int end = first + count;
+
+#ifdef __SSE2__
+    //8 headers per step: the 16-bit words are widened to 32-bit sums, then folded
+    const __m128i version = _mm_set1_epi8(0x45);
+    for (; i + 8 <= end; i += 8) {
+        __m128i version_tos = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(batch->tos + i)), version);
+        __m128i ttl_protocol = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(batch->protocol + i)),
+                                                 _mm_loadl_epi64((const __m128i*)(batch->ttl + i)));
+        __m128i total = _mm_loadu_si128((const __m128i*)(batch->total_len + i));
+        __m128i identifier = _mm_loadu_si128((const __m128i*)(batch->identifier + i));
+        __m128i flags = _mm_loadu_si128((const __m128i*)(batch->flags_frag_offset + i));
+
+        __m128i lo = _mm_add_epi32(_mm_add_epi32(WIDEN_LO(version_tos), WIDEN_LO(ttl_protocol)),
+                                   _mm_add_epi32(WIDEN_LO(total), WIDEN_LO(identifier)));
+        __m128i hi = _mm_add_epi32(_mm_add_epi32(WIDEN_HI(version_tos), WIDEN_HI(ttl_protocol)),
+                                   _mm_add_epi32(WIDEN_HI(total), WIDEN_HI(identifier)));
+        lo = _mm_add_epi32(lo, _mm_add_epi32(WIDEN_LO(flags), address_words(batch->source_ip + i)));
+        hi = _mm_add_epi32(hi, _mm_add_epi32(WIDEN_HI(flags), address_words(batch->source_ip + i + 4)));
+        lo = _mm_add_epi32(lo, address_words(batch->dest_ip + i));
+        hi = _mm_add_epi32(hi, address_words(batch->dest_ip + i + 4));
+
+        _mm_storeu_si128((__m128i*)(batch->checksum + i), _mm_packs_epi32(fold_complement(lo), fold_complement(hi)));
+    }
+#endif
+
+    for (; i < end; i++) {
+        batch->checksum[i] = batch_checksum_one(batch, i);
+    }
+}
+
+//RFC 1624: HC' = ~(~HC + ~m + m'); the TTL/protocol word drops by 0x100, so ~m + m' = 0xFEFF
+uint16_t checksum_after_ttl_decrement(uint16_t checksum)
+{
+    uint32_t sum = (uint16_t)~checksum + 0xFEFFu;
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
+int fragment_batch_decrement_ttl(fragment_batch* batch)
+{
+    int expired = 0;
+    int i = 0;
+
+#ifdef __SSE2__
+    //16 TTLs per step, their checksums in two 8-lane halves
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i adjust = _mm_set1_epi16((short)0xFEFF);
+    const __m128i carry_limit = _mm_set1_epi16(0x0100);
+    for (; i + 16 <= batch->count; i += 16) {
+        __m128i ttl = _mm_loadu_si128((const __m128i*)(batch->ttl + i));
+        __m128i was_zero = _mm_cmpeq_epi8(ttl, zero);
+        ttl = _mm_subs_epu8(ttl, one);
+        _mm_storeu_si128((__m128i*)(batch->ttl + i), ttl);
+        expired += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(ttl, zero)));
+
+        for (int half = 0; half < 2; half++) {
+            uint16_t* checksum = batch->checksum + i + half * 8;
+            __m128i unchanged = half ? _mm_unpackhi_epi8(was_zero, was_zero) : _mm_unpacklo_epi8(was_zero, was_zero);
+            __m128i old = _mm_loadu_si128((const __m128i*)checksum);
+            __m128i inverted = _mm_xor_si128(old, _mm_set1_epi16(-1));
+            //end-around carry: ~HC + 0xFEFF overflows 16 bits exactly when ~HC > 0x100
+            __m128i no_carry = _mm_cmpeq_epi16(_mm_subs_epu16(inverted, carry_limit), zero);
+            __m128i sum = _mm_add_epi16(_mm_add_epi16(inverted, adjust), _mm_andnot_si128(no_carry, _mm_set1_epi16(1)));
+            __m128i updated = _mm_xor_si128(sum, _mm_set1_epi16(-1));
+            _mm_storeu_si128((__m128i*)checksum,
+                             _mm_or_si128(_mm_and_si128(unchanged, old), _mm_andnot_si128(unchanged, updated)));
+        }
+    }
+#endif
+
+    for (; i < batch->count; i++) {
+        if (batch->ttl[i] > 0) {
+            batch->ttl[i]--;
+            batch->checksum[i] = checksum_after_ttl_decrement(batch->checksum[i]);
+        }
+        expired += (batch->ttl[i] == 0);
+    }
+    return expired;
+}
+
+void fragment_batch_header(const fragment_batch* batch, int index, ipv4_header* header)
+{
+    header->version_ihl = 0x45;
+    header->tos = batch->tos[index];
+    header->total_len = batch->total_len[index];
+    header->identifier = batch->identifier[index];
+    header->flags_frag_offset = batch->flags_frag_offset[index];
+    header->ttl = batch->ttl[index];
+    header->protocol = batch->protocol[index];
+    header->checksum = batch->checksum[index];
+    header->source_ip = batch->source_ip[index];
+    header->dest_ip = batch->dest_ip[index];
+}
+
+void ipv4_serialize_header(const ipv4_header* header, uint8_t* out)
+{
+    out[0] = header->version_ihl;
+    out[1] = header->tos;
+    out[2] = (uint8_t)(header->total_len >> 8);
+    out[3] = (uint8_t)header->total_len;
+    out[4] = (uint8_t)(header->identifier >> 8);
+    out[5] = (uint8_t)header->identifier;
+    out[6] = (uint8_t)(header->flags_frag_offset >> 8);
+    out[7] = (uint8_t)header->flags_frag_offset;
+    out[8] = header->ttl;
+    out[9] = header->protocol;
+    out[10] = (uint8_t)(header->checksum >> 8);
+    out[11] = (uint8_t)header->checksum;
+    for (int i = 0; i < 4; i++) {
+        out[12 + i] = (uint8_t)(header->source_ip >> (24 - 8 * i));
+        out[16 + i] = (uint8_t)(header->dest_ip >> (24 - 8 * i));
+    }
+}
+
+bool ipv4_parse_header(const uint8_t* in, ipv4_header* header)
+{
+    header->version_ihl = in[0];
+    header->tos = in[1];
+    header->total_len = (uint16_t)(in[2] << 8 | in[3]);
+    header->identifier = (uint16_t)(in[4] << 8 | in[5]);
+    header->flags_frag_offset = (uint16_t)(in[6] << 8 | in[7]);
+    header->ttl = in[8];
+    header->protocol = in[9];
+    header->checksum = (uint16_t)(in[10] << 8 | in[11]);
+    header->source_ip = (uint32_t)in[12] << 24 | (uint32_t)in[13] << 16 | (uint32_t)in[14] << 8 | in[15];
+    header->dest_ip = (uint32_t)in[16] << 24 | (uint32_t)in[17] << 16 | (uint32_t)in[18] << 8 | in[19];
+    return header->version_ihl == 0x45 && header->total_len >= IPV4_HEADER_SIZE;
+}
+
+static void fill_sequential(uint8_t* out, uint32_t offset, int length)
+{
+    int i = 0;
+
+#ifdef __SSE2__
+    // 16 bytes per store, the 8-bit lane adds wrap around at 256 like i % 256
+    __m128i value = _mm_add_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                                 _mm_set1_epi8((char)offset));
+    const __m128i step = _mm_set1_epi8(16);
+    for (; i + 16 <= length; i += 16) {
+        _mm_storeu_si128((__m128i*)(out + i), value);
+        value = _mm_add_epi8(value, step);
+    }
+#endif
+
+    for (; i < length; i++) {
+        out[i] = (uint8_t)(offset + i);
+    }
+}
+
+//64 random bits for each 8-byte block of the payload (splitmix64)
+static uint64_t random_block(uint32_t seed, uint64_t block)
+{
+    uint64_t z = (((uint64_t)seed << 32) ^ block) + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static void fill_random(uint8_t* out, uint32_t seed, uint32_t offset, int length)
+{
+    for (int i = 0; i < length; )
+    {
+        uint32_t position = offset + i;
+        uint64_t bits = random_block(seed, position / 8);
+
+        //emit the rest of this block
+        for (int byte = position % 8; byte < 8 && i < length; byte++, i++) {
+            out[i] = (uint8_t)(bits >> (byte * 8));
+        }
+    }
+}
+
+void materialize_payload(const payload_desc* desc, uint8_t* out, int length)
+{
+    if (desc->pattern == PAYLOAD_PATTERN_RANDOM) {
+        fill_random(out, desc->seed, desc->offset, length);
+    } else {
+        fill_sequential(out, desc->offset, length);
+    }
+}
+
+const uint8_t* fragment_payload(const ipv4_fragment* fragment, uint8_t* scratch)
+{
+    if (fragment->data != NULL) {
+        return fragment->data;
+    }
+
+    materialize_payload(&fragment->content, scratch, fragment->data_size);
+    return scratch;
+}
+
+int reassemble_ipv4_fragments(const ipv4_fragment* fragments, int count, uint8_t* out, int capacity)
+{
+    if (count <= 0) {
+        return -1;
+    }
+
+    //order fragments by offset (insertion sort, fragment lists arrive mostly in order)
+    int* order = (int*)malloc(count * sizeof(int));
+    if (order == NULL) {
+        printf("Memory allocation failed\n");
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        int j = i;
+        while (j > 0 && (fragments[order[j - 1]].header.flags_frag_offset & 0x1FFF) >
+                        (fragments[i].header.flags_frag_offset & 0x1FFF)) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    int expected_offset = 0;
+    int result = -1;
+    for (int k = 0; k < count; k++)
+    {
+        const ipv4_fragment* fragment = &fragments[order[k]];
+        int offset = (fragment->header.flags_frag_offset & 0x1FFF) * 8;
+        bool more = (fragment->header.flags_frag_offset & 0x2000) != 0;
+
+        if (offset != expected_offset || offset + fragment->data_size > capacity) {
+            break; //gap, overlap or too large
+        }
+
+        if (fragment->data != NULL) {
+            memcpy(out + offset, fragment->data, fragment->data_size);
+        } else {
+            materialize_payload(&fragment->content, out + offset, fragment->data_size);
+        }
+        expected_offset = offset + fragment->data_size;
+
+        if (!more) {
+            //the last fragment must really be the last one
+            result = (k == count - 1) ? expected_offset : -1;
+            break;
+        }
+    }
+
+    free(order);
+    return result;
+}
+
 uint16_t calculate_checksum(ipv4_header* header)
 {
-    /* Avoid unused parameter warning */
-    (void)header;
-    return 0xABCD;
+    //fields are kept in host order, so the 16-bit words are formed as they appear on the wire
+    uint32_t sum = ((uint32_t)header->version_ihl << 8 | header->tos) + header->total_len +
+                   header->identifier + header->flags_frag_offset +
+                   ((uint32_t)header->ttl << 8 | header->protocol) +
+                   (header->source_ip >> 16) + (header->source_ip & 0xFFFF) +
+                   (header->dest_ip >> 16) + (header->dest_ip & 0xFFFF);
+
+    //fold the carries back in (end-around carry) and complement
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum += sum >> 16;
+    return (uint16_t)~sum;
 }
 
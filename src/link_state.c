@@ -0,0 +1,845 @@
+/**
+ * link_state.c
+ * OSPF-like link-state routing: LSA flooding, per-router databases and throttled SPF
+ *
+ * A discrete-event simulation in microseconds. Routers originate a new
+ * router LSA (higher sequence number) when one of their links changes and
+ * flood it hop by hop. Every router keeps its own link-state database and
+ * routes only on what it has received. SPF runs are throttled with the
+ * usual initial delay / exponential hold scheme and, when few links
+ * changed, repair the previous shortest-path tree instead of rebuilding
+ * it. CPU cost is modelled, not measured, so results are reproducible.
+ * Each router handles events instantly at their scheduled time; queuing
+ * behind a busy CPU is not modelled.
+ *
+ * Originators flood an unchanged copy of their LSA every LSA_REFRESH_TIME,
+ * so copies never reach MaxAge while the originator is reachable. A
+ * periodic sweep drops copies that did (the originator was cut off) and
+ * reruns SPF. These timers only fire while a run processes changes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/link_state.h"
+
+typedef enum ls_event_type {
+    LS_EVENT_ORIGINATE,   // router changes its link to `peer` to `weight`
+    LS_EVENT_ARRIVAL,     // router receives `lsa` from `peer`
+    LS_EVENT_SPF,         // router runs its scheduled SPF
+    LS_EVENT_REFRESH,     // router floods a new instance of `lsa` if it is still its latest
+    LS_EVENT_AGE_SWEEP    // every database drops the LSAs that reached MaxAge
+} ls_event_type;
+
+struct ls_event {
+    ls_event_type type;
+    int        router;
+    int        peer;
+    int        weight;
+    int        age;
+    const lsa* lsa;
+    long long  time;
+    int        next_free;
+};
+
+// Events with the same time keep their scheduling order
+#define LS_SEQUENCE_BITS 20
+
+// Incremental SPF marks
+#define MARK_UNKNOWN 0
+#define MARK_INVALID 1
+#define MARK_VALID   2
+
+static void* checked_alloc(size_t size)
+{
+    void* memory = malloc(size > 0 ? size : 1);
+    if (memory == NULL) {
+        fprintf(stderr, "Memory allocation failed for link-state simulation\n");
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+void init_link_state_config(link_state_config* config)
+{
+    config->link_delay_us = 1000;
+    config->lsa_process_us = 50;
+    config->spf_initial_us = 50000;
+    config->spf_hold_us = 200000;
+    config->spf_max_wait_us = 5000000;
+    config->spf_unit_ns = 20.0;
+    config->incremental = true;
+}
+
+// ---------------------------------------------------------------------------
+// LSAs and adjacencies
+// ---------------------------------------------------------------------------
+
+static lsa* new_lsa(link_state_sim* sim, int originator, uint32_t sequence, int link_count)
+{
+    lsa* advert = (lsa*)checked_alloc(sizeof(lsa));
+    advert->originator = originator;
+    advert->sequence = sequence;
+    advert->link_count = link_count;
+    advert->links = (lsa_link*)checked_alloc(link_count * sizeof(lsa_link));
+    advert->next_allocated = sim->allocated;
+    sim->allocated = advert;
+    return advert;
+}
+
+static int compare_links(const void* a, const void* b)
+{
+    const lsa_link* x = (const lsa_link*)a;
+    const lsa_link* y = (const lsa_link*)b;
+    if (x->neighbor != y->neighbor) return x->neighbor < y->neighbor ? -1 : 1;
+    return x->cost < y->cost ? -1 : (x->cost > y->cost);
+}
+
+// First LSA of a node: its CSR edges sorted, without self loops, cheapest of parallel edges
+static const lsa* lsa_from_csr(link_state_sim* sim, csr_graph* graph, int node)
+{
+    int begin = graph->offsets[node];
+    int count = graph->offsets[node + 1] - begin;
+    lsa* advert = new_lsa(sim, node, 1, count);
+
+    for (int i = 0; i < count; i++) {
+        advert->links[i].neighbor = graph->targets[begin + i];
+        advert->links[i].cost = graph->weights[begin + i];
+    }
+    qsort(advert->links, count, sizeof(lsa_link), compare_links);
+
+    int kept = 0;
+    for (int i = 0; i < count; i++) {
+        if (advert->links[i].neighbor == node) continue;
+        if (kept > 0 && advert->links[kept - 1].neighbor == advert->links[i].neighbor) continue;
+        advert->links[kept++] = advert->links[i];
+    }
+    advert->link_count = kept;
+    return advert;
+}
+
+// Cost of the advertised link to neighbor, 0 if there is none
+static int lsa_cost(const lsa* advert, int neighbor)
+{
+    if (advert == NULL) return 0;
+
+    int low = 0, high = advert->link_count - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        if (advert->links[mid].neighbor == neighbor) return advert->links[mid].cost;
+        if (advert->links[mid].neighbor < neighbor) low = mid + 1;
+        else high = mid - 1;
+    }
+    return 0;
+}
+
+static int find_neighbor(const link_state_sim* sim, int node, int neighbor)
+{
+    for (int i = 0; i < sim->neighbor_count[node]; i++) {
+        if (sim->neighbors[node][i] == neighbor) return i;
+    }
+    return -1;
+}
+
+static void add_neighbor(link_state_sim* sim, int node, int neighbor)
+{
+    if (find_neighbor(sim, node, neighbor) >= 0) return;
+
+    if (sim->neighbor_count[node] == sim->neighbor_capacity[node]) {
+        sim->neighbor_capacity[node] = sim->neighbor_capacity[node] ? sim->neighbor_capacity[node] * 2 : 4;
+        sim->neighbors[node] = (int*)realloc(sim->neighbors[node], sim->neighbor_capacity[node] * sizeof(int));
+        if (sim->neighbors[node] == NULL) {
+            fprintf(stderr, "Memory allocation failed for link-state simulation\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    sim->neighbors[node][sim->neighbor_count[node]++] = neighbor;
+}
+
+static void remove_neighbor(link_state_sim* sim, int node, int neighbor)
+{
+    int index = find_neighbor(sim, node, neighbor);
+    if (index >= 0) {
+        sim->neighbors[node][index] = sim->neighbors[node][--sim->neighbor_count[node]];
+    }
+}
+
+static int entry_age(const lsdb_entry* entry, long long now)
+{
+    long long age = entry->install_age + (now - entry->install_time) / 1000000;
+    return age < LSA_MAX_AGE ? (int)age : LSA_MAX_AGE;
+}
+
+// RFC 2328 13.1: higher sequence wins, then an instance at MaxAge
+// Returns > 0 if (a, age_a) is newer than (b, age_b), 0 if they are the same instance
+static int compare_instances(const lsa* a, int age_a, const lsa* b, int age_b)
+{
+    if (b == NULL) return 1;
+    if (a->sequence != b->sequence) return a->sequence > b->sequence ? 1 : -1;
+    if ((age_a >= LSA_MAX_AGE) != (age_b >= LSA_MAX_AGE)) return age_a >= LSA_MAX_AGE ? 1 : -1;
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Event queue
+// ---------------------------------------------------------------------------
+
+static ls_event* schedule(link_state_sim* sim, long long time, ls_event_type type, int router)
+{
+    if (sim->free_event < 0) {
+        int old = sim->event_capacity;
+        sim->event_capacity = old ? old * 2 : 1024;
+        sim->events = (ls_event*)realloc(sim->events, sim->event_capacity * sizeof(ls_event));
+        if (sim->events == NULL) {
+            fprintf(stderr, "Memory allocation failed for link-state simulation\n");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = sim->event_capacity - 1; i >= old; i--) {
+            sim->events[i].next_free = sim->free_event;
+            sim->free_event = i;
+        }
+    }
+
+    int index = sim->free_event;
+    ls_event* event = &sim->events[index];
+    sim->free_event = event->next_free;
+
+    event->type = type;
+    event->router = router;
+    event->peer = -1;
+    event->weight = 0;
+    event->age = 0;
+    event->lsa = NULL;
+    event->time = time;
+
+    if (type != LS_EVENT_REFRESH && type != LS_EVENT_AGE_SWEEP) {
+        sim->change_events++;
+    }
+    long sequence = sim->event_sequence++ & ((1L << LS_SEQUENCE_BITS) - 1);
+    heap_push(&sim->queue, (time << LS_SEQUENCE_BITS) | sequence, index);
+    return event;
+}
+
+// Send a copy of an LSA from router to neighbor, leaving after local processing
+static void send_lsa(link_state_sim* sim, int router, int neighbor, const lsa* advert, int age)
+{
+    long long arrival = sim->now + sim->config.lsa_process_us + sim->config.link_delay_us;
+    ls_event* event = schedule(sim, arrival, LS_EVENT_ARRIVAL, neighbor);
+    event->peer = router;
+    event->lsa = advert;
+    event->age = (age + LSA_TRANSMIT_DELAY < LSA_MAX_AGE) ? age + LSA_TRANSMIT_DELAY : LSA_MAX_AGE;
+    sim->routers[router].stats.lsas_sent++;
+}
+
+static void flood(link_state_sim* sim, int router, const lsa* advert, int age, int except)
+{
+    for (int i = 0; i < sim->neighbor_count[router]; i++) {
+        if (sim->neighbors[router][i] != except) {
+            send_lsa(sim, router, sim->neighbors[router][i], advert, age);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SPF
+// ---------------------------------------------------------------------------
+
+// The originator's LSA as this router sees it, NULL if missing or aged out
+static const lsa* view_lsa(const link_state_sim* sim, const ls_router* router, int originator)
+{
+    const lsdb_entry* entry = &router->lsdb[originator];
+    if (entry->lsa == NULL || entry_age(entry, sim->now) >= LSA_MAX_AGE) {
+        return NULL;
+    }
+    return entry->lsa;
+}
+
+// Settle nodes from the heap, relaxing advertised links; returns the work done
+static long spf_settle(link_state_sim* sim, ls_router* router)
+{
+    long work = 0;
+    heap_entry top;
+
+    while (heap_pop(&sim->spf_heap, &top)) {
+        int u = top.value;
+        if (top.key > router->dist[u]) continue;  // stale entry
+        work++;
+
+        const lsa* advert = view_lsa(sim, router, u);
+        if (advert == NULL) continue;
+        for (int i = 0; i < advert->link_count; i++) {
+            int v = advert->links[i].neighbor;
+            long long candidate = (long long)router->dist[u] + advert->links[i].cost;
+            work++;
+            if (candidate < router->dist[v]) {
+                router->dist[v] = (int)candidate;
+                router->prev[v] = u;
+                heap_push(&sim->spf_heap, candidate, v);
+            }
+        }
+    }
+    return work;
+}
+
+static long full_spf(link_state_sim* sim, int source)
+{
+    ls_router* router = &sim->routers[source];
+    for (int v = 0; v < sim->node_count; v++) {
+        router->dist[v] = GRAPH_UNREACHABLE;
+        router->prev[v] = -1;
+    }
+    router->dist[source] = 0;
+    sim->spf_heap.size = 0;
+    heap_push(&sim->spf_heap, 0, source);
+    return spf_settle(sim, router);
+}
+
+// Resolve whether node hangs below an invalidated tree edge, compressing the walked chain
+static long resolve_mark(ls_router* router, char* mark, int node)
+{
+    long work = 0;
+    int top = node;
+    while (mark[top] == MARK_UNKNOWN && router->prev[top] >= 0) {
+        top = router->prev[top];
+        work++;
+    }
+    char result = (mark[top] == MARK_UNKNOWN) ? MARK_VALID : mark[top];
+    for (int v = node; mark[v] == MARK_UNKNOWN; v = router->prev[v]) {
+        mark[v] = result;
+        if (router->prev[v] < 0) break;
+    }
+    return work;
+}
+
+// Repair the previous tree after the pending link changes. Nodes below a tree
+// edge that got worse lose their distance and are re-attached from the rest of
+// the tree; links that got better are relaxed; one Dijkstra pass settles both.
+static long incremental_spf(link_state_sim* sim, int source)
+{
+    ls_router* router = &sim->routers[source];
+    char* mark = sim->scratch_mark;
+    int n = sim->node_count;
+    long work = 0;
+    bool invalidated = false;
+
+    memset(mark, MARK_UNKNOWN, n);
+    for (int i = 0; i < router->pending_count; i++) {
+        int u = router->pending[i].from;
+        int v = router->pending[i].to;
+        int cost = lsa_cost(view_lsa(sim, router, u), v);
+        if (router->prev[v] == u && (cost == 0 || (long long)router->dist[u] + cost > router->dist[v])) {
+            mark[v] = MARK_INVALID;
+            invalidated = true;
+        }
+    }
+
+    sim->spf_heap.size = 0;
+    if (invalidated) {
+        for (int v = 0; v < n; v++) {
+            work += resolve_mark(router, mark, v);
+        }
+        for (int v = 0; v < n; v++) {
+            if (mark[v] == MARK_INVALID) {
+                router->dist[v] = GRAPH_UNREACHABLE;
+                router->prev[v] = -1;
+            }
+        }
+        // Re-attach invalidated nodes to their best neighbor that kept its route
+        for (int u = 0; u < n; u++) {
+            if (mark[u] != MARK_VALID || router->dist[u] == GRAPH_UNREACHABLE) continue;
+            const lsa* advert = view_lsa(sim, router, u);
+            if (advert == NULL) continue;
+            for (int i = 0; i < advert->link_count; i++) {
+                int v = advert->links[i].neighbor;
+                long long candidate = (long long)router->dist[u] + advert->links[i].cost;
+                work++;
+                if (mark[v] == MARK_INVALID && candidate < router->dist[v]) {
+                    router->dist[v] = (int)candidate;
+                    router->prev[v] = u;
+                    heap_push(&sim->spf_heap, candidate, v);
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < router->pending_count; i++) {
+        int u = router->pending[i].from;
+        int v = router->pending[i].to;
+        int cost = lsa_cost(view_lsa(sim, router, u), v);
+        work++;
+        if (cost > 0 && router->dist[u] != GRAPH_UNREACHABLE &&
+            (long long)router->dist[u] + cost < router->dist[v]) {
+            router->dist[v] = router->dist[u] + cost;
+            router->prev[v] = u;
+            heap_push(&sim->spf_heap, router->dist[v], v);
+        }
+    }
+
+    return work + spf_settle(sim, router);
+}
+
+static void run_spf(link_state_sim* sim, int source)
+{
+    ls_router* router = &sim->routers[source];
+    long work;
+
+    // Many changes touch most of the tree anyway, a clean run is cheaper then
+    if (!sim->config.incremental || router->full_spf_needed ||
+        router->pending_count > 1 + sim->node_count / 8) {
+        work = full_spf(sim, source);
+        router->stats.spf_full++;
+    } else {
+        work = incremental_spf(sim, source);
+        router->stats.spf_incremental++;
+    }
+
+    double duration = work * sim->config.spf_unit_ns / 1000.0;
+    router->stats.spf_work += work;
+    router->stats.cpu_us += duration;
+    router->stats.converged_at = sim->now + (long long)duration;
+    router->pending_count = 0;
+    router->full_spf_needed = false;
+    router->spf_scheduled = false;
+    router->last_spf = sim->now;
+}
+
+// Schedule SPF after a database change: initial delay after a quiet period,
+// otherwise no sooner than the hold time after the last run, doubling the hold
+static void trigger_spf(link_state_sim* sim, int source)
+{
+    ls_router* router = &sim->routers[source];
+    if (router->spf_scheduled) {
+        return;  // the pending run picks this change up as well
+    }
+
+    const link_state_config* config = &sim->config;
+    long long at = sim->now + config->spf_initial_us;
+    if (router->last_spf < 0 || sim->now - router->last_spf >= 2 * config->spf_max_wait_us) {
+        router->hold_us = config->spf_hold_us;
+    } else {
+        if (router->last_spf + router->hold_us > at) at = router->last_spf + router->hold_us;
+        router->hold_us = (router->hold_us * 2 < config->spf_max_wait_us) ? router->hold_us * 2
+                                                                            : config->spf_max_wait_us;
+    }
+
+    router->spf_scheduled = true;
+    schedule(sim, at, LS_EVENT_SPF, source);
+}
+
+static void add_delta(ls_router* router, int from, int to)
+{
+    if (router->pending_count == router->pending_capacity) {
+        router->pending_capacity = router->pending_capacity ? router->pending_capacity * 2 : 16;
+        router->pending = (link_delta*)realloc(router->pending, router->pending_capacity * sizeof(link_delta));
+        if (router->pending == NULL) {
+            fprintf(stderr, "Memory allocation failed for link-state simulation\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    router->pending[router->pending_count].from = from;
+    router->pending[router->pending_count].to = to;
+    router->pending_count++;
+}
+
+// Put an LSA into a router's database and record which links it changed
+// Returns false for a refresh that advertises the same links, which needs no SPF
+static bool install_lsa(link_state_sim* sim, int index, const lsa* advert, int age)
+{
+    ls_router* router = &sim->routers[index];
+    lsdb_entry* entry = &router->lsdb[advert->originator];
+    const lsa* old = view_lsa(sim, router, advert->originator);
+    int pending = router->pending_count;
+
+    if (old == NULL || age >= LSA_MAX_AGE) {
+        router->full_spf_needed = true;
+    } else {
+        // Merge the two sorted link lists
+        int i = 0, j = 0;
+        while (i < old->link_count || j < advert->link_count) {
+            if (j == advert->link_count ||
+                (i < old->link_count && old->links[i].neighbor < advert->links[j].neighbor)) {
+                add_delta(router, advert->originator, old->links[i++].neighbor);
+            } else if (i == old->link_count || advert->links[j].neighbor < old->links[i].neighbor) {
+                add_delta(router, advert->originator, advert->links[j++].neighbor);
+            } else {
+                if (old->links[i].cost != advert->links[j].cost) {
+                    add_delta(router, advert->originator, advert->links[j].neighbor);
+                }
+                i++;
+                j++;
+            }
+        }
+    }
+
+    entry->lsa = advert;
+    entry->install_age = age;
+    entry->install_time = sim->now;
+    router->stats.lsas_installed++;
+    if (old != NULL && age < LSA_MAX_AGE && router->pending_count == pending) {
+        return false;
+    }
+    trigger_spf(sim, index);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Event handlers
+// ---------------------------------------------------------------------------
+
+static void schedule_refresh(link_state_sim* sim, int router, long long at)
+{
+    ls_event* event = schedule(sim, at, LS_EVENT_REFRESH, router);
+    event->lsa = sim->origin[router];
+}
+
+// Returns false if the link already had this weight and nothing was originated
+static bool originate(link_state_sim* sim, int router, int neighbor, int weight, long long* last_install)
+{
+    const lsa* old = sim->origin[router];
+    if (lsa_cost(old, neighbor) == weight) {
+        return false;  // nothing changed
+    }
+
+    int count = old->link_count + ((lsa_cost(old, neighbor) == 0) ? 1 : 0) - ((weight == 0) ? 1 : 0);
+    lsa* advert = new_lsa(sim, router, old->sequence + 1, count);
+    int k = 0;
+    bool placed = (weight == 0);
+    for (int i = 0; i < old->link_count; i++) {
+        if (!placed && neighbor < old->links[i].neighbor) {
+            advert->links[k].neighbor = neighbor;
+            advert->links[k++].cost = weight;
+            placed = true;
+        }
+        if (old->links[i].neighbor == neighbor) {
+            if (weight > 0) {
+                advert->links[k].neighbor = neighbor;
+                advert->links[k++].cost = weight;
+                placed = true;
+            }
+            continue;
+        }
+        advert->links[k++] = old->links[i];
+    }
+    if (!placed) {
+        advert->links[k].neighbor = neighbor;
+        advert->links[k++].cost = weight;
+    }
+
+    sim->origin[router] = advert;
+    if (weight > 0) {
+        add_neighbor(sim, router, neighbor);
+        add_neighbor(sim, neighbor, router);
+    } else if (lsa_cost(sim->origin[neighbor], router) == 0) {
+        remove_neighbor(sim, router, neighbor);
+        remove_neighbor(sim, neighbor, router);
+    }
+
+    install_lsa(sim, router, advert, 0);
+    *last_install = sim->now;
+    flood(sim, router, advert, 0, -1);
+    schedule_refresh(sim, router, sim->now + LSA_REFRESH_TIME * 1000000LL);
+    return true;
+}
+
+// Flood the same links under the next sequence number before the copies out there age out
+static void refresh(link_state_sim* sim, const ls_event* event)
+{
+    const lsa* old = sim->origin[event->router];
+    if (event->lsa != old) {
+        return;  // a change originated a newer instance, which scheduled its own refresh
+    }
+
+    lsa* advert = new_lsa(sim, event->router, old->sequence + 1, old->link_count);
+    memcpy(advert->links, old->links, old->link_count * sizeof(lsa_link));
+    sim->origin[event->router] = advert;
+    install_lsa(sim, event->router, advert, 0);
+    flood(sim, event->router, advert, 0, -1);
+    schedule_refresh(sim, event->router, sim->now + LSA_REFRESH_TIME * 1000000LL);
+}
+
+// Drop every copy that reached MaxAge; its links are gone, so the router reruns SPF
+static void age_sweep(link_state_sim* sim)
+{
+    for (int r = 0; r < sim->node_count; r++) {
+        ls_router* router = &sim->routers[r];
+        for (int o = 0; o < sim->node_count; o++) {
+            lsdb_entry* entry = &router->lsdb[o];
+            if (entry->lsa != NULL && entry_age(entry, sim->now) >= LSA_MAX_AGE) {
+                entry->lsa = NULL;
+                router->stats.lsas_flushed++;
+                router->full_spf_needed = true;
+                trigger_spf(sim, r);
+            }
+        }
+    }
+    schedule(sim, sim->now + LSA_AGE_SWEEP * 1000000LL, LS_EVENT_AGE_SWEEP, 0);
+}
+
+static void receive(link_state_sim* sim, const ls_event* event, long long* last_install)
+{
+    ls_router* router = &sim->routers[event->router];
+    router->stats.lsas_received++;
+    router->stats.cpu_us += sim->config.lsa_process_us;
+
+    const lsa* advert = event->lsa;
+    lsdb_entry* entry = &router->lsdb[advert->originator];
+    int current_age = (entry->lsa != NULL) ? entry_age(entry, sim->now) : 0;
+    int order = compare_instances(advert, event->age, entry->lsa, current_age);
+
+    if (order > 0) {
+        if (install_lsa(sim, event->router, advert, event->age)) {
+            *last_install = sim->now;
+        }
+        flood(sim, event->router, advert, event->age, event->peer);
+    } else if (order == 0) {
+        router->stats.duplicates++;
+    } else {
+        // The sender is behind, give it our newer copy
+        send_lsa(sim, event->router, event->peer, entry->lsa, current_age);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Public interface
+// ---------------------------------------------------------------------------
+
+void link_state_init(link_state_sim* sim, csr_graph* graph, const link_state_config* config)
+{
+    int n = graph->node_count;
+    memset(sim, 0, sizeof(*sim));
+    sim->config = *config;
+    sim->node_count = n;
+    sim->free_event = -1;
+
+    sim->routers = (ls_router*)calloc(n, sizeof(ls_router));
+    sim->origin = (const lsa**)calloc(n, sizeof(lsa*));
+    sim->neighbors = (int**)calloc(n, sizeof(int*));
+    sim->neighbor_count = (int*)calloc(n, sizeof(int));
+    sim->neighbor_capacity = (int*)calloc(n, sizeof(int));
+    sim->scratch_mark = (char*)checked_alloc(n);
+    if (sim->routers == NULL || sim->origin == NULL || sim->neighbors == NULL ||
+        sim->neighbor_count == NULL || sim->neighbor_capacity == NULL) {
+        fprintf(stderr, "Memory allocation failed for link-state simulation\n");
+        exit(EXIT_FAILURE);
+    }
+    heap_init(&sim->queue, 1024);
+    heap_init(&sim->spf_heap, n > 16 ? n : 16);
+
+    for (int u = 0; u < n; u++) {
+        sim->origin[u] = lsa_from_csr(sim, graph, u);
+        for (int i = 0; i < sim->origin[u]->link_count; i++) {
+            add_neighbor(sim, u, sim->origin[u]->links[i].neighbor);
+            add_neighbor(sim, sim->origin[u]->links[i].neighbor, u);
+        }
+    }
+
+    // Start converged: every database is complete and every router has its tree
+    for (int r = 0; r < n; r++) {
+        ls_router* router = &sim->routers[r];
+        router->lsdb = (lsdb_entry*)checked_alloc(n * sizeof(lsdb_entry));
+        router->dist = (int*)checked_alloc(n * sizeof(int));
+        router->prev = (int*)checked_alloc(n * sizeof(int));
+        for (int o = 0; o < n; o++) {
+            router->lsdb[o].lsa = sim->origin[o];
+            router->lsdb[o].install_age = 0;
+            router->lsdb[o].install_time = 0;
+        }
+        full_spf(sim, r);
+        router->last_spf = -1;
+        router->hold_us = config->spf_hold_us;
+        router->stats.converged_at = -1;
+    }
+
+    // First refreshes spread over one refresh period rather than all at once
+    for (int u = 0; u < n; u++) {
+        schedule_refresh(sim, u, LSA_REFRESH_TIME * 1000000LL * (u + 1) / n);
+    }
+    schedule(sim, LSA_AGE_SWEEP * 1000000LL, LS_EVENT_AGE_SWEEP, 0);
+}
+
+void link_state_init_network(link_state_sim* sim, network_topology* network, const link_state_config* config)
+{
+    csr_graph graph;
+    csr_from_topology(&graph, network);
+    link_state_init(sim, &graph, config);
+    csr_free(&graph);
+}
+
+void link_state_free(link_state_sim* sim)
+{
+    for (int r = 0; r < sim->node_count; r++) {
+        free(sim->routers[r].lsdb);
+        free(sim->routers[r].dist);
+        free(sim->routers[r].prev);
+        free(sim->routers[r].pending);
+        free(sim->neighbors[r]);
+    }
+    while (sim->allocated != NULL) {
+        lsa* next = sim->allocated->next_allocated;
+        free(sim->allocated->links);
+        free(sim->allocated);
+        sim->allocated = next;
+    }
+    free(sim->routers);
+    free(sim->origin);
+    free(sim->neighbors);
+    free(sim->neighbor_count);
+    free(sim->neighbor_capacity);
+    free(sim->events);
+    free(sim->scratch_mark);
+    heap_free(&sim->queue);
+    heap_free(&sim->spf_heap);
+    memset(sim, 0, sizeof(*sim));
+}
+
+int link_state_change_link(link_state_sim* sim, long long delay_us, int from, int to, int weight)
+{
+    if (from < 0 || from >= sim->node_count || to < 0 || to >= sim->node_count || from == to ||
+        weight < 0 || delay_us < 0) {
+        return -1;
+    }
+
+    ls_event* event = schedule(sim, sim->now + delay_us, LS_EVENT_ORIGINATE, from);
+    event->peer = to;
+    event->weight = weight;
+    return 0;
+}
+
+int link_state_sync(link_state_sim* sim, network_topology* network, long long delay_us)
+{
+    int changes = 0;
+    for (int u = 0; u < network->node_count && u < sim->node_count; u++) {
+        for (int v = 0; v < network->node_count && v < sim->node_count; v++) {
+            if (u != v && lsa_cost(sim->origin[u], v) != network->graph[u][v]) {
+                link_state_change_link(sim, delay_us, u, v, network->graph[u][v]);
+                changes++;
+            }
+        }
+    }
+    return changes;
+}
+
+void link_state_run(link_state_sim* sim, ls_report* report)
+{
+    memset(report, 0, sizeof(*report));
+    for (int r = 0; r < sim->node_count; r++) {
+        memset(&sim->routers[r].stats, 0, sizeof(ls_router_stats));
+        sim->routers[r].stats.converged_at = -1;
+    }
+
+    // Timers stay queued for later runs once no change is left to process
+    long long start = -1;
+    long long last_install = -1;
+    heap_entry top;
+    while (sim->change_events > 0 && heap_pop(&sim->queue, &top)) {
+        ls_event event = sim->events[top.value];
+        sim->events[top.value].next_free = sim->free_event;
+        sim->free_event = top.value;
+
+        sim->now = event.time;
+        if (event.type != LS_EVENT_REFRESH && event.type != LS_EVENT_AGE_SWEEP) {
+            sim->change_events--;
+        }
+
+        switch (event.type) {
+            case LS_EVENT_ORIGINATE:
+                // Changes that leave the link as it was originate nothing and start no clock
+                if (originate(sim, event.router, event.peer, event.weight, &last_install) && start < 0) {
+                    start = event.time;
+                }
+                break;
+            case LS_EVENT_ARRIVAL:
+                receive(sim, &event, &last_install);
+                break;
+            case LS_EVENT_SPF:
+                run_spf(sim, event.router);
+                break;
+            case LS_EVENT_REFRESH:
+                refresh(sim, &event);
+                break;
+            case LS_EVENT_AGE_SWEEP:
+                age_sweep(sim);
+                break;
+        }
+    }
+    if (start < 0) start = sim->now;
+    if (last_install < start) last_install = start;
+
+    report->start_us = start;
+    report->flooding_us = last_install - start;
+    report->convergence_us = 0;
+    report->busiest_router = 0;
+    double cpu_total = 0;
+    for (int r = 0; r < sim->node_count; r++) {
+        const ls_router_stats* stats = &sim->routers[r].stats;
+        report->lsa_messages += stats->lsas_sent;
+        report->spf_full += stats->spf_full;
+        report->spf_incremental += stats->spf_incremental;
+        report->total_work += stats->spf_work;
+        cpu_total += stats->cpu_us;
+
+        if (stats->converged_at >= 0 && stats->converged_at - start > report->convergence_us) {
+            report->convergence_us = stats->converged_at - start;
+            if (stats->converged_at > sim->now) sim->now = stats->converged_at;
+        }
+        if (stats->spf_work > report->max_router_work) {
+            report->max_router_work = stats->spf_work;
+            report->busiest_router = r;
+        }
+        if (stats->cpu_us > report->max_router_cpu_us) {
+            report->max_router_cpu_us = stats->cpu_us;
+        }
+    }
+    report->mean_router_cpu_us = sim->node_count > 0 ? cpu_total / sim->node_count : 0;
+}
+
+int link_state_lsa_age(const link_state_sim* sim, int router, int originator)
+{
+    if (router < 0 || router >= sim->node_count || originator < 0 || originator >= sim->node_count) {
+        return -1;
+    }
+    const lsdb_entry* entry = &sim->routers[router].lsdb[originator];
+    return (entry->lsa != NULL) ? entry_age(entry, sim->now) : -1;
+}
+
+bool link_state_verify(link_state_sim* sim)
+{
+    int n = sim->node_count;
+    int edges = 0;
+    for (int u = 0; u < n; u++) {
+        edges += sim->origin[u]->link_count;
+    }
+
+    // The true topology is what every originator last advertised
+    csr_graph graph;
+    graph.node_count = n;
+    graph.edge_count = edges;
+    graph.offsets = (int*)checked_alloc((n + 1) * sizeof(int));
+    graph.targets = (int*)checked_alloc(edges * sizeof(int));
+    graph.weights = (int*)checked_alloc(edges * sizeof(int));
+    graph.max_weight = 0;
+    int e = 0;
+    for (int u = 0; u < n; u++) {
+        graph.offsets[u] = e;
+        for (int i = 0; i < sim->origin[u]->link_count; i++) {
+            graph.targets[e] = sim->origin[u]->links[i].neighbor;
+            graph.weights[e] = sim->origin[u]->links[i].cost;
+            if (graph.weights[e] > graph.max_weight) graph.max_weight = graph.weights[e];
+            e++;
+        }
+    }
+    graph.offsets[n] = e;
+
+    int* dist = (int*)checked_alloc(n * sizeof(int));
+    int* prev = (int*)checked_alloc(n * sizeof(int));
+    bool correct = true;
+    for (int r = 0; r < n && correct; r++) {
+        dijkstra_csr(&graph, r, dist, prev);
+        correct = memcmp(dist, sim->routers[r].dist, n * sizeof(int)) == 0;
+    }
+
+    free(dist);
+    free(prev);
+    csr_free(&graph);
+    return correct;
+}
@@ -0,0 +1,227 @@
+/**
+ * lpm.c
+ * Longest-prefix-match table using the DIR-24-8 layout
+ *
+ * A lookup costs one tbl24 read, plus one tbl8 read for the few addresses
+ * covered by prefixes longer than /24. Every entry records the length of
+ * the prefix that wrote it, so a shorter prefix added later never
+ * overwrites a longer one and routes can be added in any order.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/lpm.h"
+
+#define ENTRY_VALID       0x80000000u
+#define ENTRY_GROUP       0x40000000u
+#define ENTRY_DEPTH_SHIFT 24
+#define ENTRY_DEPTH_MASK  0x3Fu
+#define ENTRY_VALUE_MASK  0x00FFFFFFu
+
+static uint32_t make_entry(int length, uint32_t next_hop)
+{
+    return ENTRY_VALID | ((uint32_t)length << ENTRY_DEPTH_SHIFT) | next_hop;
+}
+
+// True if a prefix of `length` may overwrite the entry
+static bool can_overwrite(uint32_t entry, int length)
+{
+    return !(entry & ENTRY_VALID) ||
+           (int)((entry >> ENTRY_DEPTH_SHIFT) & ENTRY_DEPTH_MASK) <= length;
+}
+
+static uint32_t alloc_group(lpm_table* table, uint32_t fill)
+{
+    if (table->tbl8_groups == table->tbl8_capacity) {
+        table->tbl8_capacity = table->tbl8_capacity ? table->tbl8_capacity * 2 : 256;
+        table->tbl8 = (uint32_t*)realloc(table->tbl8,
+                                         (size_t)table->tbl8_capacity * LPM_TBL8_ENTRIES * sizeof(uint32_t));
+        if (table->tbl8 == NULL) {
+            fprintf(stderr, "Memory allocation failed for LPM table\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // The group inherits whatever the /24 entry it replaces resolved to
+    uint32_t group = table->tbl8_groups++;
+    uint32_t* entries = &table->tbl8[(size_t)group * LPM_TBL8_ENTRIES];
+    for (int i = 0; i < LPM_TBL8_ENTRIES; i++) {
+        entries[i] = fill;
+    }
+    return group;
+}
+
+void lpm_init(lpm_table* table)
+{
+    table->tbl24 = (uint32_t*)calloc(LPM_TBL24_ENTRIES, sizeof(uint32_t));
+    if (table->tbl24 == NULL) {
+        fprintf(stderr, "Memory allocation failed for LPM table\n");
+        exit(EXIT_FAILURE);
+    }
+    table->tbl8 = NULL;
+    table->tbl8_groups = 0;
+    table->tbl8_capacity = 0;
+    table->route_count = 0;
+}
+
+void lpm_free(lpm_table* table)
+{
+    free(table->tbl24);
+    free(table->tbl8);
+    table->tbl24 = NULL;
+    table->tbl8 = NULL;
+    table->tbl8_groups = 0;
+    table->tbl8_capacity = 0;
+    table->route_count = 0;
+}
+
+int lpm_add(lpm_table* table, uint32_t prefix, int length, uint32_t next_hop)
+{
+    if (length < 0 || length > 32 || next_hop > LPM_MAX_NEXT_HOP) {
+        return -1;
+    }
+
+    uint32_t mask = (length == 0) ? 0 : 0xFFFFFFFFu << (32 - length);
+    prefix &= mask;
+    uint32_t entry = make_entry(length, next_hop);
+
+    if (length <= 24) {
+        uint32_t start = prefix >> 8;
+        uint32_t count = 1u << (24 - length);
+
+        for (uint32_t i = start; i < start + count; i++) {
+            uint32_t current = table->tbl24[i];
+            if (current & ENTRY_GROUP) {
+                uint32_t* group = &table->tbl8[(size_t)(current & ENTRY_VALUE_MASK) * LPM_TBL8_ENTRIES];
+                for (int j = 0; j < LPM_TBL8_ENTRIES; j++) {
+                    if (can_overwrite(group[j], length)) group[j] = entry;
+                }
+            } else if (can_overwrite(current, length)) {
+                table->tbl24[i] = entry;
+            }
+        }
+    } else {
+        uint32_t index = prefix >> 8;
+        if (!(table->tbl24[index] & ENTRY_GROUP)) {
+            uint32_t group = alloc_group(table, table->tbl24[index]);
+            table->tbl24[index] = ENTRY_VALID | ENTRY_GROUP | group;
+        }
+
+        uint32_t* group = &table->tbl8[(size_t)(table->tbl24[index] & ENTRY_VALUE_MASK) * LPM_TBL8_ENTRIES];
+        uint32_t start = prefix & 0xFF;
+        uint32_t count = 1u << (32 - length);
+        for (uint32_t j = start; j < start + count; j++) {
+            if (can_overwrite(group[j], length)) group[j] = entry;
+        }
+    }
+
+    table->route_count++;
+    return 0;
+}
+
+uint32_t lpm_lookup(const lpm_table* table, uint32_t address)
+{
+    uint32_t entry = table->tbl24[address >> 8];
+    if (entry & ENTRY_GROUP) {
+        entry = table->tbl8[(size_t)(entry & ENTRY_VALUE_MASK) * LPM_TBL8_ENTRIES + (address & 0xFF)];
+    }
+    return (entry & ENTRY_VALID) ? (entry & ENTRY_VALUE_MASK) : LPM_NO_ROUTE;
+}
+
+void lpm_lookup_batch(const lpm_table* table, const uint32_t* addresses, uint32_t* next_hops, int count)
+{
+    // Prefetch a few lookups ahead so independent tbl24 misses overlap
+    const int ahead = 8;
+    for (int i = 0; i < count; i++) {
+        if (i + ahead < count) {
+            __builtin_prefetch(&table->tbl24[addresses[i + ahead] >> 8]);
+        }
+        next_hops[i] = lpm_lookup(table, addresses[i]);
+    }
+}
+
+int lpm_load_routes(const char* path, lpm_route** routes)
+{
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    int capacity = 1024;
+    int count = 0;
+    *routes = (lpm_route*)malloc(capacity * sizeof(lpm_route));
+    if (*routes == NULL) {
+        fprintf(stderr, "Memory allocation failed for routes\n");
+        exit(EXIT_FAILURE);
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        unsigned int a, b, c, d, next_hop;
+        int length;
+        if (line[0] == '#' ||
+            sscanf(line, "%u.%u.%u.%u/%d %u", &a, &b, &c, &d, &length, &next_hop) != 6 ||
+            a > 255 || b > 255 || c > 255 || d > 255 || length < 0 || length > 32 ||
+            next_hop > LPM_MAX_NEXT_HOP) {
+            continue;
+        }
+
+        if (count == capacity) {
+            capacity *= 2;
+            *routes = (lpm_route*)realloc(*routes, capacity * sizeof(lpm_route));
+            if (*routes == NULL) {
+                fprintf(stderr, "Memory allocation failed for routes\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        (*routes)[count].prefix = (a << 24) | (b << 16) | (c << 8) | d;
+        (*routes)[count].length = (uint8_t)length;
+        (*routes)[count].next_hop = next_hop;
+        count++;
+    }
+
+    fclose(file);
+    return count;
+}
+
+void lpm_generate_routes(lpm_route** routes, int count, int next_hop_count, unsigned int seed)
+{
+    *routes = (lpm_route*)malloc((count > 0 ? count : 1) * sizeof(lpm_route));
+    if (*routes == NULL) {
+        fprintf(stderr, "Memory allocation failed for routes\n");
+        exit(EXIT_FAILURE);
+    }
+    if (next_hop_count < 1) next_hop_count = 1;
+
+    unsigned int state = seed ? seed : 0x9E3779B9u;
+    for (int i = 0; i < count; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        unsigned int pick = state % 1000;
+
+        // Roughly the prefix-length histogram of a full Internet table
+        int length;
+        if (pick < 600) length = 24;
+        else if (pick < 700) length = 23;
+        else if (pick < 800) length = 22;
+        else if (pick < 850) length = 21;
+        else if (pick < 900) length = 20;
+        else if (pick < 930) length = 19;
+        else if (pick < 960) length = 16 + (int)(state >> 12) % 3;
+        else if (pick < 990) length = 8 + (int)(state >> 12) % 8;
+        else length = 25 + (int)(state >> 12) % 8;
+
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        // Unicast space only: first octet 1..223
+        uint32_t address = ((1 + state % 223) << 24) | ((state >> 8) & 0x00FFFFFFu);
+
+        (*routes)[i].prefix = address & (0xFFFFFFFFu << (32 - length));
+        (*routes)[i].length = (uint8_t)length;
+        (*routes)[i].next_hop = (state >> 4) % next_hop_count;
+    }
+}
@@ -1,23 +1,244 @@
+#include <fcntl.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
-#include "../include/dijkstra.h"
+#include "../include/bench.h"
+#include "../include/fast_reroute.h"
+#include "../include/forwarding.h"
 #include "../include/ipv4.h"
+#include "../include/link_state.h"
+#include "../include/mtu_sweep.h"
 #include "../include/network.h"
+#include "../include/queue_sim.h"
+#include "../include/traffic.h"
 #include "../include/ui.h"
 
-int main() {
+// Traffic generation mode:
+// network_sim --traffic [count] [imix|uniform|heavy] [mtu] [real|virtual] [output_file]
+static int run_traffic_mode(int argc, char* argv[]) {
+  network_topology network;
+  traffic_config config;
+  traffic_report report;
+
+  init_traffic_config(&config);
+  if (argc > 2) config.datagram_count = atol(argv[2]);
+  if (argc > 3 && !parse_flow_mix(argv[3], &config.mix)) {
+    printf("Unknown flow mix '%s' (expected imix, uniform or heavy)\n",
+           argv[3]);
+    return EXIT_FAILURE;
+  }
+  if (argc > 4) config.mtu = atoi(argv[4]);
+  if (argc > 5) config.virtual_payload = (strcmp(argv[5], "virtual") == 0);
+  if (argc > 6) {
+    config.output_fd = open(argv[6], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (config.output_fd < 0) {
+      printf("Cannot open output file %s\n", argv[6]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  create_test_topology(&network);
+  int status = run_traffic_pipeline(&network, &config, &report);
+  if (config.output_fd >= 0) close(config.output_fd);
+  if (status != 0) {
+    return EXIT_FAILURE;
+  }
+  display_traffic_report(&config, &report);
+  return report.output_error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// MTU sweep mode:
+// network_sim --mtu-sweep [csv_file] [mtu_min] [mtu_max] [threads]
+static int run_mtu_sweep_mode(int argc, char* argv[]) {
+  mtu_sweep_config config;
+  mtu_sweep_result result;
+
+  init_mtu_sweep_config(&config);
+  if (argc > 3) config.mtu_min = atoi(argv[3]);
+  if (argc > 4) config.mtu_max = atoi(argv[4]);
+  if (argc > 5) config.threads = atoi(argv[5]);
+
+  if (run_mtu_sweep(&config, &result) != 0) {
+    printf("Invalid sweep range (MTU must be %d..%d)\n", IPV4_HEADER_SIZE + 8,
+           MAX_IPV4_PACKET_SIZE);
+    return EXIT_FAILURE;
+  }
+  display_mtu_sweep(&result);
+
+  const int samples = 2000;
+  int mismatches = mtu_sweep_verify(&result, samples, 42);
+  printf("\nCross-check against fragment_ipv4_packet(): %d/%d samples agree\n",
+         samples - mismatches, samples);
+
+  int status = (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+  if (argc > 2) {
+    if (mtu_sweep_write_csv(&result, argv[2]) == 0) {
+      printf("Wrote %d rows to %s\n", result.mtu_count * result.payload_bins,
+             argv[2]);
+    } else {
+      printf("Could not write %s\n", argv[2]);
+      status = EXIT_FAILURE;
+    }
+  }
+  mtu_sweep_free(&result);
+  return status;
+}
+
+// Congestion mode, sweeping common MTUs on the test topology:
+// network_sim --queue-sim [tail|red|fq|all] [load] [payload] [buffer_bytes]
+static int run_queue_sim_mode(int argc, char* argv[]) {
+  network_topology network;
+  queue_sim_config config;
+  queue_sim_report report;
+  const int mtus[] = {576, 1006, 1280, 1500, 4352, 9000};
+  queue_policy policies[] = {QUEUE_TAIL_DROP, QUEUE_RED, QUEUE_FAIR};
+  int policy_count = 3;
+
+  init_queue_sim_config(&config);
+  if (argc > 2 && strcmp(argv[2], "all") != 0) {
+    if (!parse_queue_policy(argv[2], &policies[0])) {
+      printf("Unknown queue policy '%s' (expected tail, red, fq or all)\n",
+             argv[2]);
+      return EXIT_FAILURE;
+    }
+    policy_count = 1;
+  }
+  if (argc > 3) config.offered_load = atof(argv[3]);
+  if (argc > 4) config.payload_size = atoi(argv[4]);
+  if (argc > 5) config.buffer_bytes = atoi(argv[5]);
+
+  create_test_topology(&network);
+  printf("\n=== Congestion vs MTU ===\n");
+  printf("Payload %d bytes, offered load %.2f of %.0f Mb/s links, %d byte "
+         "buffers\n\n",
+         config.payload_size, config.offered_load, config.bandwidth_bps / 1e6,
+         config.buffer_bytes);
+
+  bool header = true;
+  for (int p = 0; p < policy_count; p++) {
+    config.policy = policies[p];
+    for (size_t i = 0; i < sizeof(mtus) / sizeof(mtus[0]); i++) {
+      config.mtu = mtus[i];
+      if (run_queue_sim(&network, &config, &report) != 0) {
+        printf("Invalid congestion settings\n");
+        return EXIT_FAILURE;
+      }
+      display_queue_sim_report(&config, &report, header);
+      header = false;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+// After links were removed interactively: what the fragments in flight would
+// have suffered while routers reconverged, with and without precomputed backups
+static void report_fast_reroute(network_topology* before, network_topology* after,
+                                const link_state_config* ls_config) {
+  link_delta removed[MAX_NODES * MAX_NODES];
+  int removed_count = 0;
+  for (int u = 0; u < before->node_count; u++) {
+    for (int v = 0; v < before->node_count; v++) {
+      if (before->graph[u][v] > 0 && after->graph[u][v] == 0) {
+        removed[removed_count].from = u;
+        removed[removed_count].to = v;
+        removed_count++;
+      }
+    }
+  }
+  if (removed_count == 0) return;
+
+  csr_graph graph;
+  frr_sim_config config;
+  frr_sim_report report;
+  csr_from_topology(&graph, before);
+  init_frr_sim_config(&config);
+  config.link_state = *ls_config;
+  if (frr_simulate_failure(&graph, removed, removed_count, &config, &report) == 0) {
+    display_frr_report(&report);
+    long results[] = {report.unprotected.delivered, report.fast_reroute.delivered,
+                      report.fast_reroute.repaired};
+    session_digest(results, sizeof(results));
+  }
+  csr_free(&graph);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc > 1 && strcmp(argv[1], "--traffic") == 0) {
+    return run_traffic_mode(argc, argv);
+  }
+  if (argc > 1 && strcmp(argv[1], "--mtu-sweep") == 0) {
+    return run_mtu_sweep_mode(argc, argv);
+  }
+  if (argc > 1 && strcmp(argv[1], "--queue-sim") == 0) {
+    return run_queue_sim_mode(argc, argv);
+  }
+  if (argc > 1 && strcmp(argv[1], "--bench-sssp") == 0) {
+    return run_sssp_benchmark(argc, argv);
+  }
+  if (argc > 1 && strcmp(argv[1], "--bench-rcu") == 0) {
+    return run_rcu_benchmark(argc, argv);
+  }
+  if (argc > 1 && strcmp(argv[1], "--bench-lpm") == 0) {
+    return run_lpm_benchmark(argc, argv);
+  }
+  if (argc > 1 && strcmp(argv[1], "--bench-routes") == 0) {
+    return run_route_benchmark(argc, argv);
+  }
+  if (argc > 1 && strcmp(argv[1], "--bench-link-state") == 0) {
+    return run_link_state_benchmark(argc, argv);
+  }
+  if (argc > 1 && strcmp(argv[1], "--bench-snapshot") == 0) {
+    return run_snapshot_benchmark(argc, argv);
+  }
+  if (argc > 1 && strcmp(argv[1], "--bench-headers") == 0) {
+    return run_header_benchmark(argc, argv);
+  }
+  if (argc > 1 && strcmp(argv[1], "--bench-wire") == 0) {
+    return run_wire_benchmark(argc, argv);
+  }
+  if (argc > 1 && strcmp(argv[1], "--bench-dense") == 0) {
+    return run_dense_benchmark(argc, argv);
+  }
+  if (argc > 1 && strcmp(argv[1], "--bench-multicast") == 0) {
+    return run_multicast_benchmark(argc, argv);
+  }
+  if (argc > 1 && strcmp(argv[1], "--bench-frr") == 0) {
+    return run_frr_benchmark(argc, argv);
+  }
+  if (argc > 1 && strcmp(argv[1], "--bench-txn") == 0) {
+    return run_txn_benchmark(argc, argv);
+  }
+
+  // Interactive session recorded to, or replayed without prompts from, a log:
+  // network_sim --record session.log | --replay session.log
+  bool session = false;
+  if (argc > 2 && (strcmp(argv[1], "--record") == 0 ||
+                   strcmp(argv[1], "--replay") == 0)) {
+    int opened = (strcmp(argv[1], "--record") == 0)
+                     ? session_record_start(argv[2])
+                     : session_replay_start(argv[2]);
+    if (opened != 0) {
+      printf("Cannot open session log %s\n", argv[2]);
+      return EXIT_FAILURE;
+    }
+    session = true;
+  }
+
   network_topology network;
   int source, dest, mtu, payload_size;
 
   display_welcome_banner();
   get_network_topology(&network);
+  session_topology(&network);
   display_network_topology(&network);
   get_user_inputs(&network, &source, &dest, &mtu, &payload_size);
 
   ipv4_packet packet;
-  create_ipv4_packet(&packet, source, dest, payload_size);
+  create_ipv4_packet(&packet, node_address(source), node_address(dest),
+                     payload_size);
 
   printf("===Original Packet Detsails====");
   display_packet_info(&packet);
@@ -25,18 +246,44 @@ int main() {
   ipv4_fragment* fragments;
   int num_frag = fragment_ipv4_packet(&packet, mtu, &fragments);
 
+  // Every router forwards by longest-prefix match on the destination address;
+  // fragments share the source's shortest-path tree instead of owning a path.
+  // The next hops come from the cache's trees, so every router's tree stays
+  // current and an edit only recomputes the trees it affects
+  forwarding_plane plane;
+  forwarding_build(&plane, &network);
+  route_cache routes;
+  route_cache_init(&routes, &network);
+  forwarding_update(&plane, &routes);
+
+  // Routers learn topology changes through LSA flooding
+  link_state_config ls_config;
+  link_state_sim link_state;
+  init_link_state_config(&ls_config);
+  link_state_init_network(&link_state, &network, &ls_config);
+
   printf("\n=== Fragmentation Results ===\n");
   printf("Number of fragments: %d\n\n", num_frag);
 
   for (int i = 0; i < num_frag; i++) {
+    session_set_phase(SESSION_PHASE_ROUTING);
     printf("Fragment: %d", i + 1);
 
-    fragments[i].path_length =
-        dijkstra(&network, source, dest, &(fragments[i].path));
+    int egress = forwarding_egress(&plane, source, fragments[i].header.dest_ip);
+    fragments[i].route = (egress < 0) ? ROUTE_HANDLE_NONE
+                                      : route_cache_lookup(&routes, source, egress);
 
     display_fragment_info(&fragments[i], num_frag);
 
-    display_route_path(&fragments[i]);
+    display_route_path(&routes, &fragments[i]);
+
+    int* path = NULL;
+    int path_length = route_expand_path(&routes, fragments[i].route, &path);
+    session_digest(&fragments[i].header, sizeof(fragments[i].header));
+    if (path_length > 0) {
+      session_digest(path, path_length * sizeof(int));
+      free(path);
+    }
 
     printf("\n");
 
@@ -46,16 +293,64 @@ int main() {
         "fragment? (y/n): ");
 
     char response;
-    scanf(" %c", &response);
+    session_read_char(&response);
     if (response == 'y' || response == 'Y') {
-      modify_network_topology(&network);
+      session_set_phase(SESSION_PHASE_TOPOLOGY);
+      network_topology before = network;
+      modify_network_topology(&network, &routes);
+      forwarding_update(&plane, &routes);
+      session_topology(&network);
       display_network_topology(&network);
+      report_fast_reroute(&before, &network, &ls_config);
+
+      // Edits are far apart in real time, so each one starts from a quiet network
+      if (link_state_sync(&link_state, &network,
+                          2 * ls_config.spf_max_wait_us) > 0) {
+        ls_report ls_result;
+        link_state_run(&link_state, &ls_result);
+        display_link_state_report(&link_state, &ls_result, 0);
+        long long results[] = {ls_result.convergence_us, ls_result.lsa_messages,
+                               ls_result.total_work};
+        session_digest(results, sizeof(results));
+      }
     }
   }
   for (int i = 0; i < num_frag; i++) {
-    free(fragments[i].path);
+    route_cache_release(&routes, fragments[i].route);
   }
   free(fragments);
+  route_cache_free(&routes);
+  forwarding_free(&plane);
+  link_state_free(&link_state);
 
+  // How the chosen MTU fares when links are congested
+  session_set_phase(SESSION_PHASE_CONGESTION);
+  queue_sim_config queue_config;
+  queue_sim_report queue_report;
+  init_queue_sim_config(&queue_config);
+  queue_config.mtu = mtu;
+  queue_config.payload_size = payload_size;
+
+  printf("\n=== Congestion at MTU %d ===\n", mtu);
+  printf("Offered load %.2f of %.0f Mb/s links, %d byte buffers\n\n",
+         queue_config.offered_load, queue_config.bandwidth_bps / 1e6,
+         queue_config.buffer_bytes);
+  for (int p = QUEUE_TAIL_DROP; p <= QUEUE_FAIR; p++) {
+    queue_config.policy = (queue_policy)p;
+    if (run_queue_sim(&network, &queue_config, &queue_report) == 0) {
+      display_queue_sim_report(&queue_config, &queue_report, p == QUEUE_TAIL_DROP);
+      long long results[] = {queue_report.datagrams_delivered,
+                             queue_report.fragments_dropped,
+                             queue_report.wire_bytes};
+      session_digest(results, sizeof(results));
+    }
+  }
+
+  if (session) {
+    session_report session_result;
+    int status = session_finish(&session_result);
+    display_session_report(&session_result);
+    return (status == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
   return 0;
 }
@@ -0,0 +1,263 @@
+/**
+ * mtu_sweep.c
+ * Fragmentation overhead for every (MTU, payload size) pair without building packets
+ *
+ * For a fixed MTU the fragment count is a step function of the payload size:
+ * one fragment up to mtu - 20 bytes, then k fragments for payloads in
+ * ((k - 1) * per, k * per] where per is the 8-byte aligned room per fragment.
+ * The sweep walks these runs instead of single payload sizes, so each run
+ * costs one division and a closed-form sum however many sizes it covers,
+ * and no packet or payload memory is touched.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "../include/mtu_sweep.h"
+
+typedef struct sweep_worker {
+    mtu_sweep_result* result;
+    int first;    // first MTU index handled by this worker
+    int stride;   // worker count; MTUs are interleaved so small MTUs are spread out
+} sweep_worker;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void init_mtu_sweep_config(mtu_sweep_config* config)
+{
+    config->mtu_min = MTU_SWEEP_MIN_MTU;
+    config->mtu_max = MTU_SWEEP_MAX_MTU;
+    config->payload_min = 1;
+    config->payload_max = MAX_PAYLOAD_SIZE;
+    config->payload_bins = 64;
+    config->threads = 0;
+}
+
+bool fragment_layout_of(int mtu, int payload_size, fragment_layout* layout)
+{
+    int per_fragment = (mtu - IPV4_HEADER_SIZE) & ~0x7;
+    if (per_fragment <= 0 || payload_size < 0 || payload_size > MAX_PAYLOAD_SIZE) {
+        return false;
+    }
+
+    // Same rule as fragment_ipv4_packet(): no fragmentation if the datagram fits
+    if (payload_size + IPV4_HEADER_SIZE <= mtu) {
+        layout->fragments = 1;
+    } else {
+        layout->fragments = (payload_size + per_fragment - 1) / per_fragment;
+    }
+    layout->header_bytes = layout->fragments * IPV4_HEADER_SIZE;
+    layout->wire_bytes = payload_size + layout->header_bytes;
+    layout->wasted_bytes = layout->fragments * mtu - layout->wire_bytes;
+    return true;
+}
+
+int mtu_sweep_bin_start(const mtu_sweep_result* result, int bin)
+{
+    long long range = (long long)result->payload_max - result->payload_min + 1;
+    return result->payload_min + (int)(range * bin / result->payload_bins);
+}
+
+// Accumulate payload sizes [low, high] on one MTU into a cell, one run at a time
+static void sweep_range(int mtu, int low, int high, mtu_sweep_cell* cell, int* max_fragments)
+{
+    int unfragmented = mtu - IPV4_HEADER_SIZE;
+    int per_fragment = unfragmented & ~0x7;
+
+    int payload = low;
+    while (payload <= high) {
+        int fragments = (payload <= unfragmented) ? 1 : (payload + per_fragment - 1) / per_fragment;
+        int end = (fragments == 1) ? unfragmented : fragments * per_fragment;
+        if (end > high) end = high;
+
+        long long count = end - payload + 1;
+        long long payload_sum = ((long long)payload + end) * count / 2;
+
+        cell->payload_bytes += payload_sum;
+        cell->fragments += fragments * count;
+        cell->header_bytes += (long long)fragments * IPV4_HEADER_SIZE * count;
+        cell->wasted_bytes += (long long)fragments * (mtu - IPV4_HEADER_SIZE) * count - payload_sum;
+        if (fragments > *max_fragments) *max_fragments = fragments;
+
+        payload = end + 1;
+    }
+}
+
+static void* sweep_worker_main(void* arg)
+{
+    sweep_worker* worker = (sweep_worker*)arg;
+    mtu_sweep_result* result = worker->result;
+
+    for (int i = worker->first; i < result->mtu_count; i += worker->stride) {
+        int mtu = result->mtu_min + i;
+        mtu_sweep_cell* total = &result->totals[i];
+
+        for (int bin = 0; bin < result->payload_bins; bin++) {
+            mtu_sweep_cell* cell = &result->cells[(size_t)i * result->payload_bins + bin];
+            sweep_range(mtu, mtu_sweep_bin_start(result, bin), mtu_sweep_bin_start(result, bin + 1) - 1,
+                        cell, &result->max_fragments[i]);
+
+            total->payload_bytes += cell->payload_bytes;
+            total->fragments += cell->fragments;
+            total->header_bytes += cell->header_bytes;
+            total->wasted_bytes += cell->wasted_bytes;
+        }
+    }
+    return NULL;
+}
+
+int run_mtu_sweep(const mtu_sweep_config* config, mtu_sweep_result* result)
+{
+    if (config->mtu_min < IPV4_HEADER_SIZE + 8 || config->mtu_max < config->mtu_min ||
+        config->mtu_max > MAX_IPV4_PACKET_SIZE || config->payload_min < 1 ||
+        config->payload_max < config->payload_min || config->payload_max > MAX_PAYLOAD_SIZE ||
+        config->payload_bins < 1 || config->payload_bins > MTU_SWEEP_MAX_BINS) {
+        return -1;
+    }
+
+    result->mtu_min = config->mtu_min;
+    result->mtu_count = config->mtu_max - config->mtu_min + 1;
+    result->payload_min = config->payload_min;
+    result->payload_max = config->payload_max;
+    result->payload_bins = config->payload_bins;
+    if (result->payload_bins > config->payload_max - config->payload_min + 1) {
+        result->payload_bins = config->payload_max - config->payload_min + 1;
+    }
+
+    result->totals = (mtu_sweep_cell*)calloc(result->mtu_count, sizeof(mtu_sweep_cell));
+    result->cells = (mtu_sweep_cell*)calloc((size_t)result->mtu_count * result->payload_bins, sizeof(mtu_sweep_cell));
+    result->max_fragments = (int*)calloc(result->mtu_count, sizeof(int));
+    if (result->totals == NULL || result->cells == NULL || result->max_fragments == NULL) {
+        fprintf(stderr, "Memory allocation failed for MTU sweep\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int thread_count = (config->threads > 0) ? config->threads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (thread_count < 1) thread_count = 1;
+    if (thread_count > result->mtu_count) thread_count = result->mtu_count;
+
+    pthread_t* threads = (pthread_t*)malloc(thread_count * sizeof(pthread_t));
+    sweep_worker* workers = (sweep_worker*)malloc(thread_count * sizeof(sweep_worker));
+    bool* running = (bool*)calloc(thread_count, sizeof(bool));
+    if (threads == NULL || workers == NULL || running == NULL) {
+        fprintf(stderr, "Memory allocation failed for MTU sweep\n");
+        exit(EXIT_FAILURE);
+    }
+
+    double start = now_seconds();
+    for (int t = 0; t < thread_count; t++) {
+        workers[t].result = result;
+        workers[t].first = t;
+        workers[t].stride = thread_count;
+    }
+    // The caller sweeps worker 0's share and any share whose thread could not start
+    for (int t = 1; t < thread_count; t++) {
+        running[t] = (pthread_create(&threads[t], NULL, sweep_worker_main, &workers[t]) == 0);
+        if (!running[t]) sweep_worker_main(&workers[t]);
+    }
+    sweep_worker_main(&workers[0]);
+    for (int t = 1; t < thread_count; t++) {
+        if (running[t]) pthread_join(threads[t], NULL);
+    }
+    result->elapsed_seconds = now_seconds() - start;
+
+    free(threads);
+    free(workers);
+    free(running);
+    return 0;
+}
+
+int mtu_sweep_verify(const mtu_sweep_result* result, int samples, unsigned int seed)
+{
+    unsigned int state = seed ? seed : 0x9E3779B9u;
+    int mismatches = 0;
+
+    for (int s = 0; s < samples; s++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        int index = (int)(state % result->mtu_count);
+        int mtu = result->mtu_min + index;
+        int bin = (int)((state >> 8) % result->payload_bins);
+        int low = mtu_sweep_bin_start(result, bin);
+        int high = mtu_sweep_bin_start(result, bin + 1) - 1;
+        int payload = low + (int)((state >> 4) % (high - low + 1));
+
+        // The real fragmenter on a virtual packet, so no payload is copied
+        ipv4_packet packet;
+        ipv4_fragment* fragments;
+        create_ipv4_packet_virtual(&packet, 0, 1, payload, PAYLOAD_PATTERN_SEQUENTIAL, 0);
+        int count = fragment_ipv4_packet(&packet, mtu, &fragments);
+        int wire = 0;
+        for (int i = 0; i < count; i++) {
+            wire += fragments[i].header.total_len;
+        }
+        free(fragments);
+
+        fragment_layout layout;
+        bool point_ok = fragment_layout_of(mtu, payload, &layout) && layout.fragments == count &&
+                        layout.wire_bytes == wire && layout.wasted_bytes == count * mtu - wire;
+
+        // The whole bin, one payload size at a time
+        mtu_sweep_cell expected = { 0, 0, 0, 0 };
+        for (int p = low; p <= high; p++) {
+            fragment_layout_of(mtu, p, &layout);
+            expected.payload_bytes += p;
+            expected.fragments += layout.fragments;
+            expected.header_bytes += layout.header_bytes;
+            expected.wasted_bytes += layout.wasted_bytes;
+        }
+        const mtu_sweep_cell* cell = &result->cells[(size_t)index * result->payload_bins + bin];
+        bool cell_ok = cell->payload_bytes == expected.payload_bytes && cell->fragments == expected.fragments &&
+                       cell->header_bytes == expected.header_bytes && cell->wasted_bytes == expected.wasted_bytes;
+
+        if (!point_ok || !cell_ok) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+int mtu_sweep_write_csv(const mtu_sweep_result* result, const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        return -1;
+    }
+
+    fprintf(file, "mtu,payload_low,payload_high,avg_fragments,header_overhead_pct,wasted_pct\n");
+    for (int i = 0; i < result->mtu_count; i++) {
+        for (int bin = 0; bin < result->payload_bins; bin++) {
+            const mtu_sweep_cell* cell = &result->cells[(size_t)i * result->payload_bins + bin];
+            int low = mtu_sweep_bin_start(result, bin);
+            int high = mtu_sweep_bin_start(result, bin + 1) - 1;
+            long long frame_bytes = cell->payload_bytes + cell->header_bytes + cell->wasted_bytes;
+
+            fprintf(file, "%d,%d,%d,%.3f,%.3f,%.3f\n", result->mtu_min + i, low, high,
+                    (double)cell->fragments / (high - low + 1),
+                    100.0 * cell->header_bytes / cell->payload_bytes,
+                    100.0 * cell->wasted_bytes / frame_bytes);
+        }
+    }
+
+    int status = ferror(file) ? -1 : 0;
+    if (fclose(file) != 0) status = -1;
+    return status;
+}
+
+void mtu_sweep_free(mtu_sweep_result* result)
+{
+    free(result->totals);
+    free(result->cells);
+    free(result->max_fragments);
+    result->totals = NULL;
+    result->cells = NULL;
+    result->max_fragments = NULL;
+}
@@ -0,0 +1,175 @@
+/**
+ * multicast.c
+ * One-to-many routing: distribution trees and fragment forwarding to receiver sets
+ *
+ * A single Dijkstra run gives the routes from the source to every receiver.
+ * Their union is the distribution tree; where routes share a prefix the
+ * fragments cross the shared links once instead of once per receiver.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/multicast.h"
+
+static void* multicast_alloc(size_t bytes)
+{
+    void* p = malloc(bytes > 0 ? bytes : 1);
+    if (p == NULL) {
+        fprintf(stderr, "Memory allocation failed for multicast tree\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+int multicast_tree_build(multicast_tree* tree, csr_graph* graph, int source, const int* receivers, int receiver_count)
+{
+    int n = graph->node_count;
+    if (source < 0 || source >= n || receiver_count < 0) {
+        return -1;
+    }
+    for (int i = 0; i < receiver_count; i++) {
+        if (receivers[i] < 0 || receivers[i] >= n) return -1;
+    }
+
+    tree->source = source;
+    tree->node_count = n;
+    tree->receiver_count = 0;
+    tree->unreachable = 0;
+    tree->link_count = 0;
+    tree->unicast_hops = 0;
+    tree->parent = (int*)multicast_alloc(n * sizeof(int));
+    tree->depth = (int*)multicast_alloc(n * sizeof(int));
+    tree->is_receiver = (bool*)calloc(n > 0 ? n : 1, sizeof(bool));
+    tree->child_offsets = (int*)calloc(n + 1, sizeof(int));
+    if (tree->is_receiver == NULL || tree->child_offsets == NULL) {
+        fprintf(stderr, "Memory allocation failed for multicast tree\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int* dist = (int*)multicast_alloc(n * sizeof(int));
+    int* prev = (int*)multicast_alloc(n * sizeof(int));
+    int* stack = (int*)multicast_alloc(n * sizeof(int));
+    bool* seen = (bool*)calloc(n, sizeof(bool));
+    if (seen == NULL) {
+        fprintf(stderr, "Memory allocation failed for multicast tree\n");
+        exit(EXIT_FAILURE);
+    }
+    dijkstra_csr(graph, source, dist, prev);
+
+    for (int v = 0; v < n; v++) {
+        tree->parent[v] = -1;
+        tree->depth[v] = -1;
+    }
+    tree->depth[source] = 0;
+
+    // Graft each receiver's route onto the tree, up to the first node already on it
+    for (int i = 0; i < receiver_count; i++) {
+        int r = receivers[i];
+        if (r == source || seen[r]) continue;
+        seen[r] = true;
+        if (dist[r] == GRAPH_UNREACHABLE) {
+            tree->unreachable++;
+            continue;
+        }
+
+        int top = 0;
+        for (int v = r; tree->depth[v] < 0; v = prev[v]) {
+            stack[top++] = v;
+            tree->parent[v] = prev[v];
+        }
+        while (top > 0) {
+            int v = stack[--top];
+            tree->depth[v] = tree->depth[tree->parent[v]] + 1;
+            tree->child_offsets[tree->parent[v] + 1]++;
+            tree->link_count++;
+        }
+
+        tree->is_receiver[r] = true;
+        tree->receiver_count++;
+        tree->unicast_hops += tree->depth[r];
+    }
+
+    // Children grouped by parent, in increasing node order
+    for (int u = 0; u < n; u++) {
+        tree->child_offsets[u + 1] += tree->child_offsets[u];
+    }
+    tree->children = (int*)multicast_alloc(tree->link_count * sizeof(int));
+    for (int u = 0; u < n; u++) {
+        stack[u] = tree->child_offsets[u];
+    }
+    for (int v = 0; v < n; v++) {
+        if (tree->parent[v] >= 0) {
+            tree->children[stack[tree->parent[v]]++] = v;
+        }
+    }
+
+    free(dist);
+    free(prev);
+    free(stack);
+    free(seen);
+    return tree->receiver_count;
+}
+
+int multicast_tree_build_topology(multicast_tree* tree, network_topology* network, int source,
+                                  const int* receivers, int receiver_count)
+{
+    csr_graph graph;
+    csr_from_topology(&graph, network);
+    int result = multicast_tree_build(tree, &graph, source, receivers, receiver_count);
+    csr_free(&graph);
+    return result;
+}
+
+void multicast_tree_free(multicast_tree* tree)
+{
+    free(tree->parent);
+    free(tree->depth);
+    free(tree->is_receiver);
+    free(tree->child_offsets);
+    free(tree->children);
+    tree->parent = NULL;
+    tree->depth = NULL;
+    tree->is_receiver = NULL;
+    tree->child_offsets = NULL;
+    tree->children = NULL;
+    tree->node_count = 0;
+}
+
+int multicast_tree_path(const multicast_tree* tree, int receiver, int** path)
+{
+    *path = NULL;
+    if (receiver < 0 || receiver >= tree->node_count || tree->depth[receiver] < 0) {
+        return -1;
+    }
+
+    int count = tree->depth[receiver] + 1;
+    *path = (int*)multicast_alloc(count * sizeof(int));
+    int v = receiver;
+    for (int i = count - 1; i >= 0; i--) {
+        (*path)[i] = v;
+        v = tree->parent[v];
+    }
+    return count;
+}
+
+void multicast_forward(const multicast_tree* tree, const ipv4_fragment* fragments, int count,
+                       multicast_report* report)
+{
+    report->fragments = count;
+    report->fragment_bytes = 0;
+    for (int f = 0; f < count; f++) {
+        report->fragment_bytes += fragments[f].header.total_len;
+    }
+
+    // Every tree link carries one copy of each fragment, and every receiver on
+    // the tree gets one; no walk of the tree is needed for the totals
+    report->transmissions = (long long)tree->link_count * count;
+    report->link_bytes = (long long)tree->link_count * report->fragment_bytes;
+    report->deliveries = (long long)tree->receiver_count * count;
+
+    report->unicast_transmissions = tree->unicast_hops * count;
+    report->unicast_link_bytes = tree->unicast_hops * report->fragment_bytes;
+    report->savings = (report->unicast_link_bytes > 0)
+                          ? 1.0 - (double)report->link_bytes / report->unicast_link_bytes
+                          : 0.0;
+}
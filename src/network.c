@@ -2,6 +2,10 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "include/session_log.h"
+#include "include/topology_txn.h"
 
 void init_network_topology(network_topology* network, int num_nodes) {
   if (num_nodes > MAX_NODES) {
@@ -49,19 +53,21 @@ void create_custom_topology(network_topology* network) {
   int num_nodes, num_connections;
 
   printf("Enter the number of nodes: ");
-  scanf("%d", &num_nodes);
+  session_read_int(&num_nodes);
 
   init_network_topology(network, num_nodes);
 
   printf("Enter the number of connectiosn: ");
-  scanf("%d", &num_connections);
+  session_read_int(&num_connections);
 
   printf("Enter connections as [FROM] [TO] [WEIGHT]");
   for (int i = 0; i < num_connections; i++) {
     int from, to, weight;
 
     printf("Connection %d", i + 1);
-    scanf("%d %d %d", &from, &to, &weight);
+    session_read_int(&from);
+    session_read_int(&to);
+    session_read_int(&weight);
 
     if (from < 0 || from >= num_nodes || to < 0 || to >= num_nodes) {
       printf("Invalid nodes. Both must be between 0 and %d. Try again.\n",
@@ -78,59 +84,103 @@ void create_custom_topology(network_topology* network) {
   printf("Custom graph created!!");
 }
 
-void modify_network_topology(network_topology* network) {
+// Stage one "op from to [weight]" line of a batch, op being add, remove or set
+static bool read_batch_change(topology_txn* txn) {
+  char op[16];
+  int from, to, weight;
+  if (!session_read_word(op, sizeof(op)) || !session_read_int(&from) ||
+      !session_read_int(&to)) {
+    return false;
+  }
+
+  if (strcmp(op, "remove") == 0) {
+    topology_txn_remove_link(txn, from, to);
+    return true;
+  }
+  if (!session_read_int(&weight)) return false;
+  if (strcmp(op, "add") == 0) {
+    topology_txn_add_link(txn, from, to, weight);
+  } else if (strcmp(op, "set") == 0) {
+    topology_txn_set_weight(txn, from, to, weight);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void modify_network_topology(network_topology* network, struct route_cache* routes) {
   printf("\n=== Modifying Network Topology ===\n");
   printf("1. Add a new connection\n");
   printf("2. Remove an existing connection\n");
   printf("3. Change the weight of a connection\n");
-  printf("Enter your choice (1-3): ");
+  printf("4. Apply a batch of changes\n");
+  printf("Enter your choice (1-4): ");
 
-  int choice;
-  scanf("%d", &choice);
+  int choice = 0;
+  session_read_int(&choice);
 
-  int from, to, weight;
+  int from, to, weight, count;
+  bool read_ok = true;
+  topology_txn txn;
+  topology_txn_begin(&txn, network);
 
   switch (choice) {
     case 1:  // Add connection
       printf("Enter new connection (from to weight): ");
-      scanf("%d %d %d", &from, &to, &weight);
-      if (from >= 0 && from < network->node_count && to >= 0 &&
-          to < network->node_count && weight > 0) {
-        add_connection(network, from, to, weight);
-        printf("Connection added: %d -> %d (weight: %d)\n", from, to, weight);
-      } else {
-        printf("Invalid input. No changes made.\n");
-      }
+      read_ok = session_read_int(&from) && session_read_int(&to) && session_read_int(&weight);
+      if (read_ok) topology_txn_add_link(&txn, from, to, weight);
       break;
 
     case 2:  // Remove connection
       printf("Enter connection to remove (from to): ");
-      scanf("%d %d", &from, &to);
-      if (from >= 0 && from < network->node_count && to >= 0 &&
-          to < network->node_count) {
-        network->graph[from][to] = 0;
-        printf("Connection removed: %d -> %d\n", from, to);
-      } else {
-        printf("Invalid input. No changes made.\n");
-      }
+      read_ok = session_read_int(&from) && session_read_int(&to);
+      if (read_ok) topology_txn_remove_link(&txn, from, to);
       break;
 
     case 3:  // Change weight
       printf("Enter connection to modify (from to new_weight): ");
-      scanf("%d %d %d", &from, &to, &weight);
-      if (from >= 0 && from < network->node_count && to >= 0 &&
-          to < network->node_count && weight > 0) {
-        network->graph[from][to] = weight;
-        printf("Connection modified: %d -> %d (new weight: %d)\n", from, to,
-               weight);
-      } else {
+      read_ok = session_read_int(&from) && session_read_int(&to) && session_read_int(&weight);
+      if (read_ok) topology_txn_set_weight(&txn, from, to, weight);
+      break;
+
+    case 4:  // Batch: all changes are applied or none
+      printf("Number of changes: ");
+      if (!session_read_int(&count) || count <= 0) {
         printf("Invalid input. No changes made.\n");
+        topology_txn_free(&txn);
+        return;
+      }
+      printf("Enter %d changes, one per line (add from to weight | remove from to | set from to weight):\n", count);
+      for (int i = 0; i < count; i++) {
+        if (!read_batch_change(&txn)) {
+          printf("Invalid change %d. No changes made.\n", i + 1);
+          topology_txn_free(&txn);
+          return;
+        }
       }
       break;
 
     default:
       printf("Invalid choice. No changes made.\n");
+      topology_txn_free(&txn);
+      return;
+  }
+
+  if (!read_ok) {
+    printf("Invalid input. No changes made.\n");
+    topology_txn_free(&txn);
+    return;
+  }
+
+  topology_txn_result result;
+  if (topology_txn_commit(&txn, routes, &result) != 0) {
+    printf("Invalid input (change %d: %s). No changes made.\n", result.failed_change + 1, result.error);
+  } else {
+    printf("%d change(s) applied, %d link(s) changed in %.1f us; %d route tree(s) recomputed in %.1f us\n",
+           result.applied, result.links_changed, result.apply_seconds * 1e6, result.trees_recomputed,
+           result.recompute_seconds * 1e6);
   }
+  topology_txn_free(&txn);
 }
 
 
@@ -0,0 +1,672 @@
+/**
+ * queue_sim.c
+ * Congestion simulation: fragments forwarded through bounded router output queues
+ *
+ * Every directed link has an output queue at its sending router with a
+ * byte budget, a transmitter of fixed bandwidth and a propagation delay
+ * proportional to the link weight. Flows send Poisson datagrams along their
+ * shortest path; each datagram is split at the MTU and its fragments are
+ * queued hop by hop. A datagram counts as delivered only if every fragment
+ * arrives; fragments of an already doomed datagram still use bandwidth.
+ *
+ * Fragments live in a pool of small descriptors and queues hold only pool
+ * indices in ring buffers, so the hot path never calls malloc.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/graph.h"
+#include "../include/heap.h"
+#include "../include/ipv4.h"
+#include "../include/queue_sim.h"
+#include "../include/route_cache.h"
+
+// Event kinds, stored in the low bits of the heap value
+#define EVENT_DATAGRAM 0   // id: flow
+#define EVENT_TX_DONE  1   // id: link
+#define EVENT_ARRIVAL  2   // id: fragment descriptor
+#define EVENT_BITS     2
+
+// RED parameters, thresholds as fractions of the buffer
+#define RED_WEIGHT   0.002
+#define RED_MIN      0.25
+#define RED_MAX      0.75
+#define RED_MAX_PROB 0.1
+
+#define NONE 0xFFFFFFFFu
+
+typedef struct fragment_desc {
+    uint32_t datagram;
+    uint32_t next_free;
+    uint16_t bytes;       // total length on the wire
+    uint16_t flow;
+    uint16_t hop;         // index of the current link on the flow's route
+} fragment_desc;
+
+typedef struct datagram_state {
+    long long created_ns;
+    uint16_t  flow;
+    uint16_t  fragments;
+    uint16_t  resolved;   // delivered or dropped
+    bool      lost;
+    uint32_t  next_free;
+} datagram_state;
+
+// Growable ring of descriptor indices with both ends usable
+typedef struct desc_ring {
+    uint32_t* slots;
+    uint32_t  mask;
+    uint32_t  head;   // next to leave
+    uint32_t  tail;   // next free slot
+} desc_ring;
+
+typedef struct output_queue {
+    long long delay_ns;
+    uint32_t  in_service;     // fragment being transmitted, NONE if idle
+    long      bytes;          // bytes waiting, not counting the one in service
+    desc_ring fifo;           // tail drop and RED
+
+    // Fair queueing: per-bucket rings served by deficit round robin
+    desc_ring* buckets;
+    long*      bucket_bytes;
+    int*       deficit;
+    desc_ring  active;        // bucket ids with waiting fragments, in service order
+
+    double    red_average;
+    int       red_count;      // fragments accepted since the last early drop
+} output_queue;
+
+typedef struct flow_state {
+    int       source;
+    int       destination;
+    int*      links;          // link ids along the route
+    int       hops;
+    double    rate;           // datagrams per second
+    long      sent;
+    long      delivered;
+} flow_state;
+
+typedef struct queue_sim {
+    const queue_sim_config* config;
+    output_queue*   links;
+    int             link_count;
+    flow_state*     flows;
+    int             flow_count;
+
+    fragment_desc*  fragments;
+    uint32_t        fragment_capacity;
+    uint32_t        free_fragment;
+    datagram_state* datagrams;
+    uint32_t        datagram_capacity;
+    uint32_t        free_datagram;
+
+    min_heap        events;
+    long long       now;
+    unsigned int    random;
+    queue_sim_report* report;
+    double          delay_total_ms;
+} queue_sim;
+
+static void* checked_realloc(void* memory, size_t size)
+{
+    memory = realloc(memory, size > 0 ? size : 1);
+    if (memory == NULL) {
+        fprintf(stderr, "Memory allocation failed for queue simulation\n");
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+void init_queue_sim_config(queue_sim_config* config)
+{
+    config->policy = QUEUE_TAIL_DROP;
+    config->mtu = 1500;
+    config->payload_size = 4000;
+    config->offered_load = 2.5;
+    config->bandwidth_bps = 100000000;
+    config->buffer_bytes = 64 * 1024;
+    config->delay_ns = 100000;
+    config->flow_count = 8;
+    config->duration_s = 1.0;
+    config->seed = 1;
+}
+
+bool parse_queue_policy(const char* name, queue_policy* policy)
+{
+    if (strcmp(name, "tail") == 0) {
+        *policy = QUEUE_TAIL_DROP;
+    } else if (strcmp(name, "red") == 0) {
+        *policy = QUEUE_RED;
+    } else if (strcmp(name, "fq") == 0) {
+        *policy = QUEUE_FAIR;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* queue_policy_name(queue_policy policy)
+{
+    switch (policy) {
+        case QUEUE_TAIL_DROP: return "tail-drop";
+        case QUEUE_RED:       return "RED";
+        case QUEUE_FAIR:      return "fair";
+    }
+    return "unknown";
+}
+
+// ---------------------------------------------------------------------------
+// Rings and pools
+// ---------------------------------------------------------------------------
+
+static void ring_init(desc_ring* ring)
+{
+    ring->slots = (uint32_t*)checked_realloc(NULL, 16 * sizeof(uint32_t));
+    ring->mask = 15;
+    ring->head = 0;
+    ring->tail = 0;
+}
+
+static uint32_t ring_size(const desc_ring* ring)
+{
+    return ring->tail - ring->head;
+}
+
+static void ring_push(desc_ring* ring, uint32_t value)
+{
+    if (ring_size(ring) == ring->mask + 1) {
+        // Unwrap into a ring twice the size
+        uint32_t size = ring_size(ring);
+        uint32_t* slots = (uint32_t*)checked_realloc(NULL, 2 * (size_t)size * sizeof(uint32_t));
+        for (uint32_t i = 0; i < size; i++) {
+            slots[i] = ring->slots[(ring->head + i) & ring->mask];
+        }
+        free(ring->slots);
+        ring->slots = slots;
+        ring->mask = 2 * size - 1;
+        ring->head = 0;
+        ring->tail = size;
+    }
+    ring->slots[ring->tail++ & ring->mask] = value;
+}
+
+static uint32_t ring_front(const desc_ring* ring)
+{
+    return ring->slots[ring->head & ring->mask];
+}
+
+static uint32_t ring_pop_front(desc_ring* ring)
+{
+    return ring->slots[ring->head++ & ring->mask];
+}
+
+static uint32_t ring_pop_back(desc_ring* ring)
+{
+    return ring->slots[--ring->tail & ring->mask];
+}
+
+static uint32_t alloc_fragment(queue_sim* sim)
+{
+    if (sim->free_fragment == NONE) {
+        uint32_t old = sim->fragment_capacity;
+        sim->fragment_capacity = old ? old * 2 : 4096;
+        sim->fragments = (fragment_desc*)checked_realloc(sim->fragments,
+                                                         sim->fragment_capacity * sizeof(fragment_desc));
+        for (uint32_t i = sim->fragment_capacity; i-- > old;) {
+            sim->fragments[i].next_free = sim->free_fragment;
+            sim->free_fragment = i;
+        }
+    }
+    uint32_t index = sim->free_fragment;
+    sim->free_fragment = sim->fragments[index].next_free;
+    return index;
+}
+
+static void free_fragment(queue_sim* sim, uint32_t index)
+{
+    sim->fragments[index].next_free = sim->free_fragment;
+    sim->free_fragment = index;
+}
+
+static uint32_t alloc_datagram(queue_sim* sim)
+{
+    if (sim->free_datagram == NONE) {
+        uint32_t old = sim->datagram_capacity;
+        sim->datagram_capacity = old ? old * 2 : 1024;
+        sim->datagrams = (datagram_state*)checked_realloc(sim->datagrams,
+                                                          sim->datagram_capacity * sizeof(datagram_state));
+        for (uint32_t i = sim->datagram_capacity; i-- > old;) {
+            sim->datagrams[i].next_free = sim->free_datagram;
+            sim->free_datagram = i;
+        }
+    }
+    uint32_t index = sim->free_datagram;
+    sim->free_datagram = sim->datagrams[index].next_free;
+    return index;
+}
+
+static double next_uniform(queue_sim* sim)
+{
+    sim->random ^= sim->random << 13;
+    sim->random ^= sim->random >> 17;
+    sim->random ^= sim->random << 5;
+    return (sim->random + 1.0) / 4294967297.0;
+}
+
+static void schedule(queue_sim* sim, long long time, int type, uint32_t id)
+{
+    heap_push(&sim->events, time, (int)((id << EVENT_BITS) | type));
+}
+
+// ---------------------------------------------------------------------------
+// Fragment fate
+// ---------------------------------------------------------------------------
+
+// A fragment was delivered or dropped; settle its datagram once all are accounted for
+static void resolve_fragment(queue_sim* sim, uint32_t index, bool dropped)
+{
+    fragment_desc* fragment = &sim->fragments[index];
+    datagram_state* datagram = &sim->datagrams[fragment->datagram];
+
+    if (dropped) {
+        datagram->lost = true;
+        sim->report->fragments_dropped++;
+    }
+    datagram->resolved++;
+
+    if (datagram->resolved == datagram->fragments) {
+        if (!datagram->lost) {
+            sim->report->datagrams_delivered++;
+            sim->report->goodput_bytes += sim->config->payload_size;
+            sim->flows[datagram->flow].delivered++;
+            sim->delay_total_ms += (sim->now - datagram->created_ns) / 1e6;
+        }
+        datagram->next_free = sim->free_datagram;
+        sim->free_datagram = fragment->datagram;
+    }
+    free_fragment(sim, index);
+}
+
+static long long transmit_ns(const queue_sim* sim, int bytes)
+{
+    return (long long)bytes * 8 * 1000000000LL / sim->config->bandwidth_bps;
+}
+
+static void start_transmission(queue_sim* sim, int link, uint32_t index)
+{
+    output_queue* queue = &sim->links[link];
+    queue->in_service = index;
+    sim->report->wire_bytes += sim->fragments[index].bytes;
+    schedule(sim, sim->now + transmit_ns(sim, sim->fragments[index].bytes), EVENT_TX_DONE, (uint32_t)link);
+}
+
+// Next fragment to send from a queue, NONE if it is empty
+static uint32_t dequeue(queue_sim* sim, output_queue* queue)
+{
+    if (sim->config->policy != QUEUE_FAIR) {
+        if (ring_size(&queue->fifo) == 0) return NONE;
+        uint32_t index = ring_pop_front(&queue->fifo);
+        queue->bytes -= sim->fragments[index].bytes;
+        return index;
+    }
+
+    // Deficit round robin: the front bucket sends while its deficit covers the head
+    while (ring_size(&queue->active) > 0) {
+        uint32_t bucket = ring_front(&queue->active);
+        desc_ring* ring = &queue->buckets[bucket];
+        uint32_t index = ring_front(ring);
+        int bytes = sim->fragments[index].bytes;
+
+        if (bytes <= queue->deficit[bucket]) {
+            ring_pop_front(ring);
+            queue->deficit[bucket] -= bytes;
+            queue->bucket_bytes[bucket] -= bytes;
+            queue->bytes -= bytes;
+            if (ring_size(ring) == 0) {
+                queue->deficit[bucket] = 0;
+                ring_pop_front(&queue->active);
+            }
+            return index;
+        }
+        queue->deficit[bucket] += QUEUE_FAIR_QUANTUM;
+        ring_push(&queue->active, ring_pop_front(&queue->active));
+    }
+    return NONE;
+}
+
+// Queue a fragment on a link or drop it according to the policy
+static void enqueue(queue_sim* sim, int link, uint32_t index)
+{
+    output_queue* queue = &sim->links[link];
+    fragment_desc* fragment = &sim->fragments[index];
+    const queue_sim_config* config = sim->config;
+
+    if (queue->in_service == NONE) {
+        start_transmission(sim, link, index);
+        return;
+    }
+
+    if (config->policy == QUEUE_RED) {
+        queue->red_average = (1 - RED_WEIGHT) * queue->red_average + RED_WEIGHT * queue->bytes;
+        double min_bytes = RED_MIN * config->buffer_bytes;
+        double max_bytes = RED_MAX * config->buffer_bytes;
+        bool early = false;
+        if (queue->red_average >= max_bytes) {
+            early = true;
+        } else if (queue->red_average > min_bytes) {
+            // Spread drops out: the probability grows with fragments accepted since the last one
+            double base = RED_MAX_PROB * (queue->red_average - min_bytes) / (max_bytes - min_bytes);
+            double probability = base / (1 - queue->red_count * base);
+            early = (probability <= 0 || probability >= 1) || next_uniform(sim) < probability;
+        }
+        if (early) {
+            queue->red_count = 0;
+            resolve_fragment(sim, index, true);
+            return;
+        }
+        queue->red_count++;
+    }
+
+    if (config->policy != QUEUE_FAIR) {
+        if (queue->bytes + fragment->bytes > config->buffer_bytes) {
+            resolve_fragment(sim, index, true);
+            return;
+        }
+        ring_push(&queue->fifo, index);
+        queue->bytes += fragment->bytes;
+        return;
+    }
+
+    // Fair queueing: make room by dropping from the tail of the longest bucket
+    uint32_t bucket = fragment->flow % QUEUE_FAIR_BUCKETS;
+    while (queue->bytes + fragment->bytes > config->buffer_bytes) {
+        uint32_t longest = bucket;
+        for (uint32_t b = 0; b < QUEUE_FAIR_BUCKETS; b++) {
+            if (queue->bucket_bytes[b] > queue->bucket_bytes[longest]) longest = b;
+        }
+        // Counting the arrival, its own flow is the biggest user: drop the arrival
+        if (queue->bucket_bytes[bucket] + fragment->bytes >= queue->bucket_bytes[longest]) {
+            resolve_fragment(sim, index, true);
+            return;
+        }
+        uint32_t victim = ring_pop_back(&queue->buckets[longest]);
+        queue->bucket_bytes[longest] -= sim->fragments[victim].bytes;
+        queue->bytes -= sim->fragments[victim].bytes;
+        if (ring_size(&queue->buckets[longest]) == 0) {
+            // Take the emptied bucket out of the round
+            uint32_t active = ring_size(&queue->active);
+            for (uint32_t i = 0; i < active; i++) {
+                uint32_t b = ring_pop_front(&queue->active);
+                if (b != longest) ring_push(&queue->active, b);
+            }
+            queue->deficit[longest] = 0;
+        }
+        resolve_fragment(sim, victim, true);
+    }
+
+    if (ring_size(&queue->buckets[bucket]) == 0) {
+        ring_push(&queue->active, bucket);
+    }
+    ring_push(&queue->buckets[bucket], index);
+    queue->bucket_bytes[bucket] += fragment->bytes;
+    queue->bytes += fragment->bytes;
+}
+
+// ---------------------------------------------------------------------------
+// Events
+// ---------------------------------------------------------------------------
+
+static void send_datagram(queue_sim* sim, int flow_index)
+{
+    flow_state* flow = &sim->flows[flow_index];
+    const queue_sim_config* config = sim->config;
+    int payload = config->payload_size;
+
+    // Same split as fragment_ipv4_packet()
+    int per_fragment = (config->mtu - IPV4_HEADER_SIZE) & ~0x7;
+    int count = (payload + IPV4_HEADER_SIZE <= config->mtu) ? 1 : (payload + per_fragment - 1) / per_fragment;
+
+    uint32_t datagram = alloc_datagram(sim);
+    sim->datagrams[datagram].created_ns = sim->now;
+    sim->datagrams[datagram].flow = (uint16_t)flow_index;
+    sim->datagrams[datagram].fragments = (uint16_t)count;
+    sim->datagrams[datagram].resolved = 0;
+    sim->datagrams[datagram].lost = false;
+
+    int remaining = payload;
+    for (int i = 0; i < count; i++) {
+        int size = (count == 1) ? payload : (remaining < per_fragment ? remaining : per_fragment);
+        remaining -= size;
+
+        uint32_t index = alloc_fragment(sim);
+        fragment_desc* fragment = &sim->fragments[index];
+        fragment->datagram = datagram;
+        fragment->bytes = (uint16_t)(IPV4_HEADER_SIZE + size);
+        fragment->flow = (uint16_t)flow_index;
+        fragment->hop = 0;
+        enqueue(sim, flow->links[0], index);
+    }
+
+    flow->sent++;
+    sim->report->datagrams_sent++;
+    sim->report->fragments_sent += count;
+
+    // Poisson arrivals until the generation window closes
+    long long gap = (long long)(-log(next_uniform(sim)) / flow->rate * 1e9);
+    if (sim->now + gap < (long long)(config->duration_s * 1e9)) {
+        schedule(sim, sim->now + gap, EVENT_DATAGRAM, (uint32_t)flow_index);
+    }
+}
+
+static void finish_transmission(queue_sim* sim, int link)
+{
+    output_queue* queue = &sim->links[link];
+    schedule(sim, sim->now + queue->delay_ns, EVENT_ARRIVAL, queue->in_service);
+
+    queue->in_service = NONE;
+    uint32_t next = dequeue(sim, queue);
+    if (next != NONE) {
+        start_transmission(sim, link, next);
+    }
+}
+
+static void arrive(queue_sim* sim, uint32_t index)
+{
+    fragment_desc* fragment = &sim->fragments[index];
+    flow_state* flow = &sim->flows[fragment->flow];
+
+    fragment->hop++;
+    if (fragment->hop == flow->hops) {
+        resolve_fragment(sim, index, false);
+    } else {
+        enqueue(sim, flow->links[fragment->hop], index);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Setup
+// ---------------------------------------------------------------------------
+
+static int find_link(const csr_graph* graph, int from, int to)
+{
+    for (int e = graph->offsets[from]; e < graph->offsets[from + 1]; e++) {
+        if (graph->targets[e] == to) return e;
+    }
+    return -1;
+}
+
+// Pick flows among routable pairs in a seeded order; flow i offers a share ~ 1 / (i + 1)
+static int setup_flows(queue_sim* sim, network_topology* network, const csr_graph* graph)
+{
+    const queue_sim_config* config = sim->config;
+    int n = network->node_count;
+    route_cache routes;
+    route_cache_init(&routes, network);
+
+    int pair_count = 0;
+    int* pairs = (int*)checked_realloc(NULL, (size_t)n * n * sizeof(int));
+    for (int s = 0; s < n; s++) {
+        for (int d = 0; d < n; d++) {
+            if (s != d && route_cache_lookup(&routes, s, d).tree != ROUTE_NO_TREE) {
+                pairs[pair_count++] = s * n + d;
+            }
+        }
+    }
+    for (int i = pair_count - 1; i > 0; i--) {
+        int j = (int)(next_uniform(sim) * (i + 1));
+        if (j > i) j = i;
+        int swap = pairs[i];
+        pairs[i] = pairs[j];
+        pairs[j] = swap;
+    }
+
+    sim->flow_count = config->flow_count < pair_count ? config->flow_count : pair_count;
+    sim->flows = (flow_state*)checked_realloc(NULL, sim->flow_count * sizeof(flow_state));
+
+    double share_total = 0;
+    for (int i = 0; i < sim->flow_count; i++) {
+        share_total += 1.0 / (i + 1);
+    }
+    double datagram_rate = config->offered_load * config->bandwidth_bps / 8.0 / config->payload_size;
+
+    for (int i = 0; i < sim->flow_count; i++) {
+        flow_state* flow = &sim->flows[i];
+        flow->source = pairs[i] / n;
+        flow->destination = pairs[i] % n;
+        flow->rate = datagram_rate * (1.0 / (i + 1)) / share_total;
+        flow->sent = 0;
+        flow->delivered = 0;
+
+        int* path = NULL;
+        int length = route_expand_path(&routes, route_cache_lookup(&routes, flow->source, flow->destination),
+                                       &path);
+        flow->hops = length - 1;
+        flow->links = (int*)checked_realloc(NULL, flow->hops * sizeof(int));
+        for (int h = 0; h < flow->hops; h++) {
+            flow->links[h] = find_link(graph, path[h], path[h + 1]);
+        }
+        free(path);
+    }
+
+    free(pairs);
+    route_cache_free(&routes);
+    return sim->flow_count;
+}
+
+int run_queue_sim(network_topology* network, const queue_sim_config* config, queue_sim_report* report)
+{
+    memset(report, 0, sizeof(*report));
+    if (config->mtu < IPV4_HEADER_SIZE + 8 || config->mtu > MAX_IPV4_PACKET_SIZE ||
+        config->payload_size < 1 || config->payload_size > MAX_PAYLOAD_SIZE ||
+        config->buffer_bytes < config->mtu || config->bandwidth_bps <= 0 || config->offered_load <= 0 ||
+        config->flow_count < 1 || config->duration_s <= 0) {
+        return -1;
+    }
+
+    queue_sim sim;
+    memset(&sim, 0, sizeof(sim));
+    sim.config = config;
+    sim.report = report;
+    sim.random = config->seed ? config->seed : 0x9E3779B9u;
+    sim.free_fragment = NONE;
+    sim.free_datagram = NONE;
+
+    csr_graph graph;
+    csr_from_topology(&graph, network);
+    if (setup_flows(&sim, network, &graph) == 0) {
+        free(sim.flows);
+        csr_free(&graph);
+        return -1;
+    }
+
+    sim.link_count = graph.edge_count;
+    sim.links = (output_queue*)checked_realloc(NULL, sim.link_count * sizeof(output_queue));
+    for (int u = 0; u < graph.node_count; u++) {
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+            output_queue* queue = &sim.links[e];
+            memset(queue, 0, sizeof(*queue));
+            queue->delay_ns = graph.weights[e] * config->delay_ns;
+            queue->in_service = NONE;
+            ring_init(&queue->fifo);
+            if (config->policy == QUEUE_FAIR) {
+                queue->buckets = (desc_ring*)checked_realloc(NULL, QUEUE_FAIR_BUCKETS * sizeof(desc_ring));
+                queue->bucket_bytes = (long*)calloc(QUEUE_FAIR_BUCKETS, sizeof(long));
+                queue->deficit = (int*)calloc(QUEUE_FAIR_BUCKETS, sizeof(int));
+                if (queue->bucket_bytes == NULL || queue->deficit == NULL) {
+                    fprintf(stderr, "Memory allocation failed for queue simulation\n");
+                    exit(EXIT_FAILURE);
+                }
+                for (int b = 0; b < QUEUE_FAIR_BUCKETS; b++) {
+                    ring_init(&queue->buckets[b]);
+                }
+                ring_init(&queue->active);
+            }
+        }
+    }
+
+    heap_init(&sim.events, 4096);
+    for (int i = 0; i < sim.flow_count; i++) {
+        long long first = (long long)(-log(next_uniform(&sim)) / sim.flows[i].rate * 1e9);
+        if (first < (long long)(config->duration_s * 1e9)) {
+            schedule(&sim, first, EVENT_DATAGRAM, (uint32_t)i);
+        }
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    heap_entry event;
+    while (heap_pop(&sim.events, &event)) {
+        sim.now = event.key;
+        uint32_t id = (uint32_t)event.value >> EVENT_BITS;
+        switch (event.value & ((1 << EVENT_BITS) - 1)) {
+            case EVENT_DATAGRAM: send_datagram(&sim, (int)id); break;
+            case EVENT_TX_DONE:  finish_transmission(&sim, (int)id); break;
+            case EVENT_ARRIVAL:  arrive(&sim, id); break;
+        }
+        report->events++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    report->elapsed_seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    report->flows = sim.flow_count;
+    report->fragment_loss = report->fragments_sent ? (double)report->fragments_dropped / report->fragments_sent : 0;
+    report->datagram_loss = report->datagrams_sent
+                                ? 1.0 - (double)report->datagrams_delivered / report->datagrams_sent : 0;
+    report->amplification = report->fragment_loss > 0 ? report->datagram_loss / report->fragment_loss : 1.0;
+    report->goodput_bps = report->goodput_bytes * 8.0 / config->duration_s;
+    report->mean_delay_ms = report->datagrams_delivered ? sim.delay_total_ms / report->datagrams_delivered : 0;
+
+    // Flow 0 offers the most and the last flow the least
+    const flow_state* heavy = &sim.flows[0];
+    const flow_state* light = &sim.flows[sim.flow_count - 1];
+    report->heavy_flow_loss = heavy->sent ? 1.0 - (double)heavy->delivered / heavy->sent : 0;
+    report->light_flow_loss = light->sent ? 1.0 - (double)light->delivered / light->sent : 0;
+
+    for (int i = 0; i < sim.link_count; i++) {
+        output_queue* queue = &sim.links[i];
+        free(queue->fifo.slots);
+        if (config->policy == QUEUE_FAIR) {
+            for (int b = 0; b < QUEUE_FAIR_BUCKETS; b++) {
+                free(queue->buckets[b].slots);
+            }
+            free(queue->buckets);
+            free(queue->bucket_bytes);
+            free(queue->deficit);
+            free(queue->active.slots);
+        }
+    }
+    for (int i = 0; i < sim.flow_count; i++) {
+        free(sim.flows[i].links);
+    }
+    free(sim.links);
+    free(sim.flows);
+    free(sim.fragments);
+    free(sim.datagrams);
+    heap_free(&sim.events);
+    csr_free(&graph);
+    return 0;
+}
@@ -0,0 +1,71 @@
+/**
+ * ring.c
+ * Bounded lock-free single-producer/single-consumer ring buffer
+ */
+
+#include <stdlib.h>
+#include "../include/ring.h"
+
+bool spsc_ring_init(spsc_ring* ring, size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    ring->slots = (void**)calloc(size, sizeof(void*));
+    if (ring->slots == NULL) {
+        return false;
+    }
+
+    ring->mask = size - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    return true;
+}
+
+void spsc_ring_destroy(spsc_ring* ring)
+{
+    free(ring->slots);
+    ring->slots = NULL;
+}
+
+bool spsc_ring_push(spsc_ring* ring, void* item)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head - tail > ring->mask) {
+        return false; // full
+    }
+
+    ring->slots[head & ring->mask] = item;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return true;
+}
+
+void* spsc_ring_pop(spsc_ring* ring)
+{
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    if (tail == head) {
+        return NULL; // empty
+    }
+
+    void* item = ring->slots[tail & ring->mask];
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return item;
+}
+
+size_t spsc_ring_size(spsc_ring* ring)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return head - tail;
+}
+
+size_t spsc_ring_capacity(spsc_ring* ring)
+{
+    return ring->mask + 1;
+}
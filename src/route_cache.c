@@ -0,0 +1,344 @@
+/**
+ * route_cache.c
+ * Shared per-source shortest-path trees and compact route handles
+ *
+ * Trees are never modified: after a topology change new trees get new ids, so
+ * handles already held by in-flight fragments still expand to the route they
+ * were given. Each tree counts the handles issued for it; a superseded tree is
+ * freed when the last one is released and its id goes back on a free list, so
+ * the 16-bit id space is only exhausted by trees that are still referenced.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/route_cache.h"
+
+const route_handle ROUTE_HANDLE_NONE = { ROUTE_NO_TREE, 0 };
+
+// Keep a matrix copy of small, dense topologies for the vectorized Dijkstra
+static void select_dense(route_cache* cache)
+{
+    cache->use_dense = dense_preferred(cache->graph.node_count, cache->graph.edge_count);
+    if (cache->use_dense) {
+        dense_from_csr(&cache->dense, &cache->graph);
+    }
+}
+
+static void init_common(route_cache* cache)
+{
+    cache->node_count = cache->graph.node_count;
+    select_dense(cache);
+    cache->trees = NULL;
+    cache->tree_count = 0;
+    cache->tree_capacity = 0;
+    cache->free_ids = NULL;
+    cache->free_count = 0;
+    cache->full_reported = false;
+    cache->current = (int*)malloc((cache->node_count > 0 ? cache->node_count : 1) * sizeof(int));
+    if (cache->current == NULL) {
+        fprintf(stderr, "Memory allocation failed for route cache\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < cache->node_count; i++) {
+        cache->current[i] = -1;
+    }
+}
+
+void route_cache_init(route_cache* cache, network_topology* network)
+{
+    csr_from_topology(&cache->graph, network);
+    cache->owns_graph = 1;
+    init_common(cache);
+}
+
+void route_cache_init_csr(route_cache* cache, csr_graph* graph)
+{
+    cache->graph = *graph;
+    cache->owns_graph = 0;
+    init_common(cache);
+}
+
+void route_cache_free(route_cache* cache)
+{
+    for (int i = 0; i < cache->tree_count; i++) {
+        free(cache->trees[i].prev);
+    }
+    free(cache->trees);
+    free(cache->free_ids);
+    free(cache->current);
+    if (cache->owns_graph) {
+        csr_free(&cache->graph);
+    }
+    if (cache->use_dense) {
+        dense_free(&cache->dense);
+        cache->use_dense = false;
+    }
+    cache->trees = NULL;
+    cache->free_ids = NULL;
+    cache->current = NULL;
+    cache->tree_count = 0;
+    cache->free_count = 0;
+    cache->tree_capacity = 0;
+}
+
+// Rebuild the cache's graph (and matrix) from a topology with the same nodes
+static void replace_graph(route_cache* cache, network_topology* network)
+{
+    if (cache->owns_graph) {
+        csr_free(&cache->graph);
+    }
+    csr_from_topology(&cache->graph, network);
+    cache->owns_graph = 1;
+    if (cache->use_dense) {
+        dense_free(&cache->dense);
+    }
+    select_dense(cache);
+}
+
+// Free a tree that is neither current nor referenced and recycle its id
+static void collect_tree(route_cache* cache, int id)
+{
+    shortest_path_tree* tree = &cache->trees[id];
+    if (tree->source < 0 || tree->refs > 0 || cache->current[tree->source] == id) {
+        return;
+    }
+    free(tree->prev);
+    tree->prev = NULL;
+    tree->source = -1;
+    cache->free_ids[cache->free_count++] = id;
+}
+
+void route_cache_update(route_cache* cache, network_topology* network)
+{
+    replace_graph(cache, network);
+
+    for (int i = 0; i < cache->node_count; i++) {
+        cache->current[i] = -1;
+    }
+    for (int id = 0; id < cache->tree_count; id++) {
+        collect_tree(cache, id);
+    }
+}
+
+// Compute and store the tree of a source, returns its id or -1 if the cache is full
+static int build_tree(route_cache* cache, int source)
+{
+    if (cache->node_count > ROUTE_MAX_NODES) {
+        return -1;
+    }
+    if (cache->free_count == 0 && cache->tree_count >= ROUTE_NO_TREE) {
+        if (!cache->full_reported) {
+            fprintf(stderr, "Route cache full: %d trees are still referenced by handles\n", cache->tree_count);
+            cache->full_reported = true;
+        }
+        return -1;
+    }
+
+    if (cache->free_count == 0 && cache->tree_count == cache->tree_capacity) {
+        cache->tree_capacity = cache->tree_capacity ? cache->tree_capacity * 2 : 16;
+        cache->trees = (shortest_path_tree*)realloc(cache->trees,
+                                                    cache->tree_capacity * sizeof(shortest_path_tree));
+        cache->free_ids = (int*)realloc(cache->free_ids, cache->tree_capacity * sizeof(int));
+        if (cache->trees == NULL || cache->free_ids == NULL) {
+            fprintf(stderr, "Memory allocation failed for route cache\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    int n = cache->node_count;
+    int* dist = (int*)malloc(n * sizeof(int));
+    int* prev = (int*)malloc(n * sizeof(int));
+    uint16_t* compact = (uint16_t*)malloc(n * sizeof(uint16_t));
+    if (dist == NULL || prev == NULL || compact == NULL) {
+        fprintf(stderr, "Memory allocation failed for route cache\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (cache->use_dense) {
+        // Canonical predecessors give the same tree as dijkstra_csr()
+        dijkstra_dense(&cache->dense, source, -1, dist, prev, DENSE_KERNEL_AUTO, true);
+    } else {
+        dijkstra_csr(&cache->graph, source, dist, prev);
+    }
+    for (int v = 0; v < n; v++) {
+        compact[v] = (prev[v] < 0) ? ROUTE_NO_PREV : (uint16_t)prev[v];
+    }
+    free(dist);
+    free(prev);
+
+    int id = (cache->free_count > 0) ? cache->free_ids[--cache->free_count] : cache->tree_count++;
+    cache->trees[id].source = source;
+    cache->trees[id].refs = 0;
+    cache->trees[id].prev = compact;
+    cache->current[source] = id;
+    return id;
+}
+
+route_handle route_cache_lookup(route_cache* cache, int source, int destination)
+{
+    if (source < 0 || source >= cache->node_count ||
+        destination < 0 || destination >= cache->node_count) {
+        return ROUTE_HANDLE_NONE;
+    }
+
+    int id = cache->current[source];
+    if (id < 0) {
+        id = build_tree(cache, source);
+        if (id < 0) return ROUTE_HANDLE_NONE;
+    }
+
+    if (destination != source && cache->trees[id].prev[destination] == ROUTE_NO_PREV) {
+        return ROUTE_HANDLE_NONE; // unreachable
+    }
+
+    cache->trees[id].refs++;
+    route_handle route = { (uint16_t)id, (uint16_t)destination };
+    return route;
+}
+
+void route_cache_release(route_cache* cache, route_handle route)
+{
+    if (route.tree == ROUTE_NO_TREE || route.tree >= cache->tree_count ||
+        cache->trees[route.tree].refs <= 0) {
+        return;
+    }
+    cache->trees[route.tree].refs--;
+    collect_tree(cache, route.tree);
+}
+
+int route_path_length(const route_cache* cache, route_handle route)
+{
+    if (route.tree == ROUTE_NO_TREE || route.tree >= cache->tree_count ||
+        cache->trees[route.tree].source < 0) {
+        return -1;
+    }
+
+    const shortest_path_tree* tree = &cache->trees[route.tree];
+    int count = 1;
+    for (int node = route.destination; node != tree->source; node = tree->prev[node]) {
+        count++;
+    }
+    return count;
+}
+
+int route_expand_path(const route_cache* cache, route_handle route, int** path)
+{
+    int count = route_path_length(cache, route);
+    if (count < 0) {
+        return -1;
+    }
+
+    *path = (int*)malloc(count * sizeof(int));
+    if (*path == NULL) {
+        fprintf(stderr, "Memory allocation failed for path\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Walk the predecessors from the destination, filling the path backwards
+    const shortest_path_tree* tree = &cache->trees[route.tree];
+    int node = route.destination;
+    for (int index = count - 1; index >= 0; index--) {
+        (*path)[index] = node;
+        node = tree->prev[node];
+    }
+    return count;
+}
+
+long route_cache_memory(const route_cache* cache)
+{
+    return (long)(cache->tree_count - cache->free_count) * (sizeof(shortest_path_tree) + cache->node_count * sizeof(uint16_t));
+}
+
+// Weight of the lightest link u -> v in the cache's graph, 0 if none
+static int link_weight(const csr_graph* graph, int u, int v)
+{
+    int weight = 0;
+    for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+        if (graph->targets[e] == v && (weight == 0 || graph->weights[e] < weight)) {
+            weight = graph->weights[e];
+        }
+    }
+    return weight;
+}
+
+// Distances along a tree, GRAPH_UNREACHABLE for nodes it does not reach
+static void tree_distances(const route_cache* cache, const shortest_path_tree* tree, int* dist, int* stack)
+{
+    int n = cache->node_count;
+    for (int v = 0; v < n; v++) {
+        dist[v] = -1;
+    }
+    dist[tree->source] = 0;
+    for (int v = 0; v < n; v++) {
+        int top = 0;
+        int x = v;
+        while (dist[x] < 0 && tree->prev[x] != ROUTE_NO_PREV) {
+            stack[top++] = x;
+            x = tree->prev[x];
+        }
+        if (dist[x] < 0) dist[x] = GRAPH_UNREACHABLE;
+        while (top > 0) {
+            int y = stack[--top];
+            int parent = tree->prev[y];
+            dist[y] = (dist[parent] == GRAPH_UNREACHABLE) ? GRAPH_UNREACHABLE
+                                                          : dist[parent] + link_weight(&cache->graph, parent, y);
+        }
+    }
+}
+
+// A tree stays exact, canonical predecessors included, unless a change removes
+// or lengthens one of its links, or adds or shortens a link that is at least as
+// short as the tree's path
+static bool tree_affected(const shortest_path_tree* tree, const int* dist,
+                          const route_link_change* changes, int count)
+{
+    for (int i = 0; i < count; i++) {
+        const route_link_change* c = &changes[i];
+        if (c->old_weight > 0 && (c->new_weight == 0 || c->new_weight > c->old_weight) &&
+            tree->prev[c->to] == c->from) {
+            return true;
+        }
+        if (c->new_weight > 0 && (c->old_weight == 0 || c->new_weight < c->old_weight) &&
+            dist[c->from] != GRAPH_UNREACHABLE &&
+            (dist[c->to] == GRAPH_UNREACHABLE || (long long)dist[c->from] + c->new_weight <= dist[c->to])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int route_cache_update_links(route_cache* cache, network_topology* network,
+                             const route_link_change* changes, int count)
+{
+    int n = cache->node_count;
+    int* dist = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    int* stack = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    if (dist == NULL || stack == NULL) {
+        fprintf(stderr, "Memory allocation failed for route cache\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Decide against the old graph which trees the changes can alter
+    for (int source = 0; source < n; source++) {
+        int id = cache->current[source];
+        if (id < 0) continue;
+        tree_distances(cache, &cache->trees[id], dist, stack);
+        if (tree_affected(&cache->trees[id], dist, changes, count)) {
+            // Superseded: freed now unless a handle still holds it, the rebuild can take its id
+            cache->current[source] = -2;
+            collect_tree(cache, id);
+        }
+    }
+    free(dist);
+    free(stack);
+
+    replace_graph(cache, network);
+
+    int recomputed = 0;
+    for (int source = 0; source < n; source++) {
+        if (cache->current[source] != -2) continue;
+        cache->current[source] = -1;
+        if (build_tree(cache, source) >= 0) recomputed++;
+    }
+    return recomputed;
+}
@@ -0,0 +1,410 @@
+/**
+ * route_snapshot.c
+ * Binary snapshots of a topology and its shortest-path trees, used in place through mmap
+ *
+ * File layout: one header page, then the sections listed in snapshot_section_id,
+ * each starting on a page boundary. All sections are arrays of 32-bit words, so
+ * an open snapshot is nothing but pointers into the mapping: no parsing, and
+ * only the pages a lookup touches are ever read from disk.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/route_snapshot.h"
+
+#define FNV_OFFSET_BASIS 0xCBF29CE484222325ull
+#define FNV_PRIME        0x00000100000001B3ull
+#define BYTE_ORDER_MARK  0x01020304u
+
+_Static_assert(sizeof(route_snapshot_header) % sizeof(uint32_t) == 0, "header must be whole words");
+_Static_assert(sizeof(route_snapshot_header) <= ROUTE_SNAPSHOT_ALIGNMENT, "header must fit its page");
+
+// FNV-1a over 32-bit words instead of bytes: a quarter of the multiplications
+static uint64_t hash_words(uint64_t hash, const uint32_t* words, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        hash ^= words[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint64_t header_checksum(const route_snapshot_header* header)
+{
+    uint32_t words[sizeof(route_snapshot_header) / sizeof(uint32_t)];
+    route_snapshot_header copy = *header;
+    copy.header_checksum = 0;
+    memcpy(words, &copy, sizeof(copy));
+    return hash_words(FNV_OFFSET_BASIS, words, sizeof(words) / sizeof(uint32_t));
+}
+
+static uint64_t align_up(uint64_t value)
+{
+    return (value + ROUTE_SNAPSHOT_ALIGNMENT - 1) & ~(uint64_t)(ROUTE_SNAPSHOT_ALIGNMENT - 1);
+}
+
+// Section offsets, sizes and the file size implied by the counts in the header
+static void plan_layout(route_snapshot_header* header)
+{
+    uint64_t n = header->node_count;
+    uint64_t m = header->edge_count;
+    uint64_t t = header->tree_count;
+    uint64_t words[SNAPSHOT_SECTION_COUNT] = { n + 1, m, m, t, n, t * n, t * n };
+
+    uint64_t offset = ROUTE_SNAPSHOT_ALIGNMENT;   // the header page
+    for (int i = 0; i < SNAPSHOT_SECTION_COUNT; i++) {
+        header->sections[i].offset = offset;
+        header->sections[i].size = words[i] * sizeof(uint32_t);
+        offset = align_up(offset + header->sections[i].size);
+    }
+    header->file_size = offset;
+}
+
+uint64_t route_snapshot_topology_hash(const csr_graph* graph)
+{
+    uint32_t counts[2] = { (uint32_t)graph->node_count, (uint32_t)graph->edge_count };
+    uint64_t hash = hash_words(FNV_OFFSET_BASIS, counts, 2);
+    hash = hash_words(hash, (const uint32_t*)graph->offsets, (size_t)graph->node_count + 1);
+    hash = hash_words(hash, (const uint32_t*)graph->targets, graph->edge_count);
+    hash = hash_words(hash, (const uint32_t*)graph->weights, graph->edge_count);
+    return hash;
+}
+
+static int compare_sources(const void* a, const void* b)
+{
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+uint64_t route_snapshot_sources_hash(const int* sources, int source_count)
+{
+    int* sorted = (int*)malloc((source_count > 0 ? source_count : 1) * sizeof(int));
+    if (sorted == NULL) {
+        fprintf(stderr, "Memory allocation failed for route snapshot\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(sorted, sources, source_count * sizeof(int));
+    qsort(sorted, source_count, sizeof(int), compare_sources);
+
+    uint32_t count = (uint32_t)source_count;
+    uint64_t hash = hash_words(FNV_OFFSET_BASIS, &count, 1);
+    hash = hash_words(hash, (const uint32_t*)sorted, source_count);
+    free(sorted);
+    return hash;
+}
+
+// First hop from the source towards every node, from the predecessor array.
+// Each walk stops at the first node already resolved, so the whole pass is O(n)
+static void derive_next_hops(const int* prev, int source, int n, int* next, int* stack)
+{
+    for (int v = 0; v < n; v++) {
+        next[v] = -2;   // not resolved yet
+    }
+    next[source] = source;
+
+    for (int v = 0; v < n; v++) {
+        if (next[v] != -2) continue;
+        if (prev[v] < 0) {
+            next[v] = -1;   // unreachable
+            continue;
+        }
+
+        int depth = 0;
+        int u = v;
+        while (u != source && next[u] == -2) {
+            stack[depth++] = u;
+            u = prev[u];
+        }
+        int hop = (u == source) ? stack[depth - 1] : next[u];
+        while (depth > 0) {
+            next[stack[--depth]] = hop;
+        }
+    }
+}
+
+static bool write_at(FILE* file, uint64_t offset, const void* data, size_t bytes)
+{
+    if (bytes == 0) return true;
+    return fseeko(file, (off_t)offset, SEEK_SET) == 0 && fwrite(data, 1, bytes, file) == bytes;
+}
+
+static bool write_section(FILE* file, route_snapshot_header* header, snapshot_section_id id, const int* data)
+{
+    snapshot_section* section = &header->sections[id];
+    section->checksum = hash_words(FNV_OFFSET_BASIS, (const uint32_t*)data, section->size / sizeof(uint32_t));
+    return write_at(file, section->offset, data, section->size);
+}
+
+int route_snapshot_write(const char* path, csr_graph* graph, const int* sources, int source_count)
+{
+    int n = graph->node_count;
+    if (n < 1 || source_count < 0 || source_count > n) {
+        return ROUTE_SNAPSHOT_ERR_INVALID;
+    }
+
+    int* tree_index = (int*)malloc(n * sizeof(int));
+    int* dist = (int*)malloc(n * sizeof(int));
+    int* prev = (int*)malloc(n * sizeof(int));
+    int* next = (int*)malloc(n * sizeof(int));
+    int* stack = (int*)malloc(n * sizeof(int));
+    char* temp_path = (char*)malloc(strlen(path) + 5);
+    if (tree_index == NULL || dist == NULL || prev == NULL || next == NULL || stack == NULL || temp_path == NULL) {
+        fprintf(stderr, "Memory allocation failed for route snapshot\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int status = ROUTE_SNAPSHOT_OK;
+    memset(tree_index, 0xFF, n * sizeof(int));   // ROUTE_SNAPSHOT_NONE
+    for (int i = 0; i < source_count; i++) {
+        if (sources[i] < 0 || sources[i] >= n || tree_index[sources[i]] != -1) {
+            status = ROUTE_SNAPSHOT_ERR_INVALID;
+            break;
+        }
+        tree_index[sources[i]] = i;
+    }
+
+    FILE* file = NULL;
+    if (status == ROUTE_SNAPSHOT_OK) {
+        sprintf(temp_path, "%s.tmp", path);
+        file = fopen(temp_path, "wb");
+        if (file == NULL) status = ROUTE_SNAPSHOT_ERR_IO;
+    }
+
+    if (status == ROUTE_SNAPSHOT_OK) {
+        route_snapshot_header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, ROUTE_SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = ROUTE_SNAPSHOT_VERSION;
+        header.byte_order = BYTE_ORDER_MARK;
+        header.alignment = ROUTE_SNAPSHOT_ALIGNMENT;
+        header.node_count = (uint32_t)n;
+        header.edge_count = (uint32_t)graph->edge_count;
+        header.tree_count = (uint32_t)source_count;
+        header.max_weight = (uint32_t)graph->max_weight;
+        header.topology_hash = route_snapshot_topology_hash(graph);
+        header.sources_hash = route_snapshot_sources_hash(sources, source_count);
+        plan_layout(&header);
+
+        bool ok = write_section(file, &header, SNAPSHOT_OFFSETS, graph->offsets) &&
+                  write_section(file, &header, SNAPSHOT_TARGETS, graph->targets) &&
+                  write_section(file, &header, SNAPSHOT_WEIGHTS, graph->weights) &&
+                  write_section(file, &header, SNAPSHOT_SOURCES, sources) &&
+                  write_section(file, &header, SNAPSHOT_TREE_INDEX, tree_index);
+
+        // Trees are written a row at a time into both sections, so only one is in memory
+        uint64_t prev_hash = FNV_OFFSET_BASIS;
+        uint64_t next_hash = FNV_OFFSET_BASIS;
+        size_t row_bytes = (size_t)n * sizeof(int);
+        for (int t = 0; ok && t < source_count; t++) {
+            dijkstra_csr(graph, sources[t], dist, prev);
+            derive_next_hops(prev, sources[t], n, next, stack);
+            prev_hash = hash_words(prev_hash, (const uint32_t*)prev, n);
+            next_hash = hash_words(next_hash, (const uint32_t*)next, n);
+            ok = write_at(file, header.sections[SNAPSHOT_PREV].offset + t * row_bytes, prev, row_bytes) &&
+                 write_at(file, header.sections[SNAPSHOT_NEXT_HOP].offset + t * row_bytes, next, row_bytes);
+        }
+        header.sections[SNAPSHOT_PREV].checksum = prev_hash;
+        header.sections[SNAPSHOT_NEXT_HOP].checksum = next_hash;
+        header.header_checksum = header_checksum(&header);
+
+        // Header last: a file cut short by a crash never carries a valid one
+        ok = ok && write_at(file, 0, &header, sizeof(header)) && fflush(file) == 0 &&
+             ftruncate(fileno(file), (off_t)header.file_size) == 0;
+        if (fclose(file) != 0) ok = false;
+        if (ok && rename(temp_path, path) != 0) ok = false;
+        if (!ok) {
+            remove(temp_path);
+            status = ROUTE_SNAPSHOT_ERR_IO;
+        }
+    }
+
+    free(tree_index);
+    free(dist);
+    free(prev);
+    free(next);
+    free(stack);
+    free(temp_path);
+    return status;
+}
+
+// Everything but the section contents: identity, header checksum and exact layout
+static int check_header(const route_snapshot_header* header, uint64_t file_size)
+{
+    if (memcmp(header->magic, ROUTE_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != ROUTE_SNAPSHOT_VERSION || header->byte_order != BYTE_ORDER_MARK ||
+        header->alignment != ROUTE_SNAPSHOT_ALIGNMENT || header->header_checksum != header_checksum(header)) {
+        return ROUTE_SNAPSHOT_ERR_INVALID;
+    }
+    if (header->node_count < 1 || header->node_count >= 0x7FFFFFFFu ||
+        header->edge_count > 0x7FFFFFFFu || header->tree_count > header->node_count) {
+        return ROUTE_SNAPSHOT_ERR_INVALID;
+    }
+
+    route_snapshot_header expected = *header;
+    plan_layout(&expected);
+    for (int i = 0; i < SNAPSHOT_SECTION_COUNT; i++) {
+        if (header->sections[i].offset != expected.sections[i].offset ||
+            header->sections[i].size != expected.sections[i].size) {
+            return ROUTE_SNAPSHOT_ERR_INVALID;
+        }
+    }
+    if (header->file_size != expected.file_size || header->file_size != file_size) {
+        return ROUTE_SNAPSHOT_ERR_INVALID;
+    }
+    return ROUTE_SNAPSHOT_OK;
+}
+
+int route_snapshot_open(route_snapshot* snapshot, const char* path, uint64_t topology_hash, bool verify_data)
+{
+    memset(snapshot, 0, sizeof(*snapshot));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return ROUTE_SNAPSHOT_ERR_IO;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return ROUTE_SNAPSHOT_ERR_IO;
+    }
+    if ((uint64_t)info.st_size < ROUTE_SNAPSHOT_ALIGNMENT) {
+        close(fd);
+        return ROUTE_SNAPSHOT_ERR_INVALID;
+    }
+
+    void* map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return ROUTE_SNAPSHOT_ERR_IO;
+    }
+
+    const route_snapshot_header* header = (const route_snapshot_header*)map;
+    const char* base = (const char*)map;
+    int status = check_header(header, (uint64_t)info.st_size);
+    if (status == ROUTE_SNAPSHOT_OK && topology_hash != ROUTE_SNAPSHOT_ANY_TOPOLOGY &&
+        header->topology_hash != topology_hash) {
+        status = ROUTE_SNAPSHOT_ERR_STALE;
+    }
+    for (int i = 0; status == ROUTE_SNAPSHOT_OK && verify_data && i < SNAPSHOT_SECTION_COUNT; i++) {
+        const snapshot_section* section = &header->sections[i];
+        const uint32_t* words = (const uint32_t*)(base + section->offset);
+        if (hash_words(FNV_OFFSET_BASIS, words, section->size / sizeof(uint32_t)) != section->checksum) {
+            status = ROUTE_SNAPSHOT_ERR_CHECKSUM;
+        }
+    }
+    if (status != ROUTE_SNAPSHOT_OK) {
+        munmap(map, (size_t)info.st_size);
+        return status;
+    }
+
+    snapshot->map = map;
+    snapshot->map_size = (size_t)info.st_size;
+    snapshot->header = header;
+    snapshot->node_count = (int)header->node_count;
+    snapshot->tree_count = (int)header->tree_count;
+    snapshot->graph.node_count = (int)header->node_count;
+    snapshot->graph.edge_count = (int)header->edge_count;
+    snapshot->graph.max_weight = (int)header->max_weight;
+    snapshot->graph.offsets = (int*)(base + header->sections[SNAPSHOT_OFFSETS].offset);
+    snapshot->graph.targets = (int*)(base + header->sections[SNAPSHOT_TARGETS].offset);
+    snapshot->graph.weights = (int*)(base + header->sections[SNAPSHOT_WEIGHTS].offset);
+    snapshot->sources = (const uint32_t*)(base + header->sections[SNAPSHOT_SOURCES].offset);
+    snapshot->tree_index = (const uint32_t*)(base + header->sections[SNAPSHOT_TREE_INDEX].offset);
+    snapshot->prev = (const uint32_t*)(base + header->sections[SNAPSHOT_PREV].offset);
+    snapshot->next_hop = (const uint32_t*)(base + header->sections[SNAPSHOT_NEXT_HOP].offset);
+    return ROUTE_SNAPSHOT_OK;
+}
+
+void route_snapshot_close(route_snapshot* snapshot)
+{
+    if (snapshot->map != NULL) {
+        munmap(snapshot->map, snapshot->map_size);
+    }
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+int route_snapshot_load_or_build(route_snapshot* snapshot, const char* path, csr_graph* graph,
+                                 const int* sources, int source_count, bool* rebuilt)
+{
+    uint64_t hash = route_snapshot_topology_hash(graph);
+    int status = route_snapshot_open(snapshot, path, hash, false);
+    // Trees of other sources are of no use even on the same topology
+    if (status == ROUTE_SNAPSHOT_OK &&
+        snapshot->header->sources_hash != route_snapshot_sources_hash(sources, source_count)) {
+        route_snapshot_close(snapshot);
+        status = ROUTE_SNAPSHOT_ERR_STALE;
+    }
+    if (rebuilt != NULL) *rebuilt = (status != ROUTE_SNAPSHOT_OK);
+    if (status == ROUTE_SNAPSHOT_OK) {
+        return status;
+    }
+
+    status = route_snapshot_write(path, graph, sources, source_count);
+    if (status != ROUTE_SNAPSHOT_OK) {
+        return status;
+    }
+    return route_snapshot_open(snapshot, path, hash, false);
+}
+
+const char* route_snapshot_error(int status)
+{
+    switch (status) {
+        case ROUTE_SNAPSHOT_OK:           return "ok";
+        case ROUTE_SNAPSHOT_ERR_IO:       return "cannot access snapshot file";
+        case ROUTE_SNAPSHOT_ERR_INVALID:  return "not a valid snapshot";
+        case ROUTE_SNAPSHOT_ERR_CHECKSUM: return "snapshot data is corrupted";
+        case ROUTE_SNAPSHOT_ERR_STALE:    return "snapshot was built for another topology or source set";
+        default:                          return "unknown error";
+    }
+}
+
+int route_snapshot_next_hop(const route_snapshot* snapshot, int router, int destination)
+{
+    if (router < 0 || router >= snapshot->node_count || destination < 0 || destination >= snapshot->node_count) {
+        return -1;
+    }
+    // Out-of-range words can only come from an unverified, damaged file
+    uint32_t tree = snapshot->tree_index[router];
+    if (tree >= (uint32_t)snapshot->tree_count) {
+        return -1;
+    }
+    uint32_t hop = snapshot->next_hop[(size_t)tree * snapshot->node_count + destination];
+    return (hop >= (uint32_t)snapshot->node_count) ? -1 : (int)hop;
+}
+
+int route_snapshot_path(const route_snapshot* snapshot, int source, int destination, int** path)
+{
+    int n = snapshot->node_count;
+    if (source < 0 || source >= n || destination < 0 || destination >= n ||
+        snapshot->tree_index[source] >= (uint32_t)snapshot->tree_count) {
+        return -1;
+    }
+    const uint32_t* prev = snapshot->prev + (size_t)snapshot->tree_index[source] * n;
+
+    // Count first; a walk longer than the node count means an unverified, damaged file
+    int count = 1;
+    for (uint32_t node = (uint32_t)destination; node != (uint32_t)source; node = prev[node]) {
+        if (prev[node] >= (uint32_t)n || count >= n) {
+            return -1;
+        }
+        count++;
+    }
+
+    *path = (int*)malloc(count * sizeof(int));
+    if (*path == NULL) {
+        fprintf(stderr, "Memory allocation failed for path\n");
+        exit(EXIT_FAILURE);
+    }
+    uint32_t node = (uint32_t)destination;
+    for (int index = count - 1; index >= 0; index--) {
+        (*path)[index] = (int)node;
+        node = prev[node];
+    }
+    return count;
+}
@@ -0,0 +1,394 @@
+/**
+ * session_log.c
+ * Record and replay of interactive sessions: every input and topology event in a binary log
+ *
+ * The log is an 8-byte magic and a version byte followed by tagged records:
+ * inputs as zigzag varints (most take two bytes), topology snapshots as varint
+ * link lists, and a trailer holding the digest of the recorded run. A replay
+ * reads the same records back in order, so it takes the same path through the
+ * program without waiting for anybody, and compares its digest at the end.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../include/session_log.h"
+
+#define SESSION_MAGIC   "IPFRSESS"
+#define SESSION_VERSION 1
+
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME  1099511628211ULL
+
+// Record tags
+enum {
+    TAG_INT      = 'i',
+    TAG_CHAR     = 'c',
+    TAG_WORD     = 'w',
+    TAG_FAIL     = 'x',   // the read returned no value
+    TAG_TOPOLOGY = 't',
+    TAG_END      = 'e'
+};
+
+typedef struct session_state {
+    session_mode  mode;
+    FILE*         log;
+    char          path[256];
+    int           saved_stdout;   // stdout while replaying, -1 otherwise
+    long          inputs;
+    long          topology_events;
+    uint64_t      digest;
+    bool          diverged;
+    session_phase phase;
+    double        phase_start;
+    double        start;
+    double        phase_seconds[SESSION_PHASE_COUNT];
+} session_state;
+
+static session_state session = { .mode = SESSION_LIVE, .saved_stdout = -1, .digest = FNV_OFFSET };
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void write_varint(uint64_t value)
+{
+    while (value >= 0x80) {
+        fputc((int)(value & 0x7F) | 0x80, session.log);
+        value >>= 7;
+    }
+    fputc((int)value, session.log);
+}
+
+static bool read_varint(uint64_t* value)
+{
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = fgetc(session.log);
+        if (byte == EOF) return false;
+        *value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+static void write_int(int value)
+{
+    write_varint(((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+static bool read_int(int* value)
+{
+    uint64_t raw;
+    if (!read_varint(&raw)) return false;
+    *value = (int)((uint32_t)(raw >> 1) ^ -(uint32_t)(raw & 1));
+    return true;
+}
+
+static void restore_stdout(void)
+{
+    if (session.saved_stdout >= 0) {
+        fflush(stdout);
+        dup2(session.saved_stdout, STDOUT_FILENO);
+        close(session.saved_stdout);
+        session.saved_stdout = -1;
+    }
+}
+
+// A replay that no longer matches the program cannot go on
+static void replay_failed(const char* what)
+{
+    restore_stdout();
+    fprintf(stderr, "Replay of %s failed after %ld inputs: %s\n", session.path, session.inputs, what);
+    exit(EXIT_FAILURE);
+}
+
+static void start(session_mode mode, FILE* log, const char* path)
+{
+    session.mode = mode;
+    session.log = log;
+    snprintf(session.path, sizeof(session.path), "%s", path);
+    session.inputs = 0;
+    session.topology_events = 0;
+    session.digest = FNV_OFFSET;
+    session.diverged = false;
+    memset(session.phase_seconds, 0, sizeof(session.phase_seconds));
+    session.phase = SESSION_PHASE_SETUP;
+    session.start = now_seconds();
+    session.phase_start = session.start;
+}
+
+int session_record_start(const char* path)
+{
+    FILE* log = fopen(path, "wb");
+    if (log == NULL) {
+        return -1;
+    }
+    fwrite(SESSION_MAGIC, 1, 8, log);
+    fputc(SESSION_VERSION, log);
+    start(SESSION_RECORD, log, path);
+    return 0;
+}
+
+int session_replay_start(const char* path)
+{
+    FILE* log = fopen(path, "rb");
+    if (log == NULL) {
+        return -1;
+    }
+    char magic[8];
+    if (fread(magic, 1, 8, log) != 8 || memcmp(magic, SESSION_MAGIC, 8) != 0 ||
+        fgetc(log) != SESSION_VERSION) {
+        fclose(log);
+        return -1;
+    }
+
+    fflush(stdout);
+    int null_fd = open("/dev/null", O_WRONLY);
+    session.saved_stdout = dup(STDOUT_FILENO);
+    if (null_fd < 0 || session.saved_stdout < 0) {
+        fprintf(stderr, "Cannot redirect output for replay\n");
+        exit(EXIT_FAILURE);
+    }
+    dup2(null_fd, STDOUT_FILENO);
+    close(null_fd);
+    start(SESSION_REPLAY, log, path);
+    return 0;
+}
+
+// Next input record of a replay: its tag if it is `tag`, TAG_FAIL for a failed read
+static int replay_tag(int tag)
+{
+    int found = fgetc(session.log);
+    if (found == EOF || found == TAG_END) {
+        replay_failed("the log has no more inputs");
+    }
+    if (found != tag && found != TAG_FAIL) {
+        replay_failed("the program asked for another kind of input than was recorded");
+    }
+    session.inputs++;
+    return found;
+}
+
+int session_read_int(int* value)
+{
+    if (session.mode == SESSION_REPLAY) {
+        if (replay_tag(TAG_INT) == TAG_FAIL) return 0;
+        if (!read_int(value)) replay_failed("truncated input");
+        return 1;
+    }
+
+    int read = scanf("%d", value);
+    if (session.mode == SESSION_RECORD) {
+        session.inputs++;
+        if (read == 1) {
+            fputc(TAG_INT, session.log);
+            write_int(*value);
+        } else {
+            fputc(TAG_FAIL, session.log);
+        }
+    }
+    return read == 1;
+}
+
+int session_read_char(char* value)
+{
+    if (session.mode == SESSION_REPLAY) {
+        if (replay_tag(TAG_CHAR) == TAG_FAIL) return 0;
+        int c = fgetc(session.log);
+        if (c == EOF) replay_failed("truncated input");
+        *value = (char)c;
+        return 1;
+    }
+
+    int read = scanf(" %c", value);
+    if (session.mode == SESSION_RECORD) {
+        session.inputs++;
+        if (read == 1) {
+            fputc(TAG_CHAR, session.log);
+            fputc((unsigned char)*value, session.log);
+        } else {
+            fputc(TAG_FAIL, session.log);
+        }
+    }
+    return read == 1;
+}
+
+int session_read_word(char* buffer, int size)
+{
+    if (session.mode == SESSION_REPLAY) {
+        if (replay_tag(TAG_WORD) == TAG_FAIL) return 0;
+        uint64_t length;
+        if (!read_varint(&length) || length >= (uint64_t)size ||
+            fread(buffer, 1, (size_t)length, session.log) != (size_t)length) {
+            replay_failed("truncated input");
+        }
+        buffer[length] = '\0';
+        return 1;
+    }
+
+    char format[16];
+    snprintf(format, sizeof(format), "%%%ds", size - 1);
+    int read = scanf(format, buffer);
+    if (session.mode == SESSION_RECORD) {
+        session.inputs++;
+        if (read == 1) {
+            size_t length = strlen(buffer);
+            fputc(TAG_WORD, session.log);
+            write_varint(length);
+            fwrite(buffer, 1, length, session.log);
+        } else {
+            fputc(TAG_FAIL, session.log);
+        }
+    }
+    return read == 1;
+}
+
+void session_digest(const void* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        session.digest = (session.digest ^ bytes[i]) * FNV_PRIME;
+    }
+}
+
+// Does the next record of a replay hold exactly this topology
+static bool replay_topology_matches(const network_topology* network, int links)
+{
+    int c = fgetc(session.log);
+    if (c != TAG_TOPOLOGY) {
+        if (c != EOF) ungetc(c, session.log);
+        return false;
+    }
+    int node_count, count;
+    if (!read_int(&node_count) || !read_int(&count)) replay_failed("truncated topology");
+    bool same = (node_count == network->node_count) && (count == links);
+    for (int i = 0; i < count; i++) {
+        int from, to, weight;
+        if (!read_int(&from) || !read_int(&to) || !read_int(&weight)) replay_failed("truncated topology");
+        same = same && from >= 0 && from < MAX_NODES && to >= 0 && to < MAX_NODES &&
+               network->graph[from][to] == weight;
+    }
+    return same;
+}
+
+void session_topology(const network_topology* network)
+{
+    int links = 0;
+    for (int i = 0; i < network->node_count; i++) {
+        for (int j = 0; j < network->node_count; j++) {
+            if (network->graph[i][j] > 0) links++;
+        }
+    }
+    session.topology_events++;
+    session_digest(&network->node_count, sizeof(network->node_count));
+    for (int i = 0; i < network->node_count; i++) {
+        session_digest(network->graph[i], network->node_count * sizeof(int));
+    }
+
+    if (session.mode == SESSION_RECORD) {
+        fputc(TAG_TOPOLOGY, session.log);
+        write_int(network->node_count);
+        write_int(links);
+        for (int i = 0; i < network->node_count; i++) {
+            for (int j = 0; j < network->node_count; j++) {
+                if (network->graph[i][j] == 0) continue;
+                write_int(i);
+                write_int(j);
+                write_int(network->graph[i][j]);
+            }
+        }
+    } else if (session.mode == SESSION_REPLAY && !replay_topology_matches(network, links)) {
+        session.diverged = true;
+    }
+}
+
+// Consume the body of a record, false if it is malformed
+static bool skip_record(int tag)
+{
+    int value, count;
+    uint64_t length;
+    switch (tag) {
+        case TAG_INT:
+            return read_int(&value);
+        case TAG_CHAR:
+            return fgetc(session.log) != EOF;
+        case TAG_WORD:
+            return read_varint(&length) && fseek(session.log, (long)length, SEEK_CUR) == 0;
+        case TAG_FAIL:
+            return true;
+        case TAG_TOPOLOGY:
+            if (!read_int(&value) || !read_int(&count)) return false;
+            for (int i = 0; i < 3 * count; i++) {
+                if (!read_int(&value)) return false;
+            }
+            return true;
+    }
+    return false;
+}
+
+void session_set_phase(session_phase phase)
+{
+    double now = now_seconds();
+    session.phase_seconds[session.phase] += now - session.phase_start;
+    session.phase = phase;
+    session.phase_start = now;
+}
+
+int session_finish(session_report* report)
+{
+    session_set_phase(session.phase);
+    memset(report, 0, sizeof(*report));
+    report->mode = session.mode;
+    report->total_seconds = now_seconds() - session.start;
+    memcpy(report->phase_seconds, session.phase_seconds, sizeof(report->phase_seconds));
+
+    if (session.mode == SESSION_RECORD) {
+        fputc(TAG_END, session.log);
+        for (int i = 0; i < 8; i++) {
+            fputc((int)(session.digest >> (8 * i)) & 0xFF, session.log);
+        }
+        report->recorded_digest = session.digest;
+    } else if (session.mode == SESSION_REPLAY) {
+        // Records the program no longer asked for also mean the run took another path
+        int c;
+        while ((c = fgetc(session.log)) != EOF && c != TAG_END) {
+            session.diverged = true;
+            if (!skip_record(c)) {
+                c = EOF;
+                break;
+            }
+        }
+        for (int i = 0; i < 8 && c != EOF; i++) {
+            int byte = fgetc(session.log);
+            if (byte == EOF) {
+                c = EOF;
+                break;
+            }
+            report->recorded_digest |= (uint64_t)byte << (8 * i);
+        }
+        if (c == EOF) {
+            session.diverged = true;   // no trailer: the recording was cut short
+        }
+        session.diverged = session.diverged || report->recorded_digest != session.digest;
+        restore_stdout();
+    }
+
+    if (session.log != NULL) {
+        report->log_bytes = ftell(session.log);
+        fclose(session.log);
+        session.log = NULL;
+    }
+    report->inputs = session.inputs;
+    report->topology_events = session.topology_events;
+    report->digest = session.digest;
+    report->diverged = session.diverged;
+    session.mode = SESSION_LIVE;
+    return report->diverged ? -1 : 0;
+}
@@ -0,0 +1,384 @@
+/**
+ * topology_rcu.c
+ * Versioned immutable topology snapshots with read-copy-update publication
+ *
+ * Writers never modify a published version. A batch of changes copies only
+ * the adjacency blocks it touches, shares every other block with the
+ * previous version, and publishes the result with one atomic pointer store.
+ * Readers announce the global epoch before loading the pointer; a retired
+ * version is freed once every pinned reader has announced a later epoch.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/heap.h"
+#include "../include/topology_rcu.h"
+
+typedef struct indexed_change {
+    topology_change change;
+    int             order;  // position in the batch, later changes win
+} indexed_change;
+
+static adjacency_block* alloc_block(int edge_count)
+{
+    adjacency_block* block = (adjacency_block*)malloc(sizeof(adjacency_block));
+    int* edges = (int*)malloc(2 * (edge_count > 0 ? edge_count : 1) * sizeof(int));
+    if (block == NULL || edges == NULL) {
+        fprintf(stderr, "Memory allocation failed for topology block\n");
+        exit(EXIT_FAILURE);
+    }
+    block->refcount = 1;
+    block->targets = edges;
+    block->weights = edges + (edge_count > 0 ? edge_count : 1);
+    return block;
+}
+
+static void release_block(adjacency_block* block)
+{
+    if (--block->refcount == 0) {
+        free(block->targets);
+        free(block);
+    }
+}
+
+static topology_version* alloc_version(int node_count)
+{
+    topology_version* version = (topology_version*)malloc(sizeof(topology_version));
+    if (version == NULL) {
+        fprintf(stderr, "Memory allocation failed for topology version\n");
+        exit(EXIT_FAILURE);
+    }
+    version->node_count = node_count;
+    version->block_count = (node_count + TOPOLOGY_BLOCK_NODES - 1) / TOPOLOGY_BLOCK_NODES;
+    version->blocks = (adjacency_block**)malloc((version->block_count > 0 ? version->block_count : 1) *
+                                                sizeof(adjacency_block*));
+    if (version->blocks == NULL) {
+        fprintf(stderr, "Memory allocation failed for topology version\n");
+        exit(EXIT_FAILURE);
+    }
+    version->retire_epoch = 0;
+    version->next_retired = NULL;
+    return version;
+}
+
+static void free_version(topology_version* version)
+{
+    for (int b = 0; b < version->block_count; b++) {
+        release_block(version->blocks[b]);
+    }
+    free(version->blocks);
+    free(version);
+}
+
+static void init_store(topology_store* store, topology_version* first)
+{
+    first->version = 1;
+    atomic_init(&store->current, first);
+    atomic_init(&store->global_epoch, 1);
+    atomic_init(&store->reader_count, 0);
+    for (int i = 0; i < RCU_MAX_READERS; i++) {
+        atomic_init(&store->readers[i].epoch, 0);
+    }
+    pthread_mutex_init(&store->writer_lock, NULL);
+    store->retired = NULL;
+    store->published = 1;
+    store->reclaimed = 0;
+    store->blocks_copied = 0;
+}
+
+void topology_store_init_csr(topology_store* store, csr_graph* graph)
+{
+    topology_version* first = alloc_version(graph->node_count);
+
+    for (int b = 0; b < first->block_count; b++) {
+        int base = b * TOPOLOGY_BLOCK_NODES;
+        int end = (base + TOPOLOGY_BLOCK_NODES < graph->node_count) ? base + TOPOLOGY_BLOCK_NODES
+                                                                   : graph->node_count;
+        int first_edge = graph->offsets[base];
+        adjacency_block* block = alloc_block(graph->offsets[end] - first_edge);
+
+        for (int i = 0; i <= TOPOLOGY_BLOCK_NODES; i++) {
+            int node = (base + i < end) ? base + i : end;
+            block->offsets[i] = graph->offsets[node] - first_edge;
+        }
+        memcpy(block->targets, graph->targets + first_edge, (graph->offsets[end] - first_edge) * sizeof(int));
+        memcpy(block->weights, graph->weights + first_edge, (graph->offsets[end] - first_edge) * sizeof(int));
+        first->blocks[b] = block;
+    }
+
+    init_store(store, first);
+}
+
+void topology_store_init(topology_store* store, network_topology* network)
+{
+    csr_graph graph;
+    csr_from_topology(&graph, network);
+    topology_store_init_csr(store, &graph);
+    csr_free(&graph);
+}
+
+void topology_store_destroy(topology_store* store)
+{
+    while (store->retired != NULL) {
+        topology_version* next = store->retired->next_retired;
+        free_version(store->retired);
+        store->retired = next;
+    }
+    free_version(atomic_load(&store->current));
+    pthread_mutex_destroy(&store->writer_lock);
+}
+
+int topology_register_reader(topology_store* store)
+{
+    int slot = atomic_fetch_add(&store->reader_count, 1);
+    if (slot >= RCU_MAX_READERS) {
+        atomic_fetch_sub(&store->reader_count, 1);
+        return -1;
+    }
+    return slot;
+}
+
+const topology_version* topology_read_lock(topology_store* store, int reader)
+{
+    // Announce before loading: a writer that misses the announcement has
+    // already published, so the load below sees the newer version
+    unsigned long epoch = atomic_load(&store->global_epoch);
+    atomic_store(&store->readers[reader].epoch, epoch);
+    return atomic_load(&store->current);
+}
+
+void topology_read_unlock(topology_store* store, int reader)
+{
+    atomic_store_explicit(&store->readers[reader].epoch, 0, memory_order_release);
+}
+
+static int compare_changes(const void* a, const void* b)
+{
+    const indexed_change* x = (const indexed_change*)a;
+    const indexed_change* y = (const indexed_change*)b;
+    if (x->change.from != y->change.from) return (x->change.from < y->change.from) ? -1 : 1;
+    return x->order - y->order;
+}
+
+// Copy a block applying the (sorted) changes whose source node lies in it
+static adjacency_block* rewrite_block(const topology_version* old, int block_index,
+                                      const indexed_change* changes, int count)
+{
+    adjacency_block* source = old->blocks[block_index];
+    int base = block_index * TOPOLOGY_BLOCK_NODES;
+
+    // Every change can add at most one edge
+    int capacity = source->offsets[TOPOLOGY_BLOCK_NODES] + count;
+    adjacency_block* block = alloc_block(capacity);
+
+    int e = 0;
+    int c = 0;
+    for (int i = 0; i < TOPOLOGY_BLOCK_NODES; i++) {
+        int row_start = e;
+        block->offsets[i] = e;
+
+        for (int k = source->offsets[i]; k < source->offsets[i + 1]; k++) {
+            block->targets[e] = source->targets[k];
+            block->weights[e] = source->weights[k];
+            e++;
+        }
+
+        for (; c < count && changes[c].change.from == base + i; c++) {
+            const topology_change* change = &changes[c].change;
+            int k = row_start;
+            while (k < e && block->targets[k] != change->to) k++;
+
+            if (k < e && change->weight > 0) {
+                block->weights[k] = change->weight;
+            } else if (k < e) {
+                // Remove by shifting the rest of the row down
+                memmove(&block->targets[k], &block->targets[k + 1], (e - k - 1) * sizeof(int));
+                memmove(&block->weights[k], &block->weights[k + 1], (e - k - 1) * sizeof(int));
+                e--;
+            } else if (change->weight > 0) {
+                block->targets[e] = change->to;
+                block->weights[e] = change->weight;
+                e++;
+            }
+        }
+    }
+    block->offsets[TOPOLOGY_BLOCK_NODES] = e;
+    return block;
+}
+
+// Free retired versions no pinned reader can still see; the caller holds writer_lock
+static int reclaim_retired(topology_store* store)
+{
+    // Oldest epoch any pinned reader may still be using
+    unsigned long oldest = atomic_load(&store->global_epoch);
+    int readers = atomic_load(&store->reader_count);
+    for (int i = 0; i < readers && i < RCU_MAX_READERS; i++) {
+        unsigned long epoch = atomic_load(&store->readers[i].epoch);
+        if (epoch != 0 && epoch < oldest) oldest = epoch;
+    }
+
+    int freed = 0;
+    topology_version** link = &store->retired;
+    while (*link != NULL) {
+        topology_version* version = *link;
+        if (version->retire_epoch < oldest) {
+            *link = version->next_retired;
+            free_version(version);
+            freed++;
+        } else {
+            link = &version->next_retired;
+        }
+    }
+    store->reclaimed += freed;
+    return freed;
+}
+
+unsigned long topology_store_apply(topology_store* store, const topology_change* changes, int count)
+{
+    topology_version* old = atomic_load_explicit(&store->current, memory_order_acquire);
+
+    for (int i = 0; i < count; i++) {
+        if (changes[i].from < 0 || changes[i].from >= old->node_count ||
+            changes[i].to < 0 || changes[i].to >= old->node_count ||
+            changes[i].weight < 0) {
+            return 0;
+        }
+    }
+
+    indexed_change* sorted = (indexed_change*)malloc((count > 0 ? count : 1) * sizeof(indexed_change));
+    if (sorted == NULL) {
+        fprintf(stderr, "Memory allocation failed for topology changes\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < count; i++) {
+        sorted[i].change = changes[i];
+        sorted[i].order = i;
+    }
+    qsort(sorted, count, sizeof(indexed_change), compare_changes);
+
+    pthread_mutex_lock(&store->writer_lock);
+    old = atomic_load_explicit(&store->current, memory_order_acquire);
+
+    topology_version* next = alloc_version(old->node_count);
+    next->version = old->version + 1;
+
+    int c = 0;
+    for (int b = 0; b < old->block_count; b++) {
+        int end = c;
+        while (end < count && sorted[end].change.from / TOPOLOGY_BLOCK_NODES == b) end++;
+
+        if (end > c) {
+            next->blocks[b] = rewrite_block(old, b, &sorted[c], end - c);
+            store->blocks_copied++;
+        } else {
+            next->blocks[b] = old->blocks[b];
+            next->blocks[b]->refcount++;
+        }
+        c = end;
+    }
+
+    atomic_store(&store->current, next);
+    old->retire_epoch = atomic_fetch_add(&store->global_epoch, 1);
+    old->next_retired = store->retired;
+    store->retired = old;
+    store->published++;
+
+    reclaim_retired(store);
+    pthread_mutex_unlock(&store->writer_lock);
+
+    free(sorted);
+    return next->version;
+}
+
+int topology_store_reclaim(topology_store* store)
+{
+    pthread_mutex_lock(&store->writer_lock);
+    int freed = reclaim_retired(store);
+    pthread_mutex_unlock(&store->writer_lock);
+    return freed;
+}
+
+int topology_version_weight(const topology_version* version, int from, int to)
+{
+    if (from < 0 || from >= version->node_count) {
+        return 0;
+    }
+
+    const adjacency_block* block = version->blocks[from / TOPOLOGY_BLOCK_NODES];
+    int local = from % TOPOLOGY_BLOCK_NODES;
+    for (int e = block->offsets[local]; e < block->offsets[local + 1]; e++) {
+        if (block->targets[e] == to) return block->weights[e];
+    }
+    return 0;
+}
+
+int topology_version_route(const topology_version* version, int source, int destination, int** path)
+{
+    int n = version->node_count;
+    if (source < 0 || source >= n || destination < 0 || destination >= n) {
+        return -1;
+    }
+
+    int* dist = (int*)malloc(n * sizeof(int));
+    int* prev = (int*)malloc(n * sizeof(int));
+    if (dist == NULL || prev == NULL) {
+        fprintf(stderr, "Memory allocation failed in snapshot routing\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++) {
+        dist[i] = GRAPH_UNREACHABLE;
+        prev[i] = -1;
+    }
+
+    min_heap heap;
+    heap_init(&heap, 256);
+    dist[source] = 0;
+    heap_push(&heap, 0, source);
+
+    heap_entry top;
+    while (heap_pop(&heap, &top)) {
+        int u = top.value;
+        if (top.key != dist[u]) continue;
+        if (u == destination) break;
+
+        const adjacency_block* block = version->blocks[u / TOPOLOGY_BLOCK_NODES];
+        int local = u % TOPOLOGY_BLOCK_NODES;
+        for (int e = block->offsets[local]; e < block->offsets[local + 1]; e++) {
+            int v = block->targets[e];
+            long long candidate = top.key + block->weights[e];
+            if (candidate < dist[v]) {
+                dist[v] = (int)candidate;
+                prev[v] = u;
+                heap_push(&heap, candidate, v);
+            }
+        }
+    }
+    heap_free(&heap);
+
+    if (dist[destination] == GRAPH_UNREACHABLE) {
+        free(dist);
+        free(prev);
+        return -1;
+    }
+
+    int count = 1;
+    for (int current = destination; current != source; current = prev[current]) {
+        count++;
+    }
+
+    *path = (int*)malloc(count * sizeof(int));
+    if (*path == NULL) {
+        fprintf(stderr, "Memory allocation failed for path\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int index = count - 1;
+    for (int current = destination; index >= 0; current = prev[current]) {
+        (*path)[index--] = current;
+    }
+
+    free(dist);
+    free(prev);
+    return count;
+}
@@ -0,0 +1,158 @@
+/**
+ * topology_txn.c
+ * Batched topology updates: staged link changes applied atomically with one route refresh
+ *
+ * A commit replays the staged changes on a copy of the adjacency matrix, so a
+ * rejected batch leaves the topology untouched, then swaps the copy in and
+ * hands the net weight change of every touched link to the route cache.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/topology_txn.h"
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void topology_txn_begin(topology_txn* txn, network_topology* network)
+{
+    txn->network = network;
+    txn->changes = NULL;
+    txn->count = 0;
+    txn->capacity = 0;
+}
+
+static void stage(topology_txn* txn, topology_op op, int from, int to, int weight)
+{
+    if (txn->count == txn->capacity) {
+        txn->capacity = txn->capacity ? txn->capacity * 2 : 16;
+        txn->changes = (topology_edit*)realloc(txn->changes, txn->capacity * sizeof(topology_edit));
+        if (txn->changes == NULL) {
+            fprintf(stderr, "Memory allocation failed for topology transaction\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    topology_edit* change = &txn->changes[txn->count++];
+    change->op = op;
+    change->from = from;
+    change->to = to;
+    change->weight = weight;
+}
+
+void topology_txn_add_link(topology_txn* txn, int from, int to, int weight)
+{
+    stage(txn, TOPOLOGY_ADD_LINK, from, to, weight);
+}
+
+void topology_txn_remove_link(topology_txn* txn, int from, int to)
+{
+    stage(txn, TOPOLOGY_REMOVE_LINK, from, to, 0);
+}
+
+void topology_txn_set_weight(topology_txn* txn, int from, int to, int weight)
+{
+    stage(txn, TOPOLOGY_SET_WEIGHT, from, to, weight);
+}
+
+// Apply one change to the staged matrix, returns why it is invalid or NULL
+static const char* apply_change(network_topology* staged, const topology_edit* change)
+{
+    if (!is_valid_node(staged, change->from) || !is_valid_node(staged, change->to)) {
+        return "invalid node";
+    }
+    if (change->from == change->to) {
+        return "link from a node to itself";
+    }
+
+    int* weight = &staged->graph[change->from][change->to];
+    switch (change->op) {
+        case TOPOLOGY_ADD_LINK:
+            if (change->weight <= 0) return "weight must be positive";
+            if (*weight > 0) return "link already exists";
+            *weight = change->weight;
+            return NULL;
+        case TOPOLOGY_REMOVE_LINK:
+            if (*weight == 0) return "no such link";
+            *weight = 0;
+            return NULL;
+        case TOPOLOGY_SET_WEIGHT:
+            if (change->weight <= 0) return "weight must be positive";
+            if (*weight == 0) return "no such link";
+            *weight = change->weight;
+            return NULL;
+    }
+    return "unknown operation";
+}
+
+int topology_txn_commit(topology_txn* txn, route_cache* routes, topology_txn_result* result)
+{
+    memset(result, 0, sizeof(*result));
+    result->failed_change = -1;
+    double start = now_seconds();
+
+    network_topology staged = *txn->network;
+    for (int i = 0; i < txn->count; i++) {
+        const char* error = apply_change(&staged, &txn->changes[i]);
+        if (error != NULL) {
+            result->failed_change = i;
+            result->error = error;
+            topology_txn_abort(txn);
+            result->apply_seconds = now_seconds() - start;
+            return -1;
+        }
+    }
+
+    // Net effect per link: a link touched several times is reported once, or not at all
+    route_link_change* links = (route_link_change*)malloc((txn->count > 0 ? txn->count : 1) * sizeof(route_link_change));
+    if (links == NULL) {
+        fprintf(stderr, "Memory allocation failed for topology transaction\n");
+        exit(EXIT_FAILURE);
+    }
+    bool seen[MAX_NODES][MAX_NODES] = { { false } };
+    for (int i = 0; i < txn->count; i++) {
+        int from = txn->changes[i].from;
+        int to = txn->changes[i].to;
+        if (seen[from][to]) continue;
+        seen[from][to] = true;
+        if (staged.graph[from][to] != txn->network->graph[from][to]) {
+            route_link_change* link = &links[result->links_changed++];
+            link->from = from;
+            link->to = to;
+            link->old_weight = txn->network->graph[from][to];
+            link->new_weight = staged.graph[from][to];
+        }
+    }
+
+    *txn->network = staged;
+    result->applied = txn->count;
+    result->apply_seconds = now_seconds() - start;
+
+    if (routes != NULL && result->links_changed > 0) {
+        start = now_seconds();
+        result->trees_recomputed = route_cache_update_links(routes, txn->network, links, result->links_changed);
+        result->recompute_seconds = now_seconds() - start;
+    }
+
+    free(links);
+    topology_txn_abort(txn);
+    return 0;
+}
+
+void topology_txn_abort(topology_txn* txn)
+{
+    txn->count = 0;
+}
+
+void topology_txn_free(topology_txn* txn)
+{
+    free(txn->changes);
+    txn->changes = NULL;
+    txn->count = 0;
+    txn->capacity = 0;
+}
@@ -0,0 +1,495 @@
+/**
+ * traffic.c
+ * Multi-threaded traffic generator pipeline
+ *
+ * Each stage runs on its own thread and hands batches of datagrams to the
+ * next one through a bounded SPSC ring. Batches are recycled from the sink
+ * back to the generator through a free ring, so the steady state does no
+ * batch allocation.
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/forwarding.h"
+#include "../include/ring.h"
+#include "../include/traffic.h"
+
+enum { STAGE_GENERATE, STAGE_FRAGMENT, STAGE_ROUTE, STAGE_SINK };
+
+typedef struct traffic_item {
+    ipv4_packet    packet;
+    ipv4_fragment* fragments;
+    int            fragment_count;
+    bool           routed;   // set by the route stage, the sink drops the others
+} traffic_item;
+
+typedef struct traffic_batch {
+    int          count;
+    bool         last;     // end-of-stream marker, forwarded by every stage
+    traffic_item items[TRAFFIC_MAX_BATCH];
+} traffic_batch;
+
+typedef struct flow {
+    int source;
+    int destination;
+} flow;
+
+typedef struct pipeline {
+    network_topology*     network;
+    forwarding_plane      plane;    // LPM forwarding state, read by the route stage
+    route_cache           routes;   // shared source trees, owned by the route stage
+    // One handle per (source, egress) of the flows, taken before the threads start and
+    // released after they end: the topology is fixed for the run and the cache is
+    // not thread-safe, so no stage takes or drops references
+    route_handle          flow_routes[MAX_NODES * MAX_NODES];
+    const traffic_config* config;
+
+    flow* flows;
+    int   flow_count;
+
+    traffic_batch* pool;
+    int            pool_size;
+
+    // queues[i] feeds stage i+1, free_queue returns batches to the generator
+    spsc_ring queues[TRAFFIC_STAGE_COUNT - 1];
+    spsc_ring free_queue;
+
+    stage_stats stats[TRAFFIC_STAGE_COUNT];
+    double      occupancy_sum[TRAFFIC_STAGE_COUNT];
+    long        unroutable;
+    long        wire_bytes;
+    wire_writer output;     // used by the sink only
+} pipeline;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint32_t next_random(uint32_t* state)
+{
+    // xorshift32, one state per thread
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static int next_payload_size(flow_mix mix, uint32_t* state)
+{
+    switch (mix) {
+    case FLOW_MIX_IMIX: {
+        int pick = next_random(state) % 12;
+        if (pick < 7) return 40 - IPV4_HEADER_SIZE;
+        if (pick < 11) return 576 - IPV4_HEADER_SIZE;
+        return 1500 - IPV4_HEADER_SIZE;
+    }
+    case FLOW_MIX_UNIFORM:
+        return 1 + (int)(next_random(state) % MAX_PAYLOAD_SIZE);
+    case FLOW_MIX_HEAVY_TAIL:
+    default: {
+        // Pareto with alpha 1.2 and a 64 byte minimum
+        double u = (next_random(state) + 1.0) / 4294967297.0;
+        double size = 64.0 / pow(u, 1.0 / 1.2);
+        return (size > MAX_PAYLOAD_SIZE) ? MAX_PAYLOAD_SIZE : (int)size;
+    }
+    }
+}
+
+// Block until the ring accepts the batch, accounting the time as waiting
+static void push_blocking(spsc_ring* ring, traffic_batch* batch, stage_stats* stats)
+{
+    if (spsc_ring_push(ring, batch)) {
+        return;
+    }
+
+    double start = now_seconds();
+    while (!spsc_ring_push(ring, batch)) {
+        sched_yield();
+    }
+    stats->wait_seconds += now_seconds() - start;
+}
+
+// Block until the ring yields a batch, sampling its occupancy first
+static traffic_batch* pop_blocking(spsc_ring* ring, stage_stats* stats, double* occupancy_sum)
+{
+    *occupancy_sum += spsc_ring_size(ring);
+
+    traffic_batch* batch = (traffic_batch*)spsc_ring_pop(ring);
+    if (batch != NULL) {
+        return batch;
+    }
+
+    double start = now_seconds();
+    while ((batch = (traffic_batch*)spsc_ring_pop(ring)) == NULL) {
+        sched_yield();
+    }
+    stats->wait_seconds += now_seconds() - start;
+    return batch;
+}
+
+static void* generate_stage(void* arg)
+{
+    pipeline* p = (pipeline*)arg;
+    stage_stats* stats = &p->stats[STAGE_GENERATE];
+    uint32_t state = p->config->seed ? p->config->seed : 0x9E3779B9u;
+    long remaining = p->config->datagram_count;
+
+    while (true) {
+        traffic_batch* batch = pop_blocking(&p->free_queue, stats, &p->occupancy_sum[STAGE_GENERATE]);
+
+        double start = now_seconds();
+        int count = (remaining < p->config->batch_size) ? (int)remaining : p->config->batch_size;
+        for (int i = 0; i < count; i++) {
+            flow* f = &p->flows[next_random(&state) % p->flow_count];
+            int payload_size = next_payload_size(p->config->mix, &state);
+
+            if (p->config->virtual_payload) {
+                create_ipv4_packet_virtual(&batch->items[i].packet, node_address(f->source),
+                                           node_address(f->destination), payload_size,
+                                           PAYLOAD_PATTERN_RANDOM, next_random(&state));
+            } else {
+                create_ipv4_packet(&batch->items[i].packet, node_address(f->source),
+                                   node_address(f->destination), payload_size);
+            }
+            batch->items[i].fragments = NULL;
+            batch->items[i].fragment_count = 0;
+            batch->items[i].routed = false;
+        }
+        remaining -= count;
+        batch->count = count;
+        batch->last = (remaining == 0);
+
+        stats->datagrams += count;
+        stats->batches++;
+        stats->busy_seconds += now_seconds() - start;
+
+        push_blocking(&p->queues[STAGE_GENERATE], batch, stats);
+        if (batch->last) break;
+    }
+    return NULL;
+}
+
+static void* fragment_stage(void* arg)
+{
+    pipeline* p = (pipeline*)arg;
+    stage_stats* stats = &p->stats[STAGE_FRAGMENT];
+
+    while (true) {
+        traffic_batch* batch = pop_blocking(&p->queues[STAGE_GENERATE], stats, &p->occupancy_sum[STAGE_FRAGMENT]);
+
+        double start = now_seconds();
+        for (int i = 0; i < batch->count; i++) {
+            traffic_item* item = &batch->items[i];
+            item->fragment_count = fragment_ipv4_packet(&item->packet, p->config->mtu, &item->fragments);
+            stats->fragments += item->fragment_count;
+        }
+        stats->datagrams += batch->count;
+        stats->batches++;
+        stats->busy_seconds += now_seconds() - start;
+
+        bool last = batch->last;
+        push_blocking(&p->queues[STAGE_FRAGMENT], batch, stats);
+        if (last) break;
+    }
+    return NULL;
+}
+
+static void* route_stage(void* arg)
+{
+    pipeline* p = (pipeline*)arg;
+    stage_stats* stats = &p->stats[STAGE_ROUTE];
+
+    while (true) {
+        traffic_batch* batch = pop_blocking(&p->queues[STAGE_FRAGMENT], stats, &p->occupancy_sum[STAGE_ROUTE]);
+
+        double start = now_seconds();
+        for (int i = 0; i < batch->count; i++) {
+            traffic_item* item = &batch->items[i];
+            // The prefix tables pick the router that delivers the datagram, the
+            // source's shared tree gives the path to it
+            int source = address_to_node(p->network, item->packet.header.source_ip);
+            int egress = forwarding_egress(&p->plane, source, item->packet.header.dest_ip);
+            route_handle route = (source < 0 || egress < 0) ? ROUTE_HANDLE_NONE
+                                                           : p->flow_routes[source * MAX_NODES + egress];
+            if (route.tree == ROUTE_NO_TREE) {
+                p->unroutable++;
+                continue;
+            }
+
+            // Every fragment of the datagram follows the same route
+            for (int j = 0; j < item->fragment_count; j++) {
+                item->fragments[j].route = route;
+            }
+            item->routed = true;
+            stats->fragments += item->fragment_count;
+        }
+        stats->datagrams += batch->count;
+        stats->batches++;
+        stats->busy_seconds += now_seconds() - start;
+
+        bool last = batch->last;
+        push_blocking(&p->queues[STAGE_ROUTE], batch, stats);
+        if (last) break;
+    }
+    return NULL;
+}
+
+static void* sink_stage(void* arg)
+{
+    pipeline* p = (pipeline*)arg;
+    stage_stats* stats = &p->stats[STAGE_SINK];
+
+    while (true) {
+        traffic_batch* batch = pop_blocking(&p->queues[STAGE_ROUTE], stats, &p->occupancy_sum[STAGE_SINK]);
+
+        double start = now_seconds();
+        if (p->config->output_fd >= 0) {
+            // Queued fragments point into the payloads, so flush before they are freed
+            for (int i = 0; i < batch->count; i++) {
+                if (!batch->items[i].routed) continue;
+                wire_emit(&p->output, &batch->items[i].packet, batch->items[i].fragments,
+                          batch->items[i].fragment_count);
+            }
+            wire_flush(&p->output);
+        }
+        for (int i = 0; i < batch->count; i++) {
+            traffic_item* item = &batch->items[i];
+            // Unroutable datagrams are dropped: released, but neither sent nor counted
+            for (int j = 0; j < item->fragment_count; j++) {
+                if (item->routed) p->wire_bytes += item->fragments[j].header.total_len;
+                free(item->fragments[j].data);
+            }
+            if (item->routed) {
+                stats->fragments += item->fragment_count;
+                stats->datagrams++;
+            }
+            free(item->fragments);
+            free(item->packet.payload);
+        }
+        stats->batches++;
+        stats->busy_seconds += now_seconds() - start;
+
+        bool last = batch->last;
+        batch->count = 0;
+        // The free ring holds the whole pool, so this never blocks
+        spsc_ring_push(&p->free_queue, batch);
+        if (last) break;
+    }
+    return NULL;
+}
+
+// Pick random reachable source/destination pairs and pin the route of each
+static int setup_flows(pipeline* p, uint32_t* state)
+{
+    int n = p->network->node_count;
+    bool reachable[MAX_NODES][MAX_NODES] = {{false}};
+    int pairs = 0;
+
+    // Reachability by depth-first search from every node
+    for (int s = 0; s < n; s++) {
+        int stack[MAX_NODES];
+        int top = 0;
+        reachable[s][s] = true;
+        stack[top++] = s;
+        while (top > 0) {
+            int u = stack[--top];
+            for (int v = 0; v < n; v++) {
+                if (p->network->graph[u][v] > 0 && !reachable[s][v]) {
+                    reachable[s][v] = true;
+                    stack[top++] = v;
+                }
+            }
+        }
+        for (int d = 0; d < n; d++) {
+            if (d != s && reachable[s][d]) pairs++;
+        }
+    }
+
+    if (pairs == 0) {
+        return -1;
+    }
+
+    p->flows = (flow*)malloc(p->flow_count * sizeof(flow));
+    if (p->flows == NULL) {
+        return -1;
+    }
+
+    for (int i = 0; i < p->flow_count; i++) {
+        int pick = next_random(state) % pairs;
+        for (int s = 0; s < n; s++) {
+            for (int d = 0; d < n; d++) {
+                if (d != s && reachable[s][d] && pick-- == 0) {
+                    p->flows[i].source = s;
+                    p->flows[i].destination = d;
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < MAX_NODES * MAX_NODES; i++) {
+        p->flow_routes[i] = ROUTE_HANDLE_NONE;
+    }
+    for (int i = 0; i < p->flow_count; i++) {
+        int s = p->flows[i].source;
+        int egress = forwarding_egress(&p->plane, s, node_address(p->flows[i].destination));
+        if (egress >= 0 && p->flow_routes[s * MAX_NODES + egress].tree == ROUTE_NO_TREE) {
+            p->flow_routes[s * MAX_NODES + egress] = route_cache_lookup(&p->routes, s, egress);
+        }
+    }
+    return 0;
+}
+
+void init_traffic_config(traffic_config* config)
+{
+    config->mix = FLOW_MIX_IMIX;
+    config->datagram_count = 1000000;
+    config->mtu = 1500;
+    config->flow_count = 64;
+    config->batch_size = 64;
+    config->queue_capacity = 64;
+    config->virtual_payload = false;
+    config->output_fd = -1;
+    config->seed = 1;
+}
+
+bool parse_flow_mix(const char* name, flow_mix* mix)
+{
+    if (strcmp(name, "imix") == 0) {
+        *mix = FLOW_MIX_IMIX;
+    } else if (strcmp(name, "uniform") == 0) {
+        *mix = FLOW_MIX_UNIFORM;
+    } else if (strcmp(name, "heavy") == 0) {
+        *mix = FLOW_MIX_HEAVY_TAIL;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* flow_mix_name(flow_mix mix)
+{
+    switch (mix) {
+    case FLOW_MIX_IMIX: return "imix";
+    case FLOW_MIX_UNIFORM: return "uniform";
+    case FLOW_MIX_HEAVY_TAIL: return "heavy";
+    }
+    return "unknown";
+}
+
+int run_traffic_pipeline(network_topology* network, const traffic_config* config, traffic_report* report)
+{
+    static const char* stage_names[TRAFFIC_STAGE_COUNT] = { "generate", "fragment", "route", "sink" };
+    static void* (*stage_funcs[TRAFFIC_STAGE_COUNT])(void*) = {
+        generate_stage, fragment_stage, route_stage, sink_stage
+    };
+
+    if (config->batch_size < 1 || config->batch_size > TRAFFIC_MAX_BATCH ||
+        config->queue_capacity < 1 || config->flow_count < 1 ||
+        config->datagram_count < 1 || config->mtu < IPV4_HEADER_SIZE + 8) {
+        printf("Error: Invalid traffic configuration.\n");
+        return -1;
+    }
+
+    pipeline* p = (pipeline*)aligned_alloc(RING_CACHE_LINE,
+        (sizeof(pipeline) + RING_CACHE_LINE - 1) / RING_CACHE_LINE * RING_CACHE_LINE);
+    if (p == NULL) {
+        fprintf(stderr, "Memory allocation failed for traffic pipeline\n");
+        return -1;
+    }
+    memset(p, 0, sizeof(pipeline));
+    p->network = network;
+    p->config = config;
+    p->flow_count = config->flow_count;
+
+    forwarding_build(&p->plane, network);
+    route_cache_init(&p->routes, network);
+    uint32_t state = config->seed ? config->seed : 0x9E3779B9u;
+    if (setup_flows(p, &state) != 0) {
+        printf("Error: No reachable source/destination pairs in the network.\n");
+        route_cache_free(&p->routes);
+        forwarding_free(&p->plane);
+        free(p);
+        return -1;
+    }
+    if (config->output_fd >= 0) {
+        wire_writer_init(&p->output, config->output_fd, WIRE_MAX_IOV / 2);
+    }
+
+    // Enough batches to fill the three inter-stage rings with one to spare; only the
+    // free ring is sized for the whole pool, which is what keeps the sink from blocking
+    p->pool_size = 3 * config->queue_capacity + 1;
+    p->pool = (traffic_batch*)malloc(p->pool_size * sizeof(traffic_batch));
+    bool rings_ok = (p->pool != NULL) && spsc_ring_init(&p->free_queue, p->pool_size);
+    for (int i = 0; i < TRAFFIC_STAGE_COUNT - 1; i++) {
+        rings_ok = rings_ok && spsc_ring_init(&p->queues[i], config->queue_capacity);
+    }
+    if (!rings_ok) {
+        fprintf(stderr, "Memory allocation failed for traffic pipeline\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < p->pool_size; i++) {
+        spsc_ring_push(&p->free_queue, &p->pool[i]);
+    }
+
+    for (int i = 0; i < TRAFFIC_STAGE_COUNT; i++) {
+        p->stats[i].name = stage_names[i];
+        p->stats[i].queue_capacity = (i == STAGE_GENERATE)
+            ? (int)spsc_ring_capacity(&p->free_queue)
+            : (int)spsc_ring_capacity(&p->queues[i - 1]);
+    }
+
+    double start = now_seconds();
+    pthread_t threads[TRAFFIC_STAGE_COUNT];
+    for (int i = 0; i < TRAFFIC_STAGE_COUNT; i++) {
+        if (pthread_create(&threads[i], NULL, stage_funcs[i], p) != 0) {
+            fprintf(stderr, "Failed to start %s stage thread\n", stage_names[i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < TRAFFIC_STAGE_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = now_seconds() - start;
+
+    memset(report, 0, sizeof(traffic_report));
+    for (int i = 0; i < TRAFFIC_STAGE_COUNT; i++) {
+        report->stages[i] = p->stats[i];
+        // The generator's input is the free ring, where occupancy means idle batches
+        report->stages[i].avg_occupancy = (p->stats[i].batches > 0)
+            ? p->occupancy_sum[i] / p->stats[i].batches : 0.0;
+    }
+    report->elapsed_seconds = elapsed;
+    report->datagrams = p->stats[STAGE_SINK].datagrams;
+    report->fragments = p->stats[STAGE_SINK].fragments;
+    report->wire_bytes = p->wire_bytes;
+    report->unroutable = p->unroutable;
+    if (config->output_fd >= 0) {
+        wire_writer_free(&p->output);
+        report->output = p->output.stats;
+        report->output_error = p->output.error;
+    }
+
+    for (int i = 0; i < TRAFFIC_STAGE_COUNT - 1; i++) {
+        spsc_ring_destroy(&p->queues[i]);
+    }
+    spsc_ring_destroy(&p->free_queue);
+    free(p->pool);
+    free(p->flows);
+    for (int i = 0; i < MAX_NODES * MAX_NODES; i++) {
+        route_cache_release(&p->routes, p->flow_routes[i]);
+    }
+    route_cache_free(&p->routes);
+    forwarding_free(&p->plane);
+    free(p);
+    return 0;
+}
@@ -2,6 +2,9 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "include/forwarding.h"
 
 void display_welcome_banner() {
   printf("\n");
@@ -21,7 +24,7 @@ void get_network_topology(network_topology* network) {
   printf("1. Use predefined test topology\n");
   printf("2. Create custom topology\n");
   printf("Enter choice (1-2): ");
-  scanf("%d", &ch);
+  session_read_int(&ch);
 
   switch (ch) {
     case 1:
@@ -90,25 +93,25 @@ void get_user_inputs(network_topology* network, int* source, int* destination, i
     // Get source node
     do {
         printf("Enter source node (0-%d): ", network->node_count - 1);
-        scanf("%d", source);
+        session_read_int(source);
     } while (!is_valid_node(network, *source));
     
     // Get destination node
     do {
         printf("Enter destination node (0-%d): ", network->node_count - 1);
-        scanf("%d", destination);
+        session_read_int(destination);
     } while (!is_valid_node(network, *destination) || *source == *destination);
     
     // Get MTU
     do {
         printf("Enter MTU (must be at least %d): ", IPV4_HEADER_SIZE + 8);
-        scanf("%d", mtu);
+        session_read_int(mtu);
     } while (*mtu < IPV4_HEADER_SIZE + 8);
     
     // Get payload size
     do {
         printf("Enter payload size (1-%d): ", MAX_PAYLOAD_SIZE);
-        scanf("%d", payload_size);
+        session_read_int(payload_size);
     } while (*payload_size < 1 || *payload_size > MAX_PAYLOAD_SIZE);
 }
 
@@ -122,8 +125,11 @@ void display_packet_info(ipv4_packet* packet)
     printf("  TTL: %d\n", packet->header.ttl);
     printf("  Protocol: %d\n", packet->header.protocol);
     printf("  Checksum: 0x%04X\n", packet->header.checksum);
-    printf("  Source Address: %d\n", packet->header.source_ip);
-    printf("  Destination Address: %d\n", packet->header.dest_ip);
+    char address[16];
+    format_ipv4_address(packet->header.source_ip, address);
+    printf("  Source Address: %s\n", address);
+    format_ipv4_address(packet->header.dest_ip, address);
+    printf("  Destination Address: %s\n", address);
     printf("Payload Size: %d bytes\n", packet->payload_size);
 }
 
@@ -151,19 +157,231 @@ void display_fragment_info(ipv4_fragment* fragment, int fragment_num)
 
 
 
-void display_route_path(ipv4_fragment* fragment)
+void display_route_path(const route_cache* routes, ipv4_fragment* fragment)
 {
-    if (fragment->path_length <= 0 || fragment->path == NULL) {
+    int* path = NULL;
+    int path_length = route_expand_path(routes, fragment->route, &path);
+
+    if (path_length <= 0) {
         printf("  No route available for this fragment.\n");
         return;
     }
     
-    printf("  Routing Path (%d hops): ", fragment->path_length - 1);
-    for (int i = 0; i < fragment->path_length; i++) {
-        printf("%d", fragment->path[i]);
-        if (i < fragment->path_length - 1) {
+    printf("  Routing Path (%d hops): ", path_length - 1);
+    for (int i = 0; i < path_length; i++) {
+        printf("%d", path[i]);
+        if (i < path_length - 1) {
             printf(" -> ");
         }
     }
     printf("\n");
+    free(path);
+}
+
+void display_traffic_report(const traffic_config* config, const traffic_report* report)
+{
+    printf("\n=== Traffic Pipeline Results ===\n");
+    printf("Flow mix: %s, MTU: %d, flows: %d, batch size: %d, payloads: %s\n",
+           flow_mix_name(config->mix), config->mtu, config->flow_count, config->batch_size,
+           config->virtual_payload ? "virtual" : "real");
+    printf("Datagrams: %ld, fragments: %ld, wire bytes: %ld, unroutable: %ld\n",
+           report->datagrams, report->fragments, report->wire_bytes, report->unroutable);
+    printf("Elapsed: %.3f s (%.0f datagrams/s, %.0f fragments/s)\n\n",
+           report->elapsed_seconds,
+           report->datagrams / report->elapsed_seconds,
+           report->fragments / report->elapsed_seconds);
+    if (config->output_fd >= 0) {
+        printf("Wire output: %lld bytes in %ld writev calls (%.3f per datagram, %.1f MB/s)%s%s\n\n",
+               report->output.bytes, report->output.syscalls,
+               report->output.datagrams ? (double)report->output.syscalls / report->output.datagrams : 0.0,
+               report->output.bytes / report->elapsed_seconds / 1e6,
+               report->output_error ? ", write failed: " : "",
+               report->output_error ? strerror(report->output_error) : "");
+    }
+
+    printf("  %-9s %12s %12s %9s %9s %6s %14s\n",
+           "Stage", "Datagrams/s", "Fragments/s", "Busy(s)", "Wait(s)", "Busy%", "Queue occupancy");
+
+    int bottleneck = 0;
+    for (int i = 0; i < TRAFFIC_STAGE_COUNT; i++) {
+        const stage_stats* stage = &report->stages[i];
+        double busy = stage->busy_seconds > 0 ? stage->busy_seconds : 1e-9;
+
+        printf("  %-9s %12.0f %12.0f %9.3f %9.3f %5.1f%% %8.1f / %-4d\n",
+               stage->name,
+               stage->datagrams / busy,
+               stage->fragments / busy,
+               stage->busy_seconds,
+               stage->wait_seconds,
+               100.0 * stage->busy_seconds / report->elapsed_seconds,
+               stage->avg_occupancy,
+               stage->queue_capacity);
+
+        if (stage->busy_seconds > report->stages[bottleneck].busy_seconds) {
+            bottleneck = i;
+        }
+    }
+
+    printf("\nBottleneck stage: %s\n", report->stages[bottleneck].name);
+    printf("(Generator occupancy counts idle batches in the free pool; "
+           "a full input queue marks the stage that cannot keep up.)\n");
+}
+
+// Share of the frame capacity not carrying payload: headers plus unused MTU room
+static double frame_overhead(const mtu_sweep_cell* cell)
+{
+    long long frame_bytes = cell->payload_bytes + cell->header_bytes + cell->wasted_bytes;
+    return frame_bytes > 0 ? (double)(cell->header_bytes + cell->wasted_bytes) / frame_bytes : 0.0;
+}
+
+void display_mtu_sweep(const mtu_sweep_result* result)
+{
+    int mtu_max = result->mtu_min + result->mtu_count - 1;
+    double points = (double)result->mtu_count * (result->payload_max - result->payload_min + 1);
+
+    printf("\n=== MTU Sweep Results ===\n");
+    printf("MTU %d..%d, payload %d..%d bytes: %.0f datagram layouts in %.3f s (%.1f M/s)\n\n",
+           result->mtu_min, mtu_max, result->payload_min, result->payload_max,
+           points, result->elapsed_seconds, points / result->elapsed_seconds / 1e6);
+
+    const int common[] = { 68, 576, 1280, 1492, 1500, 4352, 9000 };
+    printf("  %6s %14s %14s %12s %10s\n", "MTU", "Avg fragments", "Max fragments", "Header %", "Wasted %");
+    for (size_t i = 0; i < sizeof(common) / sizeof(common[0]); i++) {
+        if (common[i] < result->mtu_min || common[i] > mtu_max) continue;
+
+        int index = common[i] - result->mtu_min;
+        const mtu_sweep_cell* total = &result->totals[index];
+        long long frame_bytes = total->payload_bytes + total->header_bytes + total->wasted_bytes;
+        printf("  %6d %14.2f %14d %11.2f%% %9.2f%%\n", common[i],
+               (double)total->fragments / (result->payload_max - result->payload_min + 1),
+               result->max_fragments[index],
+               100.0 * total->header_bytes / total->payload_bytes,
+               100.0 * total->wasted_bytes / frame_bytes);
+    }
+
+    // Rows are evenly spaced MTUs, columns payload bins; darker means more overhead
+    const char* shades = " .:-=+*#%@";
+    const int rows = 20;
+    int columns = result->payload_bins < 64 ? result->payload_bins : 64;
+
+    printf("\nFrame overhead (headers + unused MTU room), payload grows to the right:\n");
+    for (int r = 0; r < rows && r < result->mtu_count; r++) {
+        int index = (int)((long long)(result->mtu_count - 1) * r / (rows - 1 > 0 ? rows - 1 : 1));
+        if (result->mtu_count < rows) index = r;
+
+        printf("  %5d |", result->mtu_min + index);
+        for (int c = 0; c < columns; c++) {
+            int bin = c * result->payload_bins / columns;
+            double overhead = frame_overhead(&result->cells[(size_t)index * result->payload_bins + bin]);
+            int level = (int)(overhead * 10);
+            putchar(shades[level > 9 ? 9 : level]);
+        }
+        printf("|\n");
+    }
+    printf("  %5s  %-*d%*d\n", "", columns / 2, result->payload_min, columns - columns / 2, result->payload_max);
+    printf("  Scale: ' ' < 10%% ... '@' >= 90%%\n");
+}
+
+void display_link_state_report(const link_state_sim* sim, const ls_report* report, int max_routers)
+{
+    printf("\n=== Link-State Convergence ===\n");
+    printf("Flooding: %.3f ms, convergence: %.3f ms, LSA messages: %ld\n",
+           report->flooding_us / 1000.0, report->convergence_us / 1000.0, report->lsa_messages);
+    printf("SPF runs: %d full, %d incremental, %ld work units (busiest router %d: %ld)\n",
+           report->spf_full, report->spf_incremental, report->total_work,
+           report->busiest_router, report->max_router_work);
+    printf("Router CPU: %.1f us mean, %.1f us max\n\n", report->mean_router_cpu_us, report->max_router_cpu_us);
+
+    // Pick the routers to list: all of them, or the busiest by CPU time
+    int count = sim->node_count;
+    if (max_routers > 0 && max_routers < count) count = max_routers;
+    int* order = (int*)malloc(sim->node_count * sizeof(int));
+    if (order == NULL) {
+        fprintf(stderr, "Memory allocation failed for report\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < sim->node_count; i++) {
+        order[i] = i;
+    }
+    if (count < sim->node_count) {
+        for (int i = 0; i < count; i++) {
+            int best = i;
+            for (int j = i + 1; j < sim->node_count; j++) {
+                if (sim->routers[order[j]].stats.cpu_us > sim->routers[order[best]].stats.cpu_us) best = j;
+            }
+            int swap = order[i];
+            order[i] = order[best];
+            order[best] = swap;
+        }
+    }
+
+    printf("  %6s %8s %8s %6s %5s %5s %10s %10s %12s\n",
+           "Router", "LSAs rx", "LSAs tx", "Dup", "Full", "Incr", "SPF work", "CPU (us)", "Routes at");
+    for (int i = 0; i < count; i++) {
+        const ls_router_stats* stats = &sim->routers[order[i]].stats;
+        printf("  %6d %8ld %8ld %6ld %5d %5d %10ld %10.1f ", order[i], stats->lsas_received,
+               stats->lsas_sent, stats->duplicates, stats->spf_full, stats->spf_incremental,
+               stats->spf_work, stats->cpu_us);
+        if (stats->converged_at >= 0) {
+            printf("%9.3f ms\n", (stats->converged_at - report->start_us) / 1000.0);
+        } else {
+            printf("%12s\n", "-");
+        }
+    }
+    free(order);
+}
+
+void display_queue_sim_report(const queue_sim_config* config, const queue_sim_report* report, bool header)
+{
+    if (header) {
+        printf("  %-9s %6s %6s %10s %10s %7s %10s %8s %8s %9s\n", "Policy", "MTU", "Frags",
+               "Frag loss", "Dgram loss", "Ampl.", "Goodput", "Light", "Heavy", "Delay");
+        printf("  %-9s %6s %6s %10s %10s %7s %10s %8s %8s %9s\n", "", "", "/dgram",
+               "", "", "", "Mb/s", "loss", "loss", "ms");
+    }
+
+    printf("  %-9s %6d %6.1f %9.2f%% %9.2f%% %6.2fx %10.2f %7.1f%% %7.1f%% %9.3f\n",
+           queue_policy_name(config->policy), config->mtu,
+           report->datagrams_sent ? (double)report->fragments_sent / report->datagrams_sent : 0.0,
+           100.0 * report->fragment_loss, 100.0 * report->datagram_loss, report->amplification,
+           report->goodput_bps / 1e6, 100.0 * report->light_flow_loss, 100.0 * report->heavy_flow_loss,
+           report->mean_delay_ms);
+}
+
+static void display_frr_outcome(const char* name, const frr_outcome* outcome)
+{
+    long lost = outcome->dropped + outcome->looped;
+    printf("  %-14s %6ld %10ld %8ld %7ld %9ld %7.1f%%\n", name, outcome->sent, outcome->delivered,
+           outcome->dropped, outcome->looped, outcome->repaired,
+           outcome->sent > 0 ? 100.0 * lost / outcome->sent : 0.0);
+}
+
+void display_frr_report(const frr_sim_report* report)
+{
+    printf("\n=== Fast Reroute ===\n");
+    printf("%d flows used the removed links, %ld of them with a backup at the failed link\n",
+           report->affected_pairs, report->protected_routes);
+    printf("Fragments sent during the %.3f ms of reconvergence:\n\n", report->convergence_us / 1000.0);
+    printf("  %-14s %6s %10s %8s %7s %9s %8s\n", "", "Sent", "Delivered", "Dropped", "Looped", "Repaired", "Lost");
+    display_frr_outcome("Unprotected", &report->unprotected);
+    display_frr_outcome("Fast reroute", &report->fast_reroute);
+}
+
+void display_session_report(const session_report* report)
+{
+    static const char* phases[SESSION_PHASE_COUNT] = { "Setup", "Routing", "Topology", "Congestion" };
+
+    printf("\n=== Session %s ===\n", report->mode == SESSION_REPLAY ? "Replay" : "Recording");
+    printf("%ld inputs, %ld topology events, %ld byte log\n",
+           report->inputs, report->topology_events, report->log_bytes);
+    printf("Digest: %016llx", (unsigned long long)report->digest);
+    if (report->mode == SESSION_REPLAY) {
+        printf(" (recorded %016llx) %s", (unsigned long long)report->recorded_digest,
+               report->diverged ? "DIVERGED" : "matches");
+    }
+    printf("\n\n");
+    for (int p = 0; p < SESSION_PHASE_COUNT; p++) {
+        printf("  %-12s %10.3f ms\n", phases[p], report->phase_seconds[p] * 1000.0);
+    }
+    printf("  %-12s %10.3f ms\n", "Total", report->total_seconds * 1000.0);
 }
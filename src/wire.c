@@ -0,0 +1,112 @@
+/**
+ * wire.c
+ * Scatter-gather emission of fragments to a file descriptor with writev
+ *
+ * Wire fragments are never assembled in a buffer of their own: a queued
+ * fragment is its 20 serialized header bytes plus a pointer to the payload
+ * it was cut from, and one writev hands hundreds of them to the kernel.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../include/wire.h"
+
+void wire_writer_init(wire_writer* writer, int fd, int max_fragments)
+{
+    if (max_fragments < 1) max_fragments = 1;
+    if (max_fragments > WIRE_MAX_IOV / 2) max_fragments = WIRE_MAX_IOV / 2;
+
+    memset(writer, 0, sizeof(*writer));
+    writer->fd = fd;
+    writer->iov_capacity = 2 * max_fragments;
+    writer->iov = (struct iovec*)malloc(writer->iov_capacity * sizeof(struct iovec));
+    writer->headers = (uint8_t*)malloc((size_t)max_fragments * IPV4_HEADER_SIZE);
+    writer->arena = (uint8_t*)malloc(WIRE_ARENA_SIZE);
+    if (writer->iov == NULL || writer->headers == NULL || writer->arena == NULL) {
+        fprintf(stderr, "Memory allocation failed for wire writer\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+int wire_writer_free(wire_writer* writer)
+{
+    int status = wire_flush(writer);
+    free(writer->iov);
+    free(writer->headers);
+    free(writer->arena);
+    writer->iov = NULL;
+    writer->headers = NULL;
+    writer->arena = NULL;
+    return status;
+}
+
+int wire_flush(wire_writer* writer)
+{
+    struct iovec* iov = writer->iov;
+    int remaining = writer->iov_count;
+
+    while (remaining > 0 && writer->error == 0) {
+        ssize_t written = writev(writer->fd, iov, remaining);
+        writer->stats.syscalls++;
+        if (written < 0) {
+            if (errno != EINTR) writer->error = errno;
+            continue;
+        }
+        writer->stats.bytes += written;
+
+        // Skip what was written completely and resume inside a partial entry
+        while (remaining > 0 && (size_t)written >= iov->iov_len) {
+            written -= (ssize_t)iov->iov_len;
+            iov++;
+            remaining--;
+        }
+        if (remaining > 0) {
+            iov->iov_base = (uint8_t*)iov->iov_base + written;
+            iov->iov_len -= (size_t)written;
+        }
+    }
+
+    writer->iov_count = 0;
+    writer->arena_used = 0;
+    return writer->error ? -1 : 0;
+}
+
+int wire_emit(wire_writer* writer, const ipv4_packet* packet, const ipv4_fragment* fragments, int count)
+{
+    for (int i = 0; i < count && writer->error == 0; i++) {
+        const ipv4_fragment* fragment = &fragments[i];
+        if (writer->iov_count + 2 > writer->iov_capacity) {
+            wire_flush(writer);
+        }
+
+        const uint8_t* data;
+        if (packet->payload != NULL) {
+            data = packet->payload + fragment->content.offset;   // no copy at all
+        } else if (fragment->data != NULL) {
+            data = fragment->data;
+        } else {
+            // Virtual fragments have no bytes yet; generate them into the arena
+            if (writer->arena_used + fragment->data_size > WIRE_ARENA_SIZE) {
+                wire_flush(writer);
+            }
+            materialize_payload(&fragment->content, writer->arena + writer->arena_used, fragment->data_size);
+            data = writer->arena + writer->arena_used;
+            writer->arena_used += fragment->data_size;
+        }
+
+        uint8_t* header = writer->headers + (writer->iov_count / 2) * IPV4_HEADER_SIZE;
+        ipv4_serialize_header(&fragment->header, header);
+        writer->iov[writer->iov_count].iov_base = header;
+        writer->iov[writer->iov_count].iov_len = IPV4_HEADER_SIZE;
+        writer->iov[writer->iov_count + 1].iov_base = (void*)data;
+        writer->iov[writer->iov_count + 1].iov_len = fragment->data_size;
+        writer->iov_count += 2;
+        writer->stats.fragments++;
+    }
+
+    writer->stats.datagrams++;
+    return writer->error ? -1 : 0;
+}
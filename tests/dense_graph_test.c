@@ -0,0 +1,231 @@
+/**
+ * dense_graph_test.c
+ * Test program for the vectorized adjacency-matrix Dijkstra
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/dense_graph.h"
+#include "../include/dijkstra.h"
+
+static const dense_kernel kernels[] = { DENSE_KERNEL_SCALAR, DENSE_KERNEL_SSE41, DENSE_KERNEL_AVX2 };
+#define KERNEL_COUNT 3
+
+// Textbook matrix Dijkstra: settle the first closest unvisited node, relax on strictly shorter paths
+static void reference_dijkstra(const dense_graph* graph, int source, int* dist, int* prev) {
+    int n = graph->node_count;
+    bool* visited = (bool*)calloc(n, sizeof(bool));
+    for (int v = 0; v < n; v++) {
+        dist[v] = INT_MAX;
+        prev[v] = -1;
+    }
+    dist[source] = 0;
+
+    for (;;) {
+        int u = -1;
+        for (int v = 0; v < n; v++) {
+            if (!visited[v] && dist[v] != INT_MAX && (u < 0 || dist[v] < dist[u])) u = v;
+        }
+        if (u < 0) break;
+        visited[u] = true;
+        const int* row = graph->weights + (size_t)u * graph->stride;
+        for (int v = 0; v < n; v++) {
+            if (!visited[v] && row[v] > 0 && dist[u] + row[v] < dist[v]) {
+                dist[v] = dist[u] + row[v];
+                prev[v] = u;
+            }
+        }
+    }
+    free(visited);
+}
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+
+    printf("=== Dense Graph Functionality Test ===\n\n");
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        printf("  %s kernel: %s\n", dense_kernel_name(kernels[k]),
+               dense_kernel_supported(kernels[k]) ? "supported" : "not supported, falls back to scalar");
+    }
+
+    // Sizes that leave scalar tails after the 4- and 8-wide loops
+    const int sizes[] = { 1, 7, 13, 37, 64, 100 };
+    const int size_count = (int)(sizeof(sizes) / sizeof(sizes[0]));
+
+    // Test 1: with canonical predecessors every kernel reproduces dijkstra_csr()
+    printf("\n=== Test Case 1: Canonical Trees Match dijkstra_csr() ===\n");
+    bool canonical_correct = true;
+    for (int i = 0; i < size_count; i++) {
+        for (int degree = 1; degree <= 16; degree *= 4) {
+            int n = sizes[i];
+            csr_graph graph;
+            csr_generate_random(&graph, n, degree, 10, 100 + n + degree);
+            dense_graph dense;
+            dense_from_csr(&dense, &graph);
+
+            int* ref_dist = (int*)malloc(n * sizeof(int));
+            int* ref_prev = (int*)malloc(n * sizeof(int));
+            int* dist = (int*)malloc(n * sizeof(int));
+            int* prev = (int*)malloc(n * sizeof(int));
+            for (int source = 0; source < n; source++) {
+                dijkstra_csr(&graph, source, ref_dist, ref_prev);
+                for (int k = 0; k < KERNEL_COUNT; k++) {
+                    dijkstra_dense(&dense, source, -1, dist, prev, kernels[k], true);
+                    if (memcmp(dist, ref_dist, n * sizeof(int)) != 0 ||
+                        memcmp(prev, ref_prev, n * sizeof(int)) != 0) {
+                        printf("  ✗ %s tree of %d differs (n=%d, degree=%d)\n",
+                               dense_kernel_name(kernels[k]), source, n, degree);
+                        canonical_correct = false;
+                    }
+                }
+            }
+            free(ref_dist);
+            free(ref_prev);
+            free(dist);
+            free(prev);
+            dense_free(&dense);
+            csr_free(&graph);
+        }
+    }
+    if (canonical_correct) {
+        printf("  ✓ Every kernel matches dijkstra_csr() on random graphs of 1-100 nodes\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Canonical trees differ from dijkstra_csr()\n");
+    }
+    total_tests++;
+
+    // Test 2: without it every kernel keeps the first predecessor, like a textbook matrix Dijkstra
+    printf("\n=== Test Case 2: First-Predecessor Trees Match Reference ===\n");
+    bool first_correct = true;
+    for (int i = 0; i < size_count; i++) {
+        int n = sizes[i];
+        csr_graph graph;
+        csr_generate_random(&graph, n, 8, 4, 200 + n);   // small weights, many ties
+        dense_graph dense;
+        dense_from_csr(&dense, &graph);
+
+        int* ref_dist = (int*)malloc(n * sizeof(int));
+        int* ref_prev = (int*)malloc(n * sizeof(int));
+        int* dist = (int*)malloc(n * sizeof(int));
+        int* prev = (int*)malloc(n * sizeof(int));
+        for (int source = 0; source < n; source++) {
+            reference_dijkstra(&dense, source, ref_dist, ref_prev);
+            for (int k = 0; k < KERNEL_COUNT; k++) {
+                dijkstra_dense(&dense, source, -1, dist, prev, kernels[k], false);
+                if (memcmp(dist, ref_dist, n * sizeof(int)) != 0 ||
+                    memcmp(prev, ref_prev, n * sizeof(int)) != 0) {
+                    printf("  ✗ %s tree of %d differs (n=%d)\n", dense_kernel_name(kernels[k]), source, n);
+                    first_correct = false;
+                }
+            }
+        }
+        free(ref_dist);
+        free(ref_prev);
+        free(dist);
+        free(prev);
+        dense_free(&dense);
+        csr_free(&graph);
+    }
+    if (first_correct) {
+        printf("  ✓ Every kernel matches the reference, ties included\n");
+        test_passed++;
+    } else {
+        printf("  ✗ First-predecessor trees differ from the reference\n");
+    }
+    total_tests++;
+
+    // Test 3: dijkstra() on the topology matrix returns the reference paths
+    printf("\n=== Test Case 3: dijkstra() Paths Unchanged ===\n");
+    network_topology network;
+    create_test_topology(&network);
+    dense_graph view;
+    dense_from_topology(&view, &network);
+    int n = network.node_count;
+    int ref_dist[MAX_NODES], ref_prev[MAX_NODES];
+
+    bool paths_correct = true;
+    for (int source = 0; source < n; source++) {
+        reference_dijkstra(&view, source, ref_dist, ref_prev);
+        for (int dest = 0; dest < n; dest++) {
+            int* path = NULL;
+            int length = dijkstra(&network, source, dest, &path);
+
+            // Walk the reference tree backwards from the destination
+            bool same = (length > 0) || (ref_dist[dest] == INT_MAX);
+            int node = dest;
+            for (int i = length - 1; same && i >= 0; i--) {
+                same = (path[i] == node);
+                node = ref_prev[node];
+            }
+            if (!same || (length > 0 && (ref_dist[dest] == INT_MAX || path[0] != source))) {
+                printf("  ✗ Path %d -> %d differs from the reference\n", source, dest);
+                paths_correct = false;
+            }
+            free(path);
+        }
+    }
+    if (paths_correct && view.edge_count > 0 && !view.owns_weights) {
+        printf("  ✓ All %d source/destination pairs match, the topology matrix is used in place\n", n * n);
+        test_passed++;
+    } else {
+        printf("  ✗ dijkstra() paths or topology view wrong\n");
+    }
+    total_tests++;
+
+    // Test 4: stopping at a target, unreachable nodes and parallel edges
+    printf("\n=== Test Case 4: Early Stop and Edge Cases ===\n");
+    csr_graph graph;
+    csr_generate_random(&graph, 50, 3, 20, 77);
+    dense_graph dense;
+    dense_from_csr(&dense, &graph);
+    int full_dist[50], full_prev[50], dist[50], prev[50];
+
+    bool early_correct = true;
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        dijkstra_dense(&dense, 0, -1, full_dist, full_prev, kernels[k], false);
+        for (int target = 0; target < 50; target++) {
+            dijkstra_dense(&dense, 0, target, dist, prev, kernels[k], false);
+            if (dist[target] != full_dist[target] || prev[target] != full_prev[target]) {
+                early_correct = false;
+            }
+        }
+    }
+    dense_free(&dense);
+    csr_free(&graph);
+
+    // 0 -> 1 twice (weights 5 and 2), 2 isolated
+    int offsets[] = { 0, 2, 2, 2 };
+    int targets[] = { 1, 1 };
+    int weights[] = { 5, 2 };
+    csr_graph tiny = { 3, 2, offsets, targets, weights, 5 };
+    dense_from_csr(&dense, &tiny);
+    dijkstra_dense(&dense, 0, 2, dist, prev, DENSE_KERNEL_AUTO, false);
+    bool edge_cases_correct = (dense.edge_count == 1) && (dist[1] == 2) && (prev[1] == 0) &&
+                              (dist[2] == INT_MAX) && (prev[2] == -1) && (dense.stride % 8 == 0);
+    dense_free(&dense);
+
+    if (early_correct && edge_cases_correct) {
+        printf("  ✓ Early stop settles the target exactly, lightest parallel edge kept\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Early stop or edge cases wrong (early stop %s)\n", early_correct ? "ok" : "wrong");
+    }
+    total_tests++;
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,203 @@
+/**
+ * fast_reroute_test.c
+ * Test program for loop-free alternates, remote LFAs and reroute during reconvergence
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/fast_reroute.h"
+
+// Link in both directions with the same weight
+static void add_link(network_topology* network, int a, int b, int weight) {
+    add_connection(network, a, b, weight);
+    add_connection(network, b, a, weight);
+}
+
+// Ring 0-1-2-3-4-0 with unit weights: routes to a neighbor have no plain LFA
+static void create_ring(network_topology* network, csr_graph* graph) {
+    init_network_topology(network, 5);
+    for (int i = 0; i < 5; i++) {
+        add_link(network, i, (i + 1) % 5, 1);
+    }
+    csr_from_topology(graph, network);
+}
+
+// True if primary next hops lead from `from` to `to` without passing `avoid`
+static bool path_avoids(const frr_table* table, int from, int to, int avoid) {
+    int n = table->node_count;
+    for (int r = from, hops = 0; r != to; hops++) {
+        if (r == avoid || r < 0 || hops > n) return false;
+        r = table->next_hop[r * n + to];
+    }
+    return true;
+}
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+
+    printf("=== Fast Reroute Functionality Test ===\n\n");
+
+    // Test 1: every backup on random meshes reaches the destination without coming back
+    printf("=== Test Case 1: Backups Are Loop-Free ===\n");
+    bool loop_free = true;
+    long backups = 0, routes = 0;
+    unsigned int seed = 12345;
+    for (int trial = 0; trial < 10; trial++) {
+        network_topology network;
+        init_network_topology(&network, MAX_NODES);
+        for (int i = 0; i < MAX_NODES; i++) {
+            add_link(&network, i, (i + 1) % MAX_NODES, 1 + (int)(seed % 9));
+            seed = seed * 1103515245u + 12345u;
+            int other = (int)((seed >> 16) % MAX_NODES);
+            seed = seed * 1103515245u + 12345u;
+            if (other != i) add_link(&network, i, other, 1 + (int)((seed >> 16) % 9));
+        }
+        csr_graph graph;
+        csr_from_topology(&graph, &network);
+        frr_table table;
+        frr_table_build(&table, &graph, FRR_REMOTE_LFA);
+        routes += table.routes;
+
+        int n = table.node_count;
+        for (int s = 0; s < n; s++) {
+            for (int d = 0; d < n; d++) {
+                int tunnel_to;
+                int backup = frr_next_hop(&table, s, d, true, &tunnel_to);
+                if (backup < 0) continue;
+                backups++;
+                int e = table.next_hop[s * n + d];
+                bool ok = (backup != e) && (network.graph[s][backup] > 0);
+                if (tunnel_to < 0) {
+                    ok = ok && path_avoids(&table, backup, d, s);
+                } else {
+                    // Tunnel along the primary path to the repair node, then its own path
+                    ok = ok && table.next_hop[s * n + tunnel_to] == backup &&
+                         path_avoids(&table, backup, tunnel_to, s) && path_avoids(&table, tunnel_to, d, s);
+                }
+                if (!ok) {
+                    printf("  ✗ Backup %d of %d -> %d (repair %d) can loop or use the link\n", backup, s, d, tunnel_to);
+                    loop_free = false;
+                }
+            }
+        }
+        frr_table_free(&table);
+        csr_free(&graph);
+    }
+    if (loop_free && backups > routes / 2) {
+        printf("  ✓ %ld of %ld routes protected, every backup avoids the router and the link\n", backups, routes);
+        test_passed++;
+    } else {
+        printf("  ✗ Backups wrong or too few (%ld of %ld routes)\n", backups, routes);
+    }
+    total_tests++;
+
+    // Test 2: kinds of backup on small known topologies
+    printf("\n=== Test Case 2: LFA, Node LFA and Remote LFA Selection ===\n");
+    network_topology ring;
+    csr_graph ring_graph;
+    create_ring(&ring, &ring_graph);
+    frr_table lfa_only, remote;
+    frr_table_build(&lfa_only, &ring_graph, FRR_LFA);
+    frr_table_build(&remote, &ring_graph, FRR_REMOTE_LFA);
+
+    // 0 -> 1 in the ring: neighbor 4 would send it back, node 3 is a remote LFA;
+    // 0 -> 2 can use neighbor 4, which avoids node 1 too
+    int tunnel_to;
+    bool ring_correct = (frr_next_hop(&lfa_only, 0, 1, true, &tunnel_to) == -1) &&
+                        (frr_next_hop(&remote, 0, 1, false, &tunnel_to) == 1) && (tunnel_to == -1) &&
+                        (frr_next_hop(&remote, 0, 1, true, &tunnel_to) == 4) && (tunnel_to == 3) &&
+                        (remote.backup[0 * 5 + 1] == FRR_BACKUP_REMOTE_LFA) &&
+                        (frr_next_hop(&lfa_only, 0, 2, true, &tunnel_to) == 4) && (tunnel_to == -1) &&
+                        (lfa_only.backup[0 * 5 + 2] == FRR_BACKUP_NODE_LFA) &&
+                        (lfa_only.lfa == 0) && (lfa_only.node_lfa == 10) && (remote.remote_lfa == 10);
+
+    // A chord 0-2 of weight 5 is a plain LFA towards 1; towards 2, neighbor 4 also avoids node 1
+    network_topology chord = ring;
+    add_link(&chord, 0, 2, 5);
+    csr_graph chord_graph;
+    csr_from_topology(&chord_graph, &chord);
+    frr_table chord_table;
+    frr_table_build(&chord_table, &chord_graph, FRR_REMOTE_LFA);
+    bool chord_correct = (frr_next_hop(&chord_table, 0, 1, true, &tunnel_to) == 2) && (tunnel_to == -1) &&
+                         (chord_table.backup[0 * 5 + 1] == FRR_BACKUP_LFA) &&
+                         (frr_next_hop(&chord_table, 0, 2, true, &tunnel_to) == 4) &&
+                         (chord_table.backup[0 * 5 + 2] == FRR_BACKUP_NODE_LFA);
+    frr_table_free(&lfa_only);
+    frr_table_free(&remote);
+    frr_table_free(&chord_table);
+
+    if (ring_correct && chord_correct) {
+        printf("  ✓ Ring needs remote LFAs towards neighbors (0 -> 1 tunnels to 3 via 4), chord gives a plain LFA\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Wrong backups (ring %s, chord %s)\n", ring_correct ? "ok" : "wrong", chord_correct ? "ok" : "wrong");
+    }
+    total_tests++;
+
+    // Test 3: fragments sent while the ring reconverges around a failed link
+    printf("\n=== Test Case 3: Reroute During Reconvergence ===\n");
+    frr_sim_config config;
+    frr_sim_report report;
+    init_frr_sim_config(&config);
+    link_delta failed[2] = { { 0, 1 }, { 1, 0 } };
+    int result = frr_simulate_failure(&ring_graph, failed, 2, &config, &report);
+    printf("  %d affected flows, %.1f ms to converge: %ld/%ld delivered unprotected, %ld/%ld with remote LFAs\n",
+           report.affected_pairs, report.convergence_us / 1000.0, report.unprotected.delivered,
+           report.unprotected.sent, report.fast_reroute.delivered, report.fast_reroute.sent);
+
+    config.protection = FRR_LFA;
+    frr_sim_report lfa_report;
+    frr_simulate_failure(&ring_graph, failed, 2, &config, &lfa_report);
+
+    // 4 -> 1 and 2 -> 0 meet the failure one hop in, at a router that has a backup too
+    bool reroute_correct = (result == 0) && (report.affected_pairs == 6) && (report.protected_routes == 6) &&
+                           (lfa_report.protected_routes == 2) &&
+                           (report.unprotected.sent > 0) &&
+                           (report.unprotected.sent == report.fast_reroute.sent) &&
+                           (report.fast_reroute.delivered == report.fast_reroute.sent) &&
+                           (report.unprotected.dropped > 0) &&
+                           (report.fast_reroute.repaired > 0) &&
+                           (lfa_report.fast_reroute.delivered > lfa_report.unprotected.delivered) &&
+                           (lfa_report.fast_reroute.delivered < lfa_report.fast_reroute.sent);
+    if (reroute_correct) {
+        printf("  ✓ Remote LFAs protect all 6 routes and deliver every fragment, plain LFAs 2 towards distant nodes\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Reroute outcome wrong\n");
+    }
+    total_tests++;
+
+    // Test 4: a link missing from the graph is rejected, FRR_NONE computes no backups
+    printf("\n=== Test Case 4: Invalid Failures and No Protection ===\n");
+    link_delta missing = { 0, 2 };
+    frr_table none;
+    frr_table_build(&none, &ring_graph, FRR_NONE);
+    bool none_correct = (frr_simulate_failure(&ring_graph, &missing, 1, &config, &report) == -1) &&
+                        (none.routes == 20) && (none.lfa + none.node_lfa + none.remote_lfa == 0) &&
+                        (frr_next_hop(&none, 2, 0, true, &tunnel_to) == -1) &&
+                        (frr_next_hop(&none, 2, 2, false, &tunnel_to) == 2);
+    frr_table_free(&none);
+    csr_free(&ring_graph);
+    csr_free(&chord_graph);
+
+    if (none_correct) {
+        printf("  ✓ Missing link rejected, unprotected table has primary next hops only\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Invalid failures or FRR_NONE handled wrong\n");
+    }
+    total_tests++;
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,157 @@
+/**
+ * fragment_batch_test.c
+ * Test program for structure-of-arrays fragment batches and header checksums
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/ipv4.h"
+
+static unsigned int next_random(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// True if every batch header equals its recomputed checksum
+static int checksums_valid(const fragment_batch* batch) {
+    for (int i = 0; i < batch->count; i++) {
+        ipv4_header header;
+        fragment_batch_header(batch, i, &header);
+        if (calculate_checksum(&header) != header.checksum) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+
+    printf("=== Fragment Batch Functionality Test ===\n\n");
+
+    // Test 1: the checksum of a well-known header (4500 0073 0000 4000 4011 b861 c0a8 0001 c0a8 00c7)
+    printf("=== Test Case 1: Internet Checksum ===\n");
+    ipv4_header known = { 0x45, 0, 0x0073, 0, 0x4000, 0x40, 0x11, 0, 0xC0A80001, 0xC0A800C7 };
+    uint16_t known_checksum = calculate_checksum(&known);
+    known.checksum = known_checksum;
+    if (known_checksum == 0xB861 && calculate_checksum(&known) == 0xB861) {
+        printf("  ✓ Checksum is 0xB861 and ignores the checksum field\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Checksum is 0x%04X, expected 0xB861\n", known_checksum);
+    }
+    total_tests++;
+
+    // Test 2: batch emission produces the headers of fragment_ipv4_packet()
+    printf("\n=== Test Case 2: Same Headers as fragment_ipv4_packet() ===\n");
+    int mtus[] = { 68, 576, 1006, 1500, 4352, 9000 };
+    int payloads[] = { 1, 48, 1472, 1480, 1481, 4000, 12345, MAX_PAYLOAD_SIZE };
+    fragment_batch batch;
+    fragment_batch_init(&batch, 0);
+    int headers_correct = 1;
+    int compared = 0;
+
+    for (int m = 0; m < 6; m++) {
+        for (int p = 0; p < 8; p++) {
+            ipv4_packet packet;
+            ipv4_fragment* fragments;
+            create_ipv4_packet_virtual(&packet, 0x0A000001, 0x0A000501, payloads[p], PAYLOAD_PATTERN_SEQUENTIAL, 0);
+            int count = fragment_ipv4_packet(&packet, mtus[m], &fragments);
+            int first = batch.count;
+            int appended = fragment_ipv4_packet_batch(&packet, mtus[m], &batch);
+
+            headers_correct &= (appended == count);
+            for (int i = 0; i < count && appended == count; i++) {
+                ipv4_header header;
+                fragment_batch_header(&batch, first + i, &header);
+                const ipv4_header* expected = &fragments[i].header;
+                headers_correct &= header.version_ihl == expected->version_ihl && header.tos == expected->tos &&
+                                   header.total_len == expected->total_len &&
+                                   header.identifier == expected->identifier &&
+                                   header.flags_frag_offset == expected->flags_frag_offset &&
+                                   header.ttl == expected->ttl && header.protocol == expected->protocol &&
+                                   header.checksum == expected->checksum &&
+                                   header.source_ip == expected->source_ip && header.dest_ip == expected->dest_ip &&
+                                   batch.data_offset[first + i] == fragments[i].content.offset;
+                compared++;
+            }
+            free(fragments);
+        }
+    }
+
+    if (headers_correct) {
+        printf("  ✓ %d fragment headers and data offsets match\n", compared);
+        test_passed++;
+    } else {
+        printf("  ✗ Batch headers differ from fragment_ipv4_packet()\n");
+    }
+    total_tests++;
+
+    // Test 3: the vectorized checksum agrees with calculate_checksum() on arbitrary fields
+    printf("\n=== Test Case 3: Batch Checksums ===\n");
+    unsigned int seed = 12345;
+    for (int i = 0; i < batch.count; i++) {
+        batch.tos[i] = (uint8_t)next_random(&seed);
+        batch.ttl[i] = (uint8_t)next_random(&seed);
+        batch.protocol[i] = (uint8_t)next_random(&seed);
+        batch.total_len[i] = (uint16_t)next_random(&seed);
+        batch.identifier[i] = (uint16_t)next_random(&seed);
+        batch.flags_frag_offset[i] = (uint16_t)next_random(&seed);
+        batch.source_ip[i] = next_random(&seed);
+        batch.dest_ip[i] = (i % 3 == 0) ? 0xFFFFFFFFu : next_random(&seed);
+    }
+    fragment_batch_checksum(&batch, 0, batch.count);
+    int simd_correct = checksums_valid(&batch);
+    // An odd range leaves a scalar tail on both sides
+    batch.checksum[3] ^= 0xFFFF;
+    batch.checksum[21] ^= 0xFFFF;
+    fragment_batch_checksum(&batch, 3, 19);
+    simd_correct &= checksums_valid(&batch);
+
+    if (simd_correct) {
+        printf("  ✓ %d random headers checksummed correctly\n", batch.count);
+        test_passed++;
+    } else {
+        printf("  ✗ Batch checksum differs from calculate_checksum()\n");
+    }
+    total_tests++;
+
+    // Test 4: TTL decrement keeps checksums valid and reports expired fragments
+    printf("\n=== Test Case 4: TTL Decrement ===\n");
+    int ttl_correct = 1;
+    for (int round = 0; round < 3; round++) {
+        int expected_expired = 0;
+        for (int i = 0; i < batch.count; i++) {
+            expected_expired += (batch.ttl[i] <= 1);
+        }
+        int expired = fragment_batch_decrement_ttl(&batch);
+        ttl_correct &= (expired == expected_expired) && checksums_valid(&batch);
+    }
+
+    if (ttl_correct) {
+        printf("  ✓ Incrementally updated checksums match full recomputation\n");
+        test_passed++;
+    } else {
+        printf("  ✗ TTL decrement broke checksums or miscounted expired fragments\n");
+    }
+    total_tests++;
+
+    fragment_batch_free(&batch);
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
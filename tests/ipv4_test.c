@@ -9,7 +9,7 @@
  #include "../include/ipv4.h"
  
  // Function to print IP address in readable format
- void print_ip_address(uint32_t ip) {
+ static void print_ip_address(uint32_t ip) {
      printf("%d.%d.%d.%d", 
          (ip >> 24) & 0xFF,
          (ip >> 16) & 0xFF,
@@ -18,7 +18,7 @@
  }
  
  // Function to display packet information
- void display_packet_info(ipv4_packet* packet) {
+ static void display_packet_info(ipv4_packet* packet) {
      printf("IPv4 Header:\n");
      printf("  Version: %d\n", (packet->header.version_ihl >> 4) & 0x0F);
      printf("  IHL: %d (bytes: %d)\n", packet->header.version_ihl & 0x0F, (packet->header.version_ihl & 0x0F) * 4);
@@ -45,7 +45,7 @@
  }
  
  // Function to display fragment information
- void display_fragment_info(ipv4_fragment* fragment) {
+ static void display_fragment_info(ipv4_fragment* fragment) {
      printf("  Total Length: %d bytes\n", fragment->header.total_len);
      printf("  Identification: 0x%04X\n", fragment->header.identifier);
      printf("  Flags: 0x%X\n", (fragment->header.flags_frag_offset >> 13) & 0x07);
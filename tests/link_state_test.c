@@ -0,0 +1,171 @@
+/**
+ * link_state_test.c
+ * Test program for LSA flooding, link-state databases and throttled SPF
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/link_state.h"
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+
+    printf("=== Link-State Routing Functionality Test ===\n\n");
+
+    link_state_config config;
+    init_link_state_config(&config);
+
+    // Test 1: a change made in the topology reaches every router and their routes follow
+    printf("=== Test Case 1: Flooding After a Topology Change ===\n");
+    network_topology network;
+    create_test_topology(&network);
+    link_state_sim sim;
+    link_state_init_network(&sim, &network, &config);
+
+    network.graph[3][5] = 0;
+    network.graph[0][5] = 30;
+    int changes = link_state_sync(&sim, &network, 0);
+    ls_report report;
+    link_state_run(&sim, &report);
+
+    int flooding_correct = (changes == 2) && link_state_verify(&sim) &&
+                           (sim.routers[0].dist[5] == 24) &&
+                           (sim.routers[5].lsdb[3].lsa->sequence == 2) &&
+                           (sim.routers[5].lsdb[0].lsa->sequence == 2) &&
+                           (link_state_lsa_age(&sim, 0, 0) == 0) &&
+                           (link_state_lsa_age(&sim, 5, 0) >= LSA_TRANSMIT_DELAY) &&
+                           (report.convergence_us >= config.spf_initial_us) &&
+                           (report.flooding_us < report.convergence_us);
+
+    if (flooding_correct) {
+        printf("  ✓ New LSAs (sequence 2) reached router 5, routes converged in %.3f ms\n",
+               report.convergence_us / 1000.0);
+        test_passed++;
+    } else {
+        printf("  ✗ Routers did not converge on the changed topology\n");
+    }
+    total_tests++;
+    link_state_free(&sim);
+
+    // Test 2: incremental SPF gives the same routes as full SPF with less work
+    printf("\n=== Test Case 2: Incremental vs Full SPF ===\n");
+    csr_graph graph;
+    csr_generate_random(&graph, 300, 3, 50, 5);
+
+    link_state_sim incremental_sim, full_sim;
+    link_state_init(&incremental_sim, &graph, &config);
+    config.incremental = false;
+    link_state_init(&full_sim, &graph, &config);
+    config.incremental = true;
+
+    int spf_correct = 1;
+    long incremental_work = 0, full_work = 0;
+    unsigned int state = 17;
+    for (int i = 0; i < 40 && spf_correct; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        int from = (int)(state % graph.node_count);
+        int to = graph.targets[graph.offsets[from] + (int)((state >> 8) % 3)];
+        int weight = (i % 4 == 0) ? 0 : 1 + (int)((state >> 16) % 50);
+
+        ls_report a, b;
+        link_state_change_link(&incremental_sim, 20000000, from, to, weight);
+        link_state_change_link(&full_sim, 20000000, from, to, weight);
+        link_state_run(&incremental_sim, &a);
+        link_state_run(&full_sim, &b);
+        incremental_work += a.total_work;
+        full_work += b.total_work;
+        spf_correct &= (a.spf_full == 0) && (b.spf_incremental == 0);
+    }
+    spf_correct &= link_state_verify(&incremental_sim) && link_state_verify(&full_sim) &&
+                   (incremental_work < full_work);
+
+    if (spf_correct) {
+        printf("  ✓ 40 changes: same routes, %ld vs %ld SPF work units\n", incremental_work, full_work);
+        test_passed++;
+    } else {
+        printf("  ✗ Incremental SPF diverged from full SPF\n");
+    }
+    total_tests++;
+    link_state_free(&incremental_sim);
+    link_state_free(&full_sim);
+
+    // Test 3: changes in quick succession back off to the maximum hold time
+    printf("\n=== Test Case 3: SPF Throttling ===\n");
+    link_state_init(&sim, &graph, &config);
+    long long first = 0, last = 0;
+    for (int i = 0; i < 12; i++) {
+        link_state_change_link(&sim, 100000, i, graph.targets[graph.offsets[i]], 1 + i);
+        link_state_run(&sim, &report);
+        if (i == 0) first = report.convergence_us;
+        last = report.convergence_us;
+    }
+    // After a quiet period the initial delay applies again
+    link_state_change_link(&sim, 2 * config.spf_max_wait_us, 20, graph.targets[graph.offsets[20]], 7);
+    link_state_run(&sim, &report);
+
+    int throttle_correct = (first < config.spf_hold_us) &&
+                           (last > config.spf_max_wait_us / 2) && (last <= config.spf_max_wait_us + 100000) &&
+                           (report.convergence_us < config.spf_hold_us) && link_state_verify(&sim);
+
+    if (throttle_correct) {
+        printf("  ✓ Convergence %.1f ms, backs off to %.1f ms, resets to %.1f ms when quiet\n",
+               first / 1000.0, last / 1000.0, report.convergence_us / 1000.0);
+        test_passed++;
+    } else {
+        printf("  ✗ Throttle timers misbehave (%lld, %lld, %lld us)\n", first, last, report.convergence_us);
+    }
+    total_tests++;
+    link_state_free(&sim);
+    csr_free(&graph);
+
+    // Test 4: refreshed LSAs never age out, copies from a cut-off router are flushed at MaxAge
+    printf("\n=== Test Case 4: LSA Refresh And MaxAge ===\n");
+    init_network_topology(&network, 4);
+    for (int u = 0; u < 3; u++) {
+        add_connection(&network, u, u + 1, 2);
+        add_connection(&network, u + 1, u, 2);
+    }
+    link_state_init_network(&sim, &network, &config);
+
+    // Setting a link to the weight it has originates nothing
+    link_state_change_link(&sim, 10000000, 0, 1, 2);
+    link_state_run(&sim, &report);
+    int aging_correct = (report.flooding_us == 0) && (report.convergence_us == 0) && (report.lsa_messages == 0);
+
+    // Cut router 3 off, then let two hours pass before the next change
+    link_state_change_link(&sim, 0, 2, 3, 0);
+    link_state_change_link(&sim, 0, 3, 2, 0);
+    link_state_run(&sim, &report);
+    link_state_change_link(&sim, 7200000000LL, 0, 1, 5);
+    link_state_run(&sim, &report);
+    long flushed = sim.routers[0].stats.lsas_flushed;
+
+    aging_correct = aging_correct && (report.flooding_us >= 0) && link_state_verify(&sim) &&
+                    (link_state_lsa_age(&sim, 2, 0) < LSA_REFRESH_TIME) &&
+                    (link_state_lsa_age(&sim, 0, 3) == -1) && (link_state_lsa_age(&sim, 3, 0) == -1) &&
+                    (flushed == 1) && (sim.routers[0].dist[2] == 7);
+
+    if (aging_correct) {
+        printf("  ✓ No-op change cost nothing, LSAs refreshed over 2 hours, router 3's copy flushed at MaxAge\n");
+        test_passed++;
+    } else {
+        printf("  ✗ LSA aging wrong (router 0 flushed %ld LSAs)\n", flushed);
+    }
+    total_tests++;
+    link_state_free(&sim);
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
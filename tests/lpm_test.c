@@ -0,0 +1,217 @@
+/**
+ * lpm_test.c
+ * Test program for longest-prefix-match tables and per-router forwarding
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/dijkstra.h"
+#include "../include/forwarding.h"
+#include "../include/lpm.h"
+#include "test_helpers.h"
+
+// Reference lookup: scan every route and keep the longest match (last one wins on ties)
+static uint32_t linear_lookup(const lpm_route* routes, int count, uint32_t address) {
+    int best_length = -1;
+    uint32_t best = LPM_NO_ROUTE;
+    for (int i = 0; i < count; i++) {
+        uint32_t mask = (routes[i].length == 0) ? 0 : 0xFFFFFFFFu << (32 - routes[i].length);
+        if ((address & mask) == (routes[i].prefix & mask) && routes[i].length >= best_length) {
+            best_length = routes[i].length;
+            best = routes[i].next_hop;
+        }
+    }
+    return best;
+}
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+
+    printf("=== Longest Prefix Match Functionality Test ===\n\n");
+
+    // Test 1: overlapping prefixes inserted in mixed length order
+    printf("=== Test Case 1: Overlapping Prefixes ===\n");
+    lpm_table table;
+    lpm_init(&table);
+    lpm_add(&table, 0xC0A80180, 25, 4);  // 192.168.1.128/25
+    lpm_add(&table, 0xC0A80100, 24, 3);  // 192.168.1.0/24
+    lpm_add(&table, 0xC0A80000, 16, 2);  // 192.168.0.0/16
+    lpm_add(&table, 0xC0A80105, 32, 5);  // 192.168.1.5/32
+    lpm_add(&table, 0x00000000, 0, 1);   // default route
+
+    int overlap_correct = lpm_lookup(&table, 0xC0A80105) == 5 &&
+                          lpm_lookup(&table, 0xC0A80106) == 3 &&
+                          lpm_lookup(&table, 0xC0A801FF) == 4 &&
+                          lpm_lookup(&table, 0xC0A8FF01) == 2 &&
+                          lpm_lookup(&table, 0x08080808) == 1;
+    lpm_free(&table);
+
+    if (overlap_correct) {
+        printf("  ✓ /32, /25, /24, /16 and default routes resolve to the longest match\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Overlapping prefixes resolved incorrectly\n");
+    }
+    total_tests++;
+
+    // Test 2: random tables against a linear scan
+    printf("\n=== Test Case 2: Random Tables vs Linear Scan ===\n");
+    lpm_route* routes;
+    int route_count = 3000;
+    lpm_generate_routes(&routes, route_count, 100, 11);
+    // Concentrate some routes so that prefixes actually overlap
+    for (int i = 0; i < route_count; i += 3) {
+        routes[i].prefix = (routes[i].prefix & 0x00FFFFFFu) | 0x0A000000u;
+        routes[i].prefix &= (routes[i].length == 0) ? 0 : 0xFFFFFFFFu << (32 - routes[i].length);
+    }
+
+    lpm_init(&table);
+    for (int i = 0; i < route_count; i++) {
+        lpm_add(&table, routes[i].prefix, routes[i].length, routes[i].next_hop);
+    }
+
+    int random_correct = 1;
+    unsigned int state = 99;
+    for (int i = 0; i < 20000 && random_correct; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        // Half of the probes land inside a route, half anywhere
+        uint32_t address = state;
+        if (i % 2 == 0) {
+            const lpm_route* route = &routes[state % route_count];
+            address = route->prefix | ((route->length == 32) ? 0 : (state >> 3) & (0xFFFFFFFFu >> route->length));
+        }
+        uint32_t expected = linear_lookup(routes, route_count, address);
+        if (lpm_lookup(&table, address) != expected) {
+            printf("  ✗ Address 0x%08X: got %u, expected %u\n", address, lpm_lookup(&table, address), expected);
+            random_correct = 0;
+        }
+    }
+    lpm_free(&table);
+    free(routes);
+
+    if (random_correct) {
+        printf("  ✓ 20000 lookups agree with the linear scan\n");
+        test_passed++;
+    }
+    total_tests++;
+
+    // Test 3: node addressing helpers
+    printf("\n=== Test Case 3: Node Addressing ===\n");
+    network_topology network;
+    create_test_topology(&network);
+
+    char text[16];
+    format_ipv4_address(node_address(5), text);
+    int addressing_correct = strcmp(text, "10.0.5.1") == 0 &&
+                             address_to_node(&network, node_address(3)) == 3 &&
+                             address_to_node(&network, 0x0A000A01) == -1 &&
+                             address_to_node(&network, 0xC0A80101) == -1;
+
+    if (addressing_correct) {
+        printf("  ✓ Node 5 is 10.0.5.1, addresses map back to their owner\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Node addressing is wrong (node 5 formatted as %s)\n", text);
+    }
+    total_tests++;
+
+    // Test 4: hop-by-hop forwarding follows shortest paths
+    printf("\n=== Test Case 4: Forwarding Along Shortest Paths ===\n");
+    forwarding_plane plane;
+    forwarding_build(&plane, &network);
+
+    int forwarding_correct = 1;
+    for (int source = 0; source < network.node_count; source++) {
+        for (int dest = 0; dest < network.node_count; dest++) {
+            if (source == dest) continue;
+
+            int* expected = NULL;
+            int* path = NULL;
+            int expected_length = dijkstra(&network, source, dest, &expected);
+            int length = forwarding_route(&plane, source, node_address(dest), &path);
+
+            // Equal-cost paths may break ties differently, so compare costs
+            int expected_cost = 0, cost = 0;
+            for (int i = 0; i + 1 < expected_length; i++) {
+                expected_cost += network.graph[expected[i]][expected[i + 1]];
+            }
+            for (int i = 0; i + 1 < length; i++) {
+                cost += network.graph[path[i]][path[i + 1]];
+            }
+            if ((expected_length > 0) != (length > 0) || expected_cost != cost ||
+                (length > 0 && (path[0] != source || path[length - 1] != dest))) {
+                printf("  ✗ Route %d -> %d differs from dijkstra()\n", source, dest);
+                forwarding_correct = 0;
+            }
+            free(expected);
+            free(path);
+        }
+    }
+    forwarding_free(&plane);
+
+    if (forwarding_correct) {
+        printf("  ✓ Every router-to-router route has the cost found by dijkstra()\n");
+        test_passed++;
+    }
+    total_tests++;
+
+    // Test 5: after a link change the rows follow the route cache, the prefix table is kept
+    printf("\n=== Test Case 5: Forwarding Update From Route Trees ===\n");
+    forwarding_build(&plane, &network);
+    route_cache cache;
+    route_cache_init(&cache, &network);
+    forwarding_update(&plane, &cache);
+    const uint32_t* tbl24 = plane.prefixes.tbl24;
+
+    route_link_change change = { 3, 5, network.graph[3][5], 0 };
+    network.graph[3][5] = 0;
+    int recomputed = route_cache_update_links(&cache, &network, &change, 1);
+    forwarding_update(&plane, &cache);
+    forwarding_plane fresh;
+    forwarding_build(&fresh, &network);
+
+    int update_correct = (plane.prefixes.tbl24 == tbl24) && (recomputed > 0) &&
+                         (recomputed < network.node_count);
+    for (int source = 0; source < network.node_count && update_correct; source++) {
+        for (int dest = 0; dest < network.node_count; dest++) {
+            int* path = NULL;
+            int* expected = NULL;
+            int length = forwarding_route(&plane, source, node_address(dest), &path);
+            int expected_length = forwarding_route(&fresh, source, node_address(dest), &expected);
+            if ((length > 0) != (expected_length > 0) ||
+                (length > 0 && path_cost(&network, path, length) != path_cost(&network, expected, expected_length))) {
+                update_correct = 0;
+            }
+            free(path);
+            free(expected);
+        }
+    }
+    forwarding_free(&fresh);
+    forwarding_free(&plane);
+    route_cache_free(&cache);
+
+    if (update_correct) {
+        printf("  ✓ %d of %d trees recomputed, routes match a full rebuild, prefix table kept\n",
+               recomputed, network.node_count);
+        test_passed++;
+    } else {
+        printf("  ✗ Updated forwarding rows differ from a full rebuild\n");
+    }
+    total_tests++;
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,128 @@
+/**
+ * mtu_sweep_test.c
+ * Test program for the MTU sweep analyzer
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/mtu_sweep.h"
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+
+    printf("=== MTU Sweep Functionality Test ===\n\n");
+
+    // Test 1: the layout arithmetic matches the real fragmenter at every point of a small grid
+    printf("=== Test Case 1: Layouts Match fragment_ipv4_packet() ===\n");
+    int layout_correct = 1;
+    for (int mtu = 68; mtu <= 160 && layout_correct; mtu++) {
+        for (int payload = 1; payload <= 1200 && layout_correct; payload++) {
+            ipv4_packet packet;
+            ipv4_fragment* fragments;
+            create_ipv4_packet_virtual(&packet, 0, 1, payload, PAYLOAD_PATTERN_SEQUENTIAL, 0);
+            int count = fragment_ipv4_packet(&packet, mtu, &fragments);
+            int wire = 0;
+            for (int i = 0; i < count; i++) {
+                wire += fragments[i].header.total_len;
+            }
+            free(fragments);
+
+            fragment_layout layout;
+            if (!fragment_layout_of(mtu, payload, &layout) || layout.fragments != count ||
+                layout.wire_bytes != wire || layout.wasted_bytes != count * mtu - wire) {
+                printf("  ✗ MTU %d, payload %d: %d fragments, fragmenter made %d\n",
+                       mtu, payload, layout.fragments, count);
+                layout_correct = 0;
+            }
+        }
+    }
+
+    if (layout_correct) {
+        printf("  ✓ Fragment counts and wire bytes agree for MTU 68..160, payload 1..1200\n");
+        test_passed++;
+    }
+    total_tests++;
+
+    // Test 2: run-based cells equal point-by-point sums, whatever the thread count
+    printf("\n=== Test Case 2: Sweep Cells vs Point Sums ===\n");
+    mtu_sweep_config config;
+    init_mtu_sweep_config(&config);
+    config.mtu_min = 68;
+    config.mtu_max = 700;
+    config.payload_max = 5000;
+    config.payload_bins = 7;
+    config.threads = 1;
+
+    mtu_sweep_result single, parallel;
+    run_mtu_sweep(&config, &single);
+    config.threads = 4;
+    run_mtu_sweep(&config, &parallel);
+
+    int cells_correct = 1;
+    for (int i = 0; i < single.mtu_count && cells_correct; i++) {
+        for (int bin = 0; bin < single.payload_bins; bin++) {
+            mtu_sweep_cell expected = { 0, 0, 0, 0 };
+            for (int p = mtu_sweep_bin_start(&single, bin); p < mtu_sweep_bin_start(&single, bin + 1); p++) {
+                fragment_layout layout;
+                fragment_layout_of(single.mtu_min + i, p, &layout);
+                expected.payload_bytes += p;
+                expected.fragments += layout.fragments;
+                expected.header_bytes += layout.header_bytes;
+                expected.wasted_bytes += layout.wasted_bytes;
+            }
+            const mtu_sweep_cell* cell = &single.cells[(size_t)i * single.payload_bins + bin];
+            if (memcmp(cell, &expected, sizeof(expected)) != 0) {
+                printf("  ✗ MTU %d bin %d differs from the point sum\n", single.mtu_min + i, bin);
+                cells_correct = 0;
+                break;
+            }
+        }
+    }
+    cells_correct &= memcmp(single.cells, parallel.cells,
+                            (size_t)single.mtu_count * single.payload_bins * sizeof(mtu_sweep_cell)) == 0;
+    cells_correct &= memcmp(single.totals, parallel.totals, single.mtu_count * sizeof(mtu_sweep_cell)) == 0;
+    cells_correct &= (mtu_sweep_verify(&parallel, 500, 3) == 0);
+
+    if (cells_correct) {
+        printf("  ✓ %d MTUs x %d bins match, 1 and 4 threads agree\n", single.mtu_count, single.payload_bins);
+        test_passed++;
+    }
+    total_tests++;
+    mtu_sweep_free(&single);
+    mtu_sweep_free(&parallel);
+
+    // Test 3: invalid ranges are rejected
+    printf("\n=== Test Case 3: Invalid Ranges ===\n");
+    mtu_sweep_result rejected;
+    init_mtu_sweep_config(&config);
+    config.mtu_min = 20;
+    int invalid_correct = (run_mtu_sweep(&config, &rejected) == -1);
+    init_mtu_sweep_config(&config);
+    config.payload_max = MAX_PAYLOAD_SIZE + 1;
+    invalid_correct &= (run_mtu_sweep(&config, &rejected) == -1);
+    init_mtu_sweep_config(&config);
+    config.mtu_max = 60;
+    invalid_correct &= (run_mtu_sweep(&config, &rejected) == -1);
+
+    if (invalid_correct) {
+        printf("  ✓ MTU below 28, oversized payloads and empty MTU ranges are rejected\n");
+        test_passed++;
+    } else {
+        printf("  ✗ An invalid range was accepted\n");
+    }
+    total_tests++;
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,168 @@
+/**
+ * multicast_test.c
+ * Test program for multicast distribution trees and one-copy-per-link forwarding
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/dijkstra.h"
+#include "../include/multicast.h"
+#include "test_helpers.h"
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+
+    printf("=== Multicast Functionality Test ===\n\n");
+
+    // Test 1: every receiver's tree path is a shortest path, as found by dijkstra()
+    printf("=== Test Case 1: Tree Paths Are Shortest Paths ===\n");
+    network_topology network;
+    create_test_topology(&network);
+    int n = network.node_count;
+
+    bool paths_correct = true;
+    for (int source = 0; source < n; source++) {
+        int receivers[MAX_NODES];
+        for (int v = 0; v < n; v++) {
+            receivers[v] = v;
+        }
+        multicast_tree tree;
+        int reached = multicast_tree_build_topology(&tree, &network, source, receivers, n);
+
+        int expected_reached = 0;
+        for (int dest = 0; dest < n; dest++) {
+            if (dest == source) continue;
+            int* expected = NULL;
+            int* path = NULL;
+            int expected_length = dijkstra(&network, source, dest, &expected);
+            int length = multicast_tree_path(&tree, dest, &path);
+            if (expected_length > 0) expected_reached++;
+
+            if ((expected_length > 0) != (length > 0) ||
+                path_cost(&network, expected, expected_length) != path_cost(&network, path, length) ||
+                (length > 0 && (path[0] != source || path[length - 1] != dest))) {
+                printf("  ✗ Tree path %d -> %d is not a shortest path\n", source, dest);
+                paths_correct = false;
+            }
+            free(expected);
+            free(path);
+        }
+        if (reached != expected_reached || tree.link_count != reached || tree.unreachable != n - 1 - reached) {
+            printf("  ✗ Tree of %d: %d receivers, %d links\n", source, reached, tree.link_count);
+            paths_correct = false;
+        }
+        multicast_tree_free(&tree);
+    }
+    if (paths_correct) {
+        printf("  ✓ Broadcast trees from every source follow shortest paths, one link per reached node\n");
+        test_passed++;
+    }
+    total_tests++;
+
+    // Test 2: receivers sharing a route prefix share its links
+    printf("\n=== Test Case 2: Shared Links Carry One Copy ===\n");
+    int offsets[] = { 0, 1, 3, 4, 4, 4 };   // 0 -> 1 -> {2, 4}, 2 -> 3
+    int targets[] = { 1, 2, 4, 3 };
+    int weights[] = { 1, 1, 1, 1 };
+    csr_graph chain = { 5, 4, offsets, targets, weights, 1 };
+    int group[] = { 3, 4, 3, 0 };   // duplicate and the source are ignored
+
+    ipv4_packet packet;
+    ipv4_fragment* fragments;
+    create_ipv4_packet_virtual(&packet, 0, 3, 4000, PAYLOAD_PATTERN_SEQUENTIAL, 0);
+    int count = fragment_ipv4_packet(&packet, 1500, &fragments);
+
+    multicast_tree tree;
+    int reached = multicast_tree_build(&tree, &chain, 0, group, 4);
+    multicast_report report;
+    multicast_forward(&tree, fragments, count, &report);
+
+    // Tree links 0-1, 1-2, 2-3, 1-4; unicast paths 0-1-2-3 and 0-1-4
+    bool shared_correct = (reached == 2) && (tree.link_count == 4) && (tree.unicast_hops == 5) &&
+                          (tree.depth[3] == 3) && (tree.parent[4] == 1) && (tree.depth[2] == 2) &&
+                          !tree.is_receiver[2] &&
+                          (report.transmissions == 4LL * count) &&
+                          (report.link_bytes == 4 * report.fragment_bytes) &&
+                          (report.unicast_link_bytes == 5 * report.fragment_bytes) &&
+                          (report.deliveries == 2LL * count) &&
+                          (report.fragment_bytes == 4000 + count * IPV4_HEADER_SIZE);
+    multicast_tree_free(&tree);
+
+    if (shared_correct) {
+        printf("  ✓ %d fragments cross 4 links instead of 5, saving %.0f%%\n", count, report.savings * 100);
+        test_passed++;
+    } else {
+        printf("  ✗ Shared prefix counted wrong (%d links, %lld unicast hops)\n", tree.link_count, tree.unicast_hops);
+    }
+    total_tests++;
+
+    // Test 3: savings grow with the receiver set on a large random graph
+    printf("\n=== Test Case 3: Savings on Large Receiver Sets ===\n");
+    csr_graph graph;
+    csr_generate_random(&graph, 20000, 4, 100, 5);
+    int* everyone = (int*)malloc(20000 * sizeof(int));
+    for (int v = 0; v < 20000; v++) {
+        everyone[v] = (int)(((long long)v * 7919) % 20000);   // a permutation of all nodes
+    }
+
+    double previous = -1;
+    bool savings_correct = true;
+    for (int receivers = 10; receivers <= 10000; receivers *= 10) {
+        reached = multicast_tree_build(&tree, &graph, 0, everyone, receivers);
+        multicast_forward(&tree, fragments, count, &report);
+        printf("  %5d receivers: %d tree links, %lld unicast hops, %.1f%% of link bytes saved\n",
+               reached, tree.link_count, tree.unicast_hops, report.savings * 100);
+        if (report.savings <= previous || report.link_bytes > report.unicast_link_bytes ||
+            report.deliveries != (long long)reached * count) {
+            savings_correct = false;
+        }
+        previous = report.savings;
+        multicast_tree_free(&tree);
+    }
+    free(everyone);
+    csr_free(&graph);
+
+    if (savings_correct && previous > 0.5) {
+        printf("  ✓ Savings grow with the group and exceed 50%% at 10000 receivers\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Savings do not grow with the receiver set\n");
+    }
+    total_tests++;
+
+    // Test 4: invalid arguments and unreachable receivers
+    printf("\n=== Test Case 4: Invalid and Unreachable Receivers ===\n");
+    int bad[] = { 1, 9 };
+    int isolated[] = { 1, 0 };   // nothing leads back to node 0 in the chain
+    int* path = NULL;
+    bool invalid_correct = (multicast_tree_build(&tree, &chain, 7, bad, 1) == -1) &&
+                           (multicast_tree_build(&tree, &chain, 0, bad, 2) == -1);
+    reached = multicast_tree_build(&tree, &chain, 4, isolated, 2);
+    invalid_correct = invalid_correct && (reached == 0) && (tree.unreachable == 2) &&
+                      (tree.link_count == 0) && (multicast_tree_path(&tree, 1, &path) == -1) && (path == NULL);
+    multicast_forward(&tree, fragments, count, &report);
+    invalid_correct = invalid_correct && (report.transmissions == 0) && (report.savings == 0.0);
+    multicast_tree_free(&tree);
+    free(fragments);
+
+    if (invalid_correct) {
+        printf("  ✓ Bad nodes are rejected, unreachable receivers are counted and skipped\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Invalid or unreachable receivers handled wrong\n");
+    }
+    total_tests++;
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
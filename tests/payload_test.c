@@ -0,0 +1,137 @@
+/**
+ * payload_test.c
+ * Test program for virtual payloads and fragment reassembly
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/ipv4.h"
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+    static uint8_t full[MAX_PAYLOAD_SIZE];
+    static uint8_t slice[MAX_PAYLOAD_SIZE];
+
+    printf("=== Virtual Payload Functionality Test ===\n\n");
+
+    // Test 1: the vectorized sequential fill produces i % 256 at any offset and length
+    printf("=== Test Case 1: Sequential Pattern ===\n");
+    int sequential_correct = 1;
+    payload_desc desc = { PAYLOAD_PATTERN_SEQUENTIAL, 0, 0 };
+    for (uint32_t offset = 0; offset < 40; offset += 7) {
+        for (int length = 0; length < 100; length += 13) {
+            desc.offset = offset;
+            materialize_payload(&desc, slice, length);
+            for (int i = 0; i < length; i++) {
+                sequential_correct &= (slice[i] == (uint8_t)((offset + i) % 256));
+            }
+        }
+    }
+
+    if (sequential_correct) {
+        printf("  ✓ Generated bytes equal (offset + i) %% 256\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Sequential fill is wrong\n");
+    }
+    total_tests++;
+
+    // Test 2: random bytes depend only on their position, not on where generation started
+    printf("\n=== Test Case 2: Random Pattern Is Position-Addressable ===\n");
+    desc.pattern = PAYLOAD_PATTERN_RANDOM;
+    desc.seed = 1234;
+    desc.offset = 0;
+    materialize_payload(&desc, full, 5000);
+
+    int random_correct = 1;
+    for (uint32_t offset = 0; offset < 4000; offset += 333) {
+        desc.offset = offset;
+        materialize_payload(&desc, slice, 777);
+        random_correct &= (memcmp(slice, full + offset, 777) == 0);
+    }
+    desc.seed = 1235;
+    desc.offset = 0;
+    materialize_payload(&desc, slice, 5000);
+    random_correct &= (memcmp(slice, full, 5000) != 0);
+
+    if (random_correct) {
+        printf("  ✓ Slices match the full payload and seeds give different bytes\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Random pattern is not consistent across offsets\n");
+    }
+    total_tests++;
+
+    // Test 3: virtual fragments carry no data but reassemble to the described payload
+    printf("\n=== Test Case 3: Virtual Fragments ===\n");
+    ipv4_packet packet;
+    create_ipv4_packet_virtual(&packet, 1, 2, 30000, PAYLOAD_PATTERN_RANDOM, 99);
+
+    ipv4_fragment* fragments;
+    int count = fragment_ipv4_packet(&packet, 1500, &fragments);
+
+    int virtual_correct = (packet.payload == NULL) && (count == 21);
+    for (int i = 0; i < count; i++) {
+        virtual_correct &= (fragments[i].data == NULL);
+    }
+    materialize_payload(&packet.content, full, 30000);
+    virtual_correct &= (reassemble_ipv4_fragments(fragments, count, slice, sizeof(slice)) == 30000);
+    virtual_correct &= (memcmp(full, slice, 30000) == 0);
+
+    const uint8_t* bytes = fragment_payload(&fragments[3], slice);
+    int fragment_offset = (fragments[3].header.flags_frag_offset & 0x1FFF) * 8;
+    virtual_correct &= (memcmp(bytes, full + fragment_offset, fragments[3].data_size) == 0);
+
+    if (virtual_correct) {
+        printf("  ✓ %d fragments without data reassemble to the generated payload\n", count);
+        test_passed++;
+    } else {
+        printf("  ✗ Virtual fragments are wrong\n");
+    }
+    total_tests++;
+
+    // Test 4: real fragments reassemble, out-of-order is fine, a gap is detected
+    printf("\n=== Test Case 4: Reassembly Checks ===\n");
+    ipv4_packet real;
+    create_ipv4_packet(&real, 1, 2, 4000);
+    ipv4_fragment* real_fragments;
+    int real_count = fragment_ipv4_packet(&real, 576, &real_fragments);
+
+    ipv4_fragment swapped = real_fragments[0];
+    real_fragments[0] = real_fragments[real_count - 1];
+    real_fragments[real_count - 1] = swapped;
+
+    int reassembly_correct = (reassemble_ipv4_fragments(real_fragments, real_count, slice, sizeof(slice)) == 4000) &&
+                             (memcmp(slice, real.payload, 4000) == 0) &&
+                             (reassemble_ipv4_fragments(real_fragments + 1, real_count - 1, slice, sizeof(slice)) == -1) &&
+                             (reassemble_ipv4_fragments(real_fragments, real_count, slice, 1000) == -1);
+
+    if (reassembly_correct) {
+        printf("  ✓ Shuffled fragments reassemble, missing fragments and short buffers are rejected\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Reassembly checks failed\n");
+    }
+    total_tests++;
+
+    for (int i = 0; i < real_count; i++) {
+        free(real_fragments[i].data);
+    }
+    free(real_fragments);
+    free(real.payload);
+    free(fragments);
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,133 @@
+/**
+ * queue_sim_test.c
+ * Test program for router output queues and fragment loss amplification
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/ipv4.h"
+#include "../include/queue_sim.h"
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+    network_topology network;
+    queue_sim_config config;
+    queue_sim_report report;
+
+    printf("=== Output Queue Functionality Test ===\n\n");
+    create_test_topology(&network);
+
+    // Test 1: a lightly loaded network delivers everything, split like the real fragmenter
+    printf("=== Test Case 1: No Congestion ===\n");
+    init_queue_sim_config(&config);
+    config.offered_load = 0.2;
+    config.mtu = 576;
+
+    ipv4_packet packet;
+    ipv4_fragment* fragments;
+    create_ipv4_packet_virtual(&packet, 0, 1, config.payload_size, PAYLOAD_PATTERN_SEQUENTIAL, 0);
+    int count = fragment_ipv4_packet(&packet, config.mtu, &fragments);
+    free(fragments);
+
+    int idle_correct = 1;
+    for (int p = QUEUE_TAIL_DROP; p <= QUEUE_FAIR; p++) {
+        config.policy = (queue_policy)p;
+        idle_correct &= (run_queue_sim(&network, &config, &report) == 0) &&
+                        (report.datagrams_sent > 0) &&
+                        (report.datagrams_delivered == report.datagrams_sent) &&
+                        (report.fragments_dropped == 0) &&
+                        (report.fragments_sent == report.datagrams_sent * count) &&
+                        (report.goodput_bytes == (long long)report.datagrams_sent * config.payload_size);
+    }
+
+    if (idle_correct) {
+        printf("  ✓ Every datagram arrives with all %d fragments under all three policies\n", count);
+        test_passed++;
+    } else {
+        printf("  ✗ Lossless run lost or miscounted fragments\n");
+    }
+    total_tests++;
+
+    // Test 2: under overload, losing one fragment loses the datagram
+    printf("\n=== Test Case 2: Loss Amplification ===\n");
+    init_queue_sim_config(&config);
+    config.offered_load = 3.0;
+    config.mtu = 576;
+    run_queue_sim(&network, &config, &report);
+    double small_mtu_amplification = report.amplification;
+    int amplification_correct = (report.fragments_dropped > 0) &&
+                                (report.datagram_loss > report.fragment_loss) &&
+                                (report.goodput_bytes < (long long)report.datagrams_sent * config.payload_size);
+
+    config.mtu = 9000;
+    run_queue_sim(&network, &config, &report);
+    amplification_correct &= (report.fragments_sent == report.datagrams_sent) &&
+                             (report.amplification == 1.0) && (report.datagram_loss > 0);
+
+    if (amplification_correct) {
+        printf("  ✓ MTU 576 amplifies loss %.2fx, unfragmented datagrams 1.00x\n", small_mtu_amplification);
+        test_passed++;
+    } else {
+        printf("  ✗ Datagram loss does not follow fragment loss\n");
+    }
+    total_tests++;
+
+    // Test 3: fair queueing shields a flow below its fair share from a heavy one
+    printf("\n=== Test Case 3: Fair Queueing ===\n");
+    init_network_topology(&network, 3);
+    add_connection(&network, 0, 1, 1);
+    add_connection(&network, 1, 2, 1);
+
+    init_queue_sim_config(&config);
+    config.offered_load = 2.0;
+    config.flow_count = 3;
+    config.policy = QUEUE_TAIL_DROP;
+    run_queue_sim(&network, &config, &report);
+    double tail_light = report.light_flow_loss;
+    config.policy = QUEUE_FAIR;
+    run_queue_sim(&network, &config, &report);
+    double fair_light = report.light_flow_loss;
+    double fair_heavy = report.heavy_flow_loss;
+
+    if (fair_light < tail_light && fair_light < 0.01 && fair_heavy > fair_light) {
+        printf("  ✓ Light flow loss %.1f%% with tail drop, %.1f%% with fair queueing\n",
+               100.0 * tail_light, 100.0 * fair_light);
+        test_passed++;
+    } else {
+        printf("  ✗ Fair queueing did not protect the light flow (%.3f vs %.3f)\n", fair_light, tail_light);
+    }
+    total_tests++;
+
+    // Test 4: invalid settings are rejected
+    printf("\n=== Test Case 4: Invalid Settings ===\n");
+    init_queue_sim_config(&config);
+    config.buffer_bytes = 100;
+    int invalid_correct = (run_queue_sim(&network, &config, &report) == -1);
+    init_queue_sim_config(&config);
+    config.mtu = 20;
+    invalid_correct &= (run_queue_sim(&network, &config, &report) == -1);
+    init_network_topology(&network, 2);
+    init_queue_sim_config(&config);
+    invalid_correct &= (run_queue_sim(&network, &config, &report) == -1);
+
+    if (invalid_correct) {
+        printf("  ✓ Buffers below the MTU, tiny MTUs and networks without routes are rejected\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Invalid settings were accepted\n");
+    }
+    total_tests++;
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,188 @@
+/**
+ * route_cache_test.c
+ * Test program for shared shortest-path trees and route handles
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/dijkstra.h"
+#include "../include/ipv4.h"
+#include "../include/route_cache.h"
+#include "test_helpers.h"
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+
+    printf("=== Route Cache Functionality Test ===\n\n");
+
+    // Test 1: a handle is 4 bytes and is all a fragment stores about its route
+    printf("=== Test Case 1: Handle Size ===\n");
+    if (sizeof(route_handle) == 4) {
+        printf("  ✓ route_handle is 4 bytes\n");
+        test_passed++;
+    } else {
+        printf("  ✗ route_handle is %zu bytes\n", sizeof(route_handle));
+    }
+    total_tests++;
+
+    // Test 2: expanded routes have the cost found by dijkstra(), one tree per source
+    printf("\n=== Test Case 2: Routes Match dijkstra() ===\n");
+    network_topology network;
+    create_test_topology(&network);
+    route_cache cache;
+    route_cache_init(&cache, &network);
+
+    int routes_correct = 1;
+    for (int source = 0; source < network.node_count; source++) {
+        for (int dest = 0; dest < network.node_count; dest++) {
+            int* expected = NULL;
+            int* path = NULL;
+            int expected_length = dijkstra(&network, source, dest, &expected);
+            route_handle route = route_cache_lookup(&cache, source, dest);
+            int length = route_expand_path(&cache, route, &path);
+
+            if (length != route_path_length(&cache, route) ||
+                (expected_length > 0) != (length > 0) ||
+                path_cost(&network, expected, expected_length) != path_cost(&network, path, length) ||
+                (length > 0 && (path[0] != source || path[length - 1] != dest))) {
+                printf("  ✗ Route %d -> %d differs from dijkstra()\n", source, dest);
+                routes_correct = 0;
+            }
+            free(expected);
+            free(path);
+        }
+    }
+    routes_correct &= (cache.tree_count == network.node_count);
+
+    if (routes_correct) {
+        printf("  ✓ All %d x %d routes agree, %d trees built\n",
+               network.node_count, network.node_count, cache.tree_count);
+        test_passed++;
+    }
+    total_tests++;
+
+    // Test 3: handles issued before a topology change keep their old route
+    printf("\n=== Test Case 3: Handles Survive Updates ===\n");
+    route_handle before = route_cache_lookup(&cache, 0, 5);
+    int* old_path = NULL;
+    int old_length = route_expand_path(&cache, before, &old_path);
+
+    // Cut the first link of the route so the new tree must differ
+    network.graph[old_path[0]][old_path[1]] = 0;
+    network.graph[old_path[1]][old_path[0]] = 0;
+    route_cache_update(&cache, &network);
+
+    route_handle after = route_cache_lookup(&cache, 0, 5);
+    int* new_path = NULL;
+    int* still_old = NULL;
+    int new_length = route_expand_path(&cache, after, &new_path);
+    int still_length = route_expand_path(&cache, before, &still_old);
+
+    int update_correct = (before.tree != after.tree) && (still_length == old_length) &&
+                         (new_length > 0) && (new_path[1] != old_path[1]);
+    for (int i = 0; update_correct && i < old_length; i++) {
+        update_correct &= (still_old[i] == old_path[i]);
+    }
+
+    if (update_correct) {
+        printf("  ✓ Old handle still expands to its route, new lookups avoid the cut link\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Route handles changed after an update\n");
+    }
+    total_tests++;
+    free(old_path);
+    free(new_path);
+    free(still_old);
+
+    // Test 4: unreachable destinations and fresh fragments have no route
+    printf("\n=== Test Case 4: No Route ===\n");
+    for (int i = 0; i < network.node_count; i++) {
+        network.graph[i][7] = 0;
+        network.graph[7][i] = 0;
+    }
+    route_cache_update(&cache, &network);
+    route_handle none = route_cache_lookup(&cache, 0, 7);
+    int* path = NULL;
+
+    ipv4_packet packet;
+    create_ipv4_packet_virtual(&packet, 1, 2, 3000, PAYLOAD_PATTERN_SEQUENTIAL, 0);
+    ipv4_fragment* fragments;
+    int count = fragment_ipv4_packet(&packet, 1500, &fragments);
+
+    int none_correct = (none.tree == ROUTE_NO_TREE) &&
+                       (route_path_length(&cache, none) == -1) &&
+                       (route_expand_path(&cache, none, &path) == -1) && (path == NULL) &&
+                       (count > 1) && (fragments[0].route.tree == ROUTE_NO_TREE);
+    free(fragments);
+
+    if (none_correct) {
+        printf("  ✓ Isolated node gives ROUTE_HANDLE_NONE, new fragments start unrouted\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Unreachable destinations are not reported\n");
+    }
+    total_tests++;
+    route_cache_free(&cache);
+
+    // Test 5: trees superseded by updates are freed once released, so rebuilds
+    // far beyond the 16-bit id space keep working
+    printf("\n=== Test Case 5: Tree Ids Are Recycled ===\n");
+    create_test_topology(&network);
+    route_cache_init(&cache, &network);
+    route_handle held = route_cache_lookup(&cache, 0, 5);
+    int* held_path = NULL;
+    int held_length = route_expand_path(&cache, held, &held_path);
+
+    int rebuilds = 2 * ROUTE_NO_TREE;
+    int failures = 0;
+    for (int i = 0; i < rebuilds; i++) {
+        network.graph[4][5] = 5 + (i & 1);
+        route_cache_update(&cache, &network);
+        route_handle route = route_cache_lookup(&cache, 0, 5);
+        if (route.tree == ROUTE_NO_TREE) failures++;
+        route_cache_release(&cache, route);
+    }
+    int* still_held = NULL;
+    int held_now = route_expand_path(&cache, held, &still_held);
+    int ids_used = cache.tree_count;
+    int recycled_correct = (failures == 0) && (ids_used <= 3) && (held_now == held_length);
+    for (int i = 0; recycled_correct && i < held_length; i++) {
+        recycled_correct &= (still_held[i] == held_path[i]);
+    }
+    free(held_path);
+    free(still_held);
+
+    // With every tree still referenced the id space does run out
+    route_cache_release(&cache, held);
+    route_cache_update(&cache, &network);
+    int issued = 0;
+    for (int i = 0; i <= ROUTE_NO_TREE; i++) {
+        route_cache_update(&cache, &network);
+        if (route_cache_lookup(&cache, 0, 5).tree != ROUTE_NO_TREE) issued++;
+    }
+    recycled_correct &= (issued == ROUTE_NO_TREE) && (cache.tree_count == ROUTE_NO_TREE);
+    route_cache_free(&cache);
+
+    if (recycled_correct) {
+        printf("  ✓ %d rebuilds with %d tree ids, held handle kept its route, full cache reported\n",
+               rebuilds, ids_used);
+        test_passed++;
+    } else {
+        printf("  ✗ Tree ids not recycled (%d lookups failed, %d ids used)\n", failures, ids_used);
+    }
+    total_tests++;
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
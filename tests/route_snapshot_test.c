@@ -0,0 +1,189 @@
+/**
+ * route_snapshot_test.c
+ * Test program for mmap-able routing snapshots
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/dijkstra.h"
+#include "../include/route_snapshot.h"
+#include "test_helpers.h"
+
+#define SNAPSHOT_PATH "build/test_route_snapshot.snap"
+
+// Overwrite one byte of a file in place
+static void corrupt_byte(const char* path, long offset) {
+    FILE* file = fopen(path, "r+b");
+    fseek(file, offset, SEEK_SET);
+    int byte = fgetc(file);
+    fseek(file, offset, SEEK_SET);
+    fputc(byte ^ 0x40, file);
+    fclose(file);
+}
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+    network_topology network;
+    csr_graph graph;
+    route_snapshot snapshot;
+    int sources[MAX_NODES];
+
+    printf("=== Route Snapshot Functionality Test ===\n\n");
+    create_test_topology(&network);
+    csr_from_topology(&graph, &network);
+    for (int i = 0; i < network.node_count; i++) {
+        sources[i] = network.node_count - 1 - i;
+    }
+
+    // Test 1: routes read from the mapping are as short as dijkstra()'s
+    printf("=== Test Case 1: Routes Match dijkstra() ===\n");
+    int status = route_snapshot_write(SNAPSHOT_PATH, &graph, sources, network.node_count);
+    int open_status = route_snapshot_open(&snapshot, SNAPSHOT_PATH, route_snapshot_topology_hash(&graph), true);
+    int routes_correct = (status == ROUTE_SNAPSHOT_OK && open_status == ROUTE_SNAPSHOT_OK);
+
+    for (int s = 0; routes_correct && s < network.node_count; s++) {
+        for (int d = 0; d < network.node_count; d++) {
+            int* expected = NULL;
+            int* path = NULL;
+            int expected_length = dijkstra(&network, s, d, &expected);
+            int length = route_snapshot_path(&snapshot, s, d, &path);
+            int hop = route_snapshot_next_hop(&snapshot, s, d);
+
+            if ((expected_length > 0) != (length > 0)) {
+                routes_correct = 0;
+            } else if (length > 0) {
+                routes_correct &= (path_cost(&network, path, length) == path_cost(&network, expected, expected_length));
+                routes_correct &= (path[0] == s && path[length - 1] == d);
+                routes_correct &= (hop == (length > 1 ? path[1] : s));
+            } else {
+                routes_correct &= (hop == -1);
+            }
+            free(expected);
+            free(path);
+        }
+    }
+    if (routes_correct) {
+        printf("  ✓ Paths and next hops of all %d trees agree with dijkstra()\n", network.node_count);
+        test_passed++;
+    } else {
+        printf("  ✗ Snapshot routes differ from dijkstra() (write %d, open %d)\n", status, open_status);
+    }
+    total_tests++;
+
+    // Test 2: sections are page aligned inside a page-multiple file
+    printf("\n=== Test Case 2: Page-Aligned Layout ===\n");
+    int aligned = (open_status == ROUTE_SNAPSHOT_OK) && (snapshot.map_size % ROUTE_SNAPSHOT_ALIGNMENT == 0);
+    for (int i = 0; aligned && i < SNAPSHOT_SECTION_COUNT; i++) {
+        aligned &= (snapshot.header->sections[i].offset % ROUTE_SNAPSHOT_ALIGNMENT == 0);
+    }
+    aligned &= ((size_t)snapshot.prev % ROUTE_SNAPSHOT_ALIGNMENT == 0);
+    if (aligned) {
+        printf("  ✓ %d sections start on page boundaries, file is %zu bytes\n",
+               SNAPSHOT_SECTION_COUNT, snapshot.map_size);
+        test_passed++;
+    } else {
+        printf("  ✗ Snapshot sections are not page aligned\n");
+    }
+    total_tests++;
+    route_snapshot_close(&snapshot);
+
+    // Test 3: a snapshot of another topology is stale
+    printf("\n=== Test Case 3: Stale Snapshot ===\n");
+    network_topology changed = network;
+    add_connection(&changed, 0, 1, 1);
+    csr_graph changed_graph;
+    csr_from_topology(&changed_graph, &changed);
+
+    int stale = route_snapshot_open(&snapshot, SNAPSHOT_PATH, route_snapshot_topology_hash(&changed_graph), false);
+    int any = route_snapshot_open(&snapshot, SNAPSHOT_PATH, ROUTE_SNAPSHOT_ANY_TOPOLOGY, false);
+    route_snapshot_close(&snapshot);
+    bool rebuilt = false;
+    int reloaded = route_snapshot_load_or_build(&snapshot, SNAPSHOT_PATH, &changed_graph, sources,
+                                                network.node_count, &rebuilt);
+    int* path = NULL;
+    int* expected = NULL;
+    int fresh = (reloaded == ROUTE_SNAPSHOT_OK) && rebuilt &&
+                (route_snapshot_path(&snapshot, 0, 5, &path) > 1) && (dijkstra(&changed, 0, 5, &expected) > 1) &&
+                (path[1] == 1) && (expected[1] == 1);
+    free(path);
+    free(expected);
+    route_snapshot_close(&snapshot);
+
+    // Same topology: the sources in another order reuse the file, fewer sources do not
+    int reversed[MAX_NODES];
+    for (int i = 0; i < network.node_count; i++) {
+        reversed[i] = sources[network.node_count - 1 - i];
+    }
+    bool reordered_rebuilt = true, subset_rebuilt = false;
+    route_snapshot_load_or_build(&snapshot, SNAPSHOT_PATH, &changed_graph, reversed, network.node_count,
+                                 &reordered_rebuilt);
+    route_snapshot_close(&snapshot);
+    int subset = route_snapshot_load_or_build(&snapshot, SNAPSHOT_PATH, &changed_graph, sources, 2, &subset_rebuilt);
+    fresh = fresh && !reordered_rebuilt && (subset == ROUTE_SNAPSHOT_OK) && subset_rebuilt &&
+            (snapshot.tree_count == 2);
+    route_snapshot_close(&snapshot);
+
+    if (stale == ROUTE_SNAPSHOT_ERR_STALE && any == ROUTE_SNAPSHOT_OK && fresh) {
+        printf("  ✓ Changed topology or source set detected and the snapshot rebuilt\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Stale snapshot not handled (open %d, any %d, rebuild %d)\n", stale, any, reloaded);
+    }
+    total_tests++;
+
+    // Test 4: damaged files are rejected
+    printf("\n=== Test Case 4: Corruption ===\n");
+    route_snapshot_write(SNAPSHOT_PATH, &graph, sources, network.node_count);
+    corrupt_byte(SNAPSHOT_PATH, ROUTE_SNAPSHOT_ALIGNMENT * 6 + 5);   // inside the PREV section
+    int lazy = route_snapshot_open(&snapshot, SNAPSHOT_PATH, ROUTE_SNAPSHOT_ANY_TOPOLOGY, false);
+    route_snapshot_close(&snapshot);
+    int checked = route_snapshot_open(&snapshot, SNAPSHOT_PATH, ROUTE_SNAPSHOT_ANY_TOPOLOGY, true);
+
+    // Lookups on an unverified mapping stay inside it: tree 5 of router 0 and the
+    // next hop of router 5 (tree 0) towards node 1 point far out of range
+    route_snapshot_write(SNAPSHOT_PATH, &graph, sources, network.node_count);
+    corrupt_byte(SNAPSHOT_PATH, ROUTE_SNAPSHOT_ALIGNMENT * 5 + 3);       // TREE_INDEX[0]
+    corrupt_byte(SNAPSHOT_PATH, ROUTE_SNAPSHOT_ALIGNMENT * 7 + 4 + 3);   // NEXT_HOP[0][1]
+    int* damaged_path = NULL;
+    bool bounded = (route_snapshot_open(&snapshot, SNAPSHOT_PATH, ROUTE_SNAPSHOT_ANY_TOPOLOGY, false) ==
+                    ROUTE_SNAPSHOT_OK) &&
+                   (route_snapshot_next_hop(&snapshot, 0, 3) == -1) &&
+                   (route_snapshot_path(&snapshot, 0, 3, &damaged_path) == -1) &&
+                   (route_snapshot_next_hop(&snapshot, 5, 1) == -1) &&
+                   (route_snapshot_next_hop(&snapshot, 5, 5) == 5);
+    route_snapshot_close(&snapshot);
+
+    route_snapshot_write(SNAPSHOT_PATH, &graph, sources, network.node_count);
+    corrupt_byte(SNAPSHOT_PATH, 20);   // node count in the header
+    int header = route_snapshot_open(&snapshot, SNAPSHOT_PATH, ROUTE_SNAPSHOT_ANY_TOPOLOGY, false);
+    int missing = route_snapshot_open(&snapshot, "build/missing.snap", ROUTE_SNAPSHOT_ANY_TOPOLOGY, false);
+    int duplicate_sources[2] = { 1, 1 };
+    int invalid = route_snapshot_write(SNAPSHOT_PATH, &graph, duplicate_sources, 2);
+
+    if (lazy == ROUTE_SNAPSHOT_OK && checked == ROUTE_SNAPSHOT_ERR_CHECKSUM && header == ROUTE_SNAPSHOT_ERR_INVALID &&
+        missing == ROUTE_SNAPSHOT_ERR_IO && invalid == ROUTE_SNAPSHOT_ERR_INVALID && bounded) {
+        printf("  ✓ Damaged data caught by verification or kept in bounds, damaged header always, bad input rejected\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Corruption handling failed (lazy %d, checked %d, header %d, missing %d, invalid %d, %s)\n",
+               lazy, checked, header, missing, invalid, bounded ? "bounded" : "out of bounds");
+    }
+    total_tests++;
+
+    remove(SNAPSHOT_PATH);
+    csr_free(&graph);
+    csr_free(&changed_graph);
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
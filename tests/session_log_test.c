@@ -0,0 +1,116 @@
+/**
+ * session_log_test.c
+ * Test program for recording interactive sessions and replaying them
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/session_log.h"
+
+#define INPUT_PATH "build/session_test_input.txt"
+#define LOG_PATH   "build/session_test.log"
+
+// Read what a short session asks for; returns false if a value differs from the script
+static bool run_script(const network_topology* network) {
+    int a = 0, b = 0, missing = 7;
+    char c = 0;
+    char word[7];
+    bool ok = session_read_int(&a) && session_read_int(&b) && session_read_char(&c) &&
+              session_read_word(word, sizeof(word)) && !session_read_int(&missing);
+    session_topology(network);
+    session_digest(&a, sizeof(a));
+    return ok && a == 3 && b == -70000 && c == 'y' && strcmp(word, "remove") == 0;
+}
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+
+    printf("=== Session Log Functionality Test ===\n\n");
+
+    // The script: two numbers, an answer, a word (truncated to 6 characters) and no number
+    FILE* input = fopen(INPUT_PATH, "w");
+    if (input == NULL) {
+        printf("Cannot create %s\n", INPUT_PATH);
+        return EXIT_FAILURE;
+    }
+    fprintf(input, "3 -70000\n  y\nremoved\n");
+    fclose(input);
+
+    network_topology network;
+    create_test_topology(&network);
+
+    // Test 1: values read from stdin come back from the log in the same order
+    printf("=== Test Case 1: Record And Replay ===\n");
+    session_report recorded, replayed;
+    bool record_ok = freopen(INPUT_PATH, "r", stdin) != NULL && session_record_start(LOG_PATH) == 0 &&
+                     run_script(&network);
+    int record_status = session_finish(&recorded);
+    bool replay_ok = session_replay_start(LOG_PATH) == 0 && run_script(&network);
+    int replay_status = session_finish(&replayed);
+
+    if (record_ok && replay_ok && record_status == 0 && replay_status == 0 &&
+        replayed.inputs == 5 && replayed.topology_events == 1 && !replayed.diverged &&
+        replayed.digest == recorded.digest && replayed.recorded_digest == recorded.digest) {
+        printf("  ✓ 5 inputs and 1 topology replayed, digest %016llx matches\n",
+               (unsigned long long)replayed.digest);
+        test_passed++;
+    } else {
+        printf("  ✗ Replay differs from the recording\n");
+    }
+    total_tests++;
+
+    // Test 2: small values take two bytes, -70000 four, each link of the topology three
+    printf("\n=== Test Case 2: Compact Log ===\n");
+    long expected = 9 + 2 + 4 + 2 + 8 + 1 + (3 + 8 * 3) + 9;
+    if (recorded.log_bytes == expected && replayed.log_bytes == expected) {
+        printf("  ✓ %ld byte log: header, 5 inputs, 8 links and the digest\n", recorded.log_bytes);
+        test_passed++;
+    } else {
+        printf("  ✗ Log is %ld bytes, expected %ld\n", recorded.log_bytes, expected);
+    }
+    total_tests++;
+
+    // Test 3: a replay that produces another topology is reported as diverged
+    printf("\n=== Test Case 3: Divergence Is Detected ===\n");
+    network_topology changed = network;
+    changed.graph[0][1] += 1;
+    session_report diverged;
+    bool diverged_ok = session_replay_start(LOG_PATH) == 0 && run_script(&changed);
+    int diverged_status = session_finish(&diverged);
+
+    if (diverged_ok && diverged_status == -1 && diverged.diverged && diverged.digest != recorded.digest) {
+        printf("  ✓ Changed link weight flagged, digest %016llx differs\n", (unsigned long long)diverged.digest);
+        test_passed++;
+    } else {
+        printf("  ✗ Divergence not detected\n");
+    }
+    total_tests++;
+
+    // Test 4: files that are not session logs are refused
+    printf("\n=== Test Case 4: Invalid Logs ===\n");
+    bool refused = session_replay_start(INPUT_PATH) == -1 && session_replay_start("build/no_such.log") == -1;
+    remove(INPUT_PATH);
+    remove(LOG_PATH);
+
+    if (refused) {
+        printf("  ✓ Text file and missing file rejected\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Invalid log accepted\n");
+    }
+    total_tests++;
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,156 @@
+/**
+ * sssp_test.c
+ * Test program for CSR shortest paths and parallel delta-stepping
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/delta_stepping.h"
+#include "../include/dijkstra.h"
+#include "../include/graph.h"
+
+// Run delta-stepping with the given settings and compare it with dijkstra_csr()
+static int matches_dijkstra(csr_graph* graph, int source, int delta, int threads) {
+    int n = graph->node_count;
+    int* ref_dist = (int*)malloc(n * sizeof(int));
+    int* ref_prev = (int*)malloc(n * sizeof(int));
+    int* dist = (int*)malloc(n * sizeof(int));
+    int* prev = (int*)malloc(n * sizeof(int));
+
+    dijkstra_csr(graph, source, ref_dist, ref_prev);
+
+    delta_stepping_config config;
+    init_delta_stepping_config(&config);
+    config.delta = delta;
+    config.threads = threads;
+    config.min_nodes = 0;
+    delta_stepping(graph, source, &config, dist, prev);
+
+    int same = memcmp(dist, ref_dist, n * sizeof(int)) == 0 &&
+               memcmp(prev, ref_prev, n * sizeof(int)) == 0;
+
+    free(ref_dist);
+    free(ref_prev);
+    free(dist);
+    free(prev);
+    return same;
+}
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+
+    printf("=== Shortest Path Functionality Test ===\n\n");
+
+    // Test 1: CSR Dijkstra agrees with the matrix-based dijkstra() on the test topology
+    printf("=== Test Case 1: CSR Dijkstra vs Matrix Dijkstra ===\n");
+    network_topology network;
+    create_test_topology(&network);
+
+    csr_graph graph;
+    csr_from_topology(&graph, &network);
+
+    int dist[MAX_NODES], prev[MAX_NODES];
+    dijkstra_csr(&graph, 0, dist, prev);
+
+    int paths_correct = 1;
+    for (int dest = 1; dest < network.node_count; dest++) {
+        int* path = NULL;
+        int length = dijkstra(&network, 0, dest, &path);
+
+        int cost = 0;
+        for (int i = 0; i + 1 < length; i++) {
+            cost += network.graph[path[i]][path[i + 1]];
+        }
+        if (length <= 0 || cost != dist[dest] || path[length - 2] != prev[dest]) {
+            printf("  ✗ Node %d: matrix cost %d, CSR cost %d\n", dest, cost, dist[dest]);
+            paths_correct = 0;
+        }
+        free(path);
+    }
+
+    if (paths_correct) {
+        printf("  ✓ Distances and predecessors match for every destination\n");
+        test_passed++;
+    }
+    total_tests++;
+
+    // Test 2: delta-stepping on the small topology, fixed and automatic delta
+    printf("\n=== Test Case 2: Delta-Stepping on Test Topology ===\n");
+    int small_correct = 1;
+    for (int source = 0; source < graph.node_count; source++) {
+        small_correct &= matches_dijkstra(&graph, source, 0, 2);
+        small_correct &= matches_dijkstra(&graph, source, 3, 1);
+    }
+    csr_free(&graph);
+
+    if (small_correct) {
+        printf("  ✓ Delta-stepping matches Dijkstra from every source\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Delta-stepping disagrees with Dijkstra\n");
+    }
+    total_tests++;
+
+    // Test 3: generated graphs with different deltas and thread counts
+    printf("\n=== Test Case 3: Delta-Stepping on Generated Graphs ===\n");
+    csr_generate_random(&graph, 20000, 6, 50, 7);
+
+    int deltas[] = { 0, 1, 10, 1000 };
+    int threads[] = { 1, 3, 4 };
+    int generated_correct = 1;
+    for (int d = 0; d < 4; d++) {
+        for (int t = 0; t < 3; t++) {
+            if (!matches_dijkstra(&graph, 123, deltas[d], threads[t])) {
+                printf("  ✗ Mismatch with delta %d and %d threads\n", deltas[d], threads[t]);
+                generated_correct = 0;
+            }
+        }
+    }
+    csr_free(&graph);
+
+    if (generated_correct) {
+        printf("  ✓ Results identical for every delta and thread count\n");
+        test_passed++;
+    }
+    total_tests++;
+
+    // Test 4: unreachable nodes and the sequential fallback
+    printf("\n=== Test Case 4: Unreachable Nodes and Fallback ===\n");
+    init_network_topology(&network, 4);
+    add_connection(&network, 0, 1, 5);
+    add_connection(&network, 2, 3, 5);
+    csr_from_topology(&graph, &network);
+
+    delta_stepping_config config;
+    init_delta_stepping_config(&config);
+    int used_delta = delta_stepping(&graph, 0, &config, dist, prev);
+
+    int fallback_correct = (used_delta == 0) &&
+                           dist[1] == 5 && prev[1] == 0 &&
+                           dist[2] == GRAPH_UNREACHABLE && prev[2] == -1 &&
+                           dist[3] == GRAPH_UNREACHABLE && prev[3] == -1 &&
+                           matches_dijkstra(&graph, 0, 2, 2);
+    csr_free(&graph);
+
+    if (fallback_correct) {
+        printf("  ✓ Small graph used the sequential fallback and unreachable nodes are marked\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Fallback or unreachable handling is wrong\n");
+    }
+    total_tests++;
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
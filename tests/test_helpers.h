@@ -0,0 +1,20 @@
+/**
+ * test_helpers.h
+ * Small helpers shared by the test programs
+ */
+
+#ifndef TEST_HELPERS_H
+#define TEST_HELPERS_H
+
+#include "../include/network.h"
+
+// Sum of link weights along a node path
+static inline int path_cost(network_topology* network, int* path, int length) {
+    int cost = 0;
+    for (int i = 0; i + 1 < length; i++) {
+        cost += network->graph[path[i]][path[i + 1]];
+    }
+    return cost;
+}
+
+#endif /* TEST_HELPERS_H */
@@ -0,0 +1,156 @@
+/**
+ * topology_rcu_test.c
+ * Test program for versioned topology snapshots
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/dijkstra.h"
+#include "../include/topology_rcu.h"
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+
+    printf("=== Topology Snapshot Functionality Test ===\n\n");
+
+    // Test 1: the first version mirrors the adjacency matrix
+    printf("=== Test Case 1: Initial Version ===\n");
+    network_topology network;
+    create_test_topology(&network);
+
+    topology_store store;
+    topology_store_init(&store, &network);
+    int reader = topology_register_reader(&store);
+
+    const topology_version* first = topology_read_lock(&store, reader);
+    int weights_correct = (first->version == 1);
+    for (int i = 0; i < network.node_count; i++) {
+        for (int j = 0; j < network.node_count; j++) {
+            weights_correct &= (topology_version_weight(first, i, j) == network.graph[i][j]);
+        }
+    }
+
+    if (weights_correct) {
+        printf("  ✓ Version 1 has every edge of the test topology\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Version 1 does not match the adjacency matrix\n");
+    }
+    total_tests++;
+
+    // Test 2: a pinned version is unaffected by later changes
+    printf("\n=== Test Case 2: Snapshot Isolation ===\n");
+    topology_change changes[] = {
+        { 1, 3, 0 },   // remove 1 -> 3
+        { 0, 5, 3 },   // add 0 -> 5
+        { 2, 4, 1 },   // reweight 2 -> 4
+        { 0, 5, 30 },  // later change to the same edge wins
+    };
+    unsigned long version = topology_store_apply(&store, changes, 4);
+
+    const topology_version* latest = atomic_load(&store.current);
+    int isolation_correct = (version == 2) &&
+                            topology_version_weight(first, 1, 3) == 9 &&
+                            topology_version_weight(first, 0, 5) == 0 &&
+                            topology_version_weight(latest, 1, 3) == 0 &&
+                            topology_version_weight(latest, 0, 5) == 30 &&
+                            topology_version_weight(latest, 2, 4) == 1;
+
+    if (isolation_correct) {
+        printf("  ✓ Pinned version 1 unchanged, version 2 has the batch applied\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Changes leaked into the pinned version or were not applied\n");
+    }
+    total_tests++;
+
+    // Test 3: retired versions are only freed once no reader can see them
+    printf("\n=== Test Case 3: Epoch-Based Reclamation ===\n");
+    int reclaim_correct = (store.retired != NULL) && (topology_store_reclaim(&store) == 0);
+    topology_read_unlock(&store, reader);
+    reclaim_correct &= (topology_store_reclaim(&store) == 1) && (store.retired == NULL);
+
+    if (reclaim_correct) {
+        printf("  ✓ Version 1 kept while pinned and freed after the reader left\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Reclamation freed too early or not at all\n");
+    }
+    total_tests++;
+
+    // Test 4: invalid batches publish nothing, routing follows the new version
+    printf("\n=== Test Case 4: Validation and Routing ===\n");
+    topology_change invalid[] = { { 0, 1, 4 }, { 0, 99, 1 } };
+    int routing_correct = (topology_store_apply(&store, invalid, 2) == 0);
+
+    network.graph[1][3] = 0;
+    network.graph[0][5] = 30;
+    network.graph[2][4] = 1;
+
+    const topology_version* pinned = topology_read_lock(&store, reader);
+    routing_correct &= (pinned->version == 2);
+    for (int dest = 1; dest < network.node_count; dest++) {
+        int* expected = NULL;
+        int* path = NULL;
+        int expected_length = dijkstra(&network, 0, dest, &expected);
+        int length = topology_version_route(pinned, 0, dest, &path);
+
+        routing_correct &= (length == expected_length);
+        for (int i = 0; i < length && length == expected_length; i++) {
+            routing_correct &= (path[i] == expected[i]);
+        }
+        free(expected);
+        free(path);
+    }
+    topology_read_unlock(&store, reader);
+
+    if (routing_correct) {
+        printf("  ✓ Invalid batch rejected and routes match dijkstra() on the new topology\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Validation or snapshot routing is wrong\n");
+    }
+    total_tests++;
+    topology_store_destroy(&store);
+
+    // Test 5: only the touched adjacency block is copied
+    printf("\n=== Test Case 5: Copy-on-Write Blocks ===\n");
+    csr_graph graph;
+    csr_generate_random(&graph, 4 * TOPOLOGY_BLOCK_NODES, 3, 10, 5);
+    topology_store_init_csr(&store, &graph);
+
+    const topology_version* before = topology_read_lock(&store, topology_register_reader(&store));
+    topology_change change = { TOPOLOGY_BLOCK_NODES + 1, 0, 7 };
+    topology_store_apply(&store, &change, 1);
+    latest = atomic_load(&store.current);
+
+    int sharing_correct = (store.blocks_copied == 1) &&
+                          latest->blocks[0] == before->blocks[0] &&
+                          latest->blocks[1] != before->blocks[1] &&
+                          latest->blocks[2] == before->blocks[2] &&
+                          latest->blocks[3] == before->blocks[3] &&
+                          topology_version_weight(latest, TOPOLOGY_BLOCK_NODES + 1, 0) == 7;
+    topology_store_destroy(&store);
+    csr_free(&graph);
+
+    if (sharing_correct) {
+        printf("  ✓ One block copied, the other three shared with the previous version\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Unchanged blocks were not shared\n");
+    }
+    total_tests++;
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
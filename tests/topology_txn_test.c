@@ -0,0 +1,238 @@
+/**
+ * topology_txn_test.c
+ * Test program for batched topology transactions and incremental route refresh
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/topology_txn.h"
+
+// Random mesh: a ring plus two random links per node
+static void create_mesh(network_topology* network, unsigned int* seed) {
+    init_network_topology(network, MAX_NODES);
+    for (int u = 0; u < MAX_NODES; u++) {
+        *seed = *seed * 1103515245u + 12345u;
+        add_connection(network, u, (u + 1) % MAX_NODES, 1 + (int)((*seed >> 16) % 9));
+        for (int k = 0; k < 2; k++) {
+            *seed = *seed * 1103515245u + 12345u;
+            int v = (int)((*seed >> 16) % MAX_NODES);
+            *seed = *seed * 1103515245u + 12345u;
+            if (v != u) add_connection(network, u, v, 1 + (int)((*seed >> 16) % 9));
+        }
+    }
+}
+
+// True if every current tree of the cache equals the tree of a fresh cache
+static bool routes_match_fresh(route_cache* routes, network_topology* network) {
+    route_cache fresh;
+    route_cache_init(&fresh, network);
+    bool match = true;
+    for (int s = 0; s < routes->node_count && match; s++) {
+        route_cache_release(routes, route_cache_lookup(routes, s, 0));
+        route_cache_lookup(&fresh, s, 0);
+        const shortest_path_tree* a = &routes->trees[routes->current[s]];
+        const shortest_path_tree* b = &fresh.trees[fresh.current[s]];
+        match = memcmp(a->prev, b->prev, routes->node_count * sizeof(uint16_t)) == 0;
+    }
+    route_cache_free(&fresh);
+    return match;
+}
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+
+    printf("=== Topology Transaction Functionality Test ===\n\n");
+
+    // Test 1: one invalid change rejects the whole batch
+    printf("=== Test Case 1: Invalid Batch Is Rejected As A Whole ===\n");
+    network_topology network;
+    create_test_topology(&network);
+    network_topology original = network;
+    topology_txn txn;
+    topology_txn_begin(&txn, &network);
+    topology_txn_set_weight(&txn, 0, 1, 1);
+    topology_txn_remove_link(&txn, 1, 2);
+    topology_txn_set_weight(&txn, 1, 2, 3);   // removed by the change before it
+    topology_txn_result result;
+    int status = topology_txn_commit(&txn, NULL, &result);
+
+    topology_txn_add_link(&txn, 0, 0, 1);
+    int self_status = topology_txn_commit(&txn, NULL, &result);
+    bool self_rejected = (self_status == -1) && (result.failed_change == 0);
+    topology_txn_add_link(&txn, 0, MAX_NODES, 1);
+    bool range_rejected = (topology_txn_commit(&txn, NULL, &result) == -1);
+
+    if (status == -1 && self_rejected && range_rejected && txn.count == 0 &&
+        memcmp(&network, &original, sizeof(network)) == 0) {
+        printf("  ✓ Change 3 of 3 invalid, self-links and unknown nodes rejected, topology untouched\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Rejected batch changed the topology or was accepted\n");
+    }
+    total_tests++;
+
+    // Test 2: routes after random batches equal routes computed from scratch
+    printf("\n=== Test Case 2: Incremental Refresh Matches A Full Recompute ===\n");
+    unsigned int seed = 99;
+    bool all_match = true;
+    long recomputed = 0, trees = 0;
+    for (int trial = 0; trial < 50; trial++) {
+        create_mesh(&network, &seed);
+        route_cache routes;
+        route_cache_init(&routes, &network);
+        for (int s = 0; s < MAX_NODES; s++) route_cache_lookup(&routes, s, 0);
+
+        topology_txn_begin(&txn, &network);
+        network_topology staged = network;
+        int batch = 1 + trial % 8;
+        for (int i = 0; i < batch; i++) {
+            seed = seed * 1103515245u + 12345u;
+            int from = (int)((seed >> 16) % MAX_NODES);
+            int to = (from + 1 + (int)((seed >> 8) % (MAX_NODES - 1))) % MAX_NODES;
+            int weight = 1 + (int)((seed >> 4) % 12);
+            if (staged.graph[from][to] == 0) {
+                topology_txn_add_link(&txn, from, to, weight);
+                staged.graph[from][to] = weight;
+            } else if (seed % 3 == 0) {
+                topology_txn_remove_link(&txn, from, to);
+                staged.graph[from][to] = 0;
+            } else {
+                topology_txn_set_weight(&txn, from, to, weight);
+                staged.graph[from][to] = weight;
+            }
+        }
+        if (topology_txn_commit(&txn, &routes, &result) != 0 ||
+            memcmp(&network, &staged, sizeof(network)) != 0 ||
+            !routes_match_fresh(&routes, &network)) {
+            printf("  ✗ Trial %d: routes differ from a full recompute\n", trial);
+            all_match = false;
+        }
+        recomputed += result.trees_recomputed;
+        trees += MAX_NODES;
+        topology_txn_free(&txn);
+        route_cache_free(&routes);
+    }
+    if (all_match && recomputed < trees) {
+        printf("  ✓ 50 batches: every tree exact, %ld of %ld trees recomputed\n", recomputed, trees);
+        test_passed++;
+    } else {
+        printf("  ✗ Incremental refresh wrong (%ld of %ld trees recomputed)\n", recomputed, trees);
+    }
+    total_tests++;
+
+    // Test 3: only trees a change can alter are rebuilt, the others keep their ids
+    printf("\n=== Test Case 3: Unaffected Trees Are Kept ===\n");
+    // Directed ring 0 -> 1 -> 2 -> 3 -> 0
+    init_network_topology(&network, 4);
+    add_connection(&network, 0, 1, 1);
+    add_connection(&network, 1, 2, 1);
+    add_connection(&network, 2, 3, 1);
+    add_connection(&network, 3, 0, 1);
+    route_cache routes;
+    route_cache_init(&routes, &network);
+    for (int s = 0; s < 4; s++) route_cache_release(&routes, route_cache_lookup(&routes, s, 0));
+    int before[4];
+    memcpy(before, routes.current, sizeof(before));
+
+    // Lengthening 2 -> 3 rebuilds the trees of 0, 1 and 2, which use the link, but not the tree of 3
+    topology_txn_begin(&txn, &network);
+    topology_txn_set_weight(&txn, 2, 3, 5);
+    topology_txn_commit(&txn, &routes, &result);
+    bool kept = (result.trees_recomputed == 3) && (routes.current[3] == before[3]) &&
+                (routes.current[0] != before[0]);
+
+    // A heavier link 0 -> 2 than the path through 1 alters nothing
+    memcpy(before, routes.current, sizeof(before));
+    topology_txn_add_link(&txn, 0, 2, 7);
+    topology_txn_commit(&txn, &routes, &result);
+    kept = kept && (result.trees_recomputed == 0) && (memcmp(before, routes.current, sizeof(before)) == 0) &&
+           routes_match_fresh(&routes, &network);
+    topology_txn_free(&txn);
+    route_cache_free(&routes);
+
+    if (kept) {
+        printf("  ✓ Tree of node 3 kept after a change to a link it does not use, no rebuild for a useless link\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Wrong trees recomputed\n");
+    }
+    total_tests++;
+
+    // Test 4: changes that cancel out leave nothing to recompute
+    printf("\n=== Test Case 4: Net Effect Of A Batch ===\n");
+    create_test_topology(&network);
+    original = network;
+    route_cache_init(&routes, &network);
+    for (int s = 0; s < network.node_count; s++) route_cache_lookup(&routes, s, 0);
+    int weight = network.graph[0][1];
+    topology_txn_begin(&txn, &network);
+    topology_txn_remove_link(&txn, 0, 1);
+    topology_txn_add_link(&txn, 0, 1, weight + 4);
+    topology_txn_set_weight(&txn, 0, 1, weight);
+    topology_txn_commit(&txn, &routes, &result);
+    bool net_correct = (result.applied == 3) && (result.links_changed == 0) && (result.trees_recomputed == 0) &&
+                       (memcmp(&network, &original, sizeof(network)) == 0);
+    topology_txn_free(&txn);
+    route_cache_free(&routes);
+
+    if (net_correct) {
+        printf("  ✓ Remove, re-add and restore of one link: 3 changes applied, 0 links changed, 0 trees rebuilt\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Net effect wrong (%d links changed, %d trees rebuilt)\n",
+               result.links_changed, result.trees_recomputed);
+    }
+    total_tests++;
+
+    // Test 5: one change per commit, with handles released, keeps reusing the same tree ids
+    printf("\n=== Test Case 5: Superseded Trees Are Freed ===\n");
+    seed = 7;
+    create_mesh(&network, &seed);
+    route_cache_init(&routes, &network);
+    for (int s = 0; s < MAX_NODES; s++) route_cache_release(&routes, route_cache_lookup(&routes, s, 0));
+    route_handle held = route_cache_lookup(&routes, 0, MAX_NODES - 1);
+    int held_length = route_path_length(&routes, held);
+    long commits = 0, rebuilt = 0;
+    for (int i = 0; i < 2000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int from = (int)((seed >> 16) % MAX_NODES);
+        int to = (from + 1) % MAX_NODES;
+        topology_txn_begin(&txn, &network);
+        topology_txn_set_weight(&txn, from, to, 1 + (int)((seed >> 4) % 9));
+        if (topology_txn_commit(&txn, &routes, &result) == 0) commits++;
+        rebuilt += result.trees_recomputed;
+        topology_txn_free(&txn);
+    }
+    // The held handle pins its tree; every other superseded tree went back to the free list
+    bool bounded = (commits == 2000) && (rebuilt > MAX_NODES) &&
+                   (routes.tree_count - routes.free_count <= MAX_NODES + 1) &&
+                   (routes.tree_count <= 2 * MAX_NODES + 1) &&
+                   (route_path_length(&routes, held) == held_length) && routes_match_fresh(&routes, &network);
+    route_cache_release(&routes, held);
+    int live = routes.tree_count - routes.free_count;
+    int ids = routes.tree_count;
+    route_cache_free(&routes);
+
+    if (bounded && live <= MAX_NODES) {
+        printf("  ✓ %ld commits rebuilt %ld trees in %d tree ids, held handle kept its route\n",
+               commits, rebuilt, ids);
+        test_passed++;
+    } else {
+        printf("  ✗ Superseded trees kept (%d live trees)\n", live);
+    }
+    total_tests++;
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
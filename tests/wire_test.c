@@ -0,0 +1,133 @@
+/**
+ * wire_test.c
+ * Test program for header serialization and writev fragment emission
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/wire.h"
+
+#define WIRE_PATH "build/test_wire.bin"
+
+int main() {
+    int test_passed = 0;
+    int total_tests = 0;
+
+    printf("=== Wire Emission Functionality Test ===\n\n");
+
+    // Test 1: headers go out in network byte order and parse back unchanged
+    printf("=== Test Case 1: Header Serialization ===\n");
+    ipv4_header header = { 0x45, 0, 0x0073, 0x1234, 0x2001, 0x40, 0x11, 0xB861, 0xC0A80001, 0xC0A800C7 };
+    const uint8_t expected[IPV4_HEADER_SIZE] = { 0x45, 0x00, 0x00, 0x73, 0x12, 0x34, 0x20, 0x01, 0x40, 0x11,
+                                                 0xB8, 0x61, 0xC0, 0xA8, 0x00, 0x01, 0xC0, 0xA8, 0x00, 0xC7 };
+    uint8_t bytes[IPV4_HEADER_SIZE];
+    ipv4_header parsed;
+    ipv4_serialize_header(&header, bytes);
+    bool parsed_ok = ipv4_parse_header(bytes, &parsed);
+
+    if (memcmp(bytes, expected, IPV4_HEADER_SIZE) == 0 && parsed_ok &&
+        memcmp(&parsed, &header, sizeof(header)) == 0) {
+        printf("  ✓ Header bytes match the wire format and round-trip\n");
+        test_passed++;
+    } else {
+        printf("  ✗ Header serialization is wrong\n");
+    }
+    total_tests++;
+
+    // Test 2: the stream written with writev reassembles into the original payloads
+    printf("\n=== Test Case 2: Stream Contents ===\n");
+    ipv4_packet packets[3];
+    ipv4_fragment* fragments[3];
+    int counts[3];
+    create_ipv4_packet(&packets[0], 1, 2, 4000);
+    create_ipv4_packet_virtual(&packets[1], 3, 4, 9000, PAYLOAD_PATTERN_RANDOM, 77);
+    create_ipv4_packet(&packets[2], 5, 6, 300);
+    int fragment_total = 0;
+    for (int d = 0; d < 3; d++) {
+        counts[d] = fragment_ipv4_packet(&packets[d], 576, &fragments[d]);
+        fragment_total += counts[d];
+    }
+
+    FILE* file = fopen(WIRE_PATH, "w+b");
+    wire_writer writer;
+    wire_writer_init(&writer, fileno(file), 4);   // a small queue forces many flushes
+    int emit_status = 0;
+    for (int d = 0; d < 3; d++) {
+        emit_status |= wire_emit(&writer, &packets[d], fragments[d], counts[d]);
+    }
+    emit_status |= wire_writer_free(&writer);
+
+    // Read the stream back fragment by fragment and reassemble each datagram
+    static uint8_t stream[65536];
+    static uint8_t original[MAX_PAYLOAD_SIZE];
+    static uint8_t rebuilt[MAX_PAYLOAD_SIZE];
+    rewind(file);
+    size_t stream_size = fread(stream, 1, sizeof(stream), file);
+    fclose(file);
+
+    bool stream_correct = (emit_status == 0) && (writer.stats.fragments == fragment_total) &&
+                          (writer.stats.syscalls == (fragment_total + 3) / 4) &&
+                          (writer.stats.bytes == (long long)stream_size);
+    size_t position = 0;
+    for (int d = 0; d < 3 && stream_correct; d++) {
+        for (int i = 0; i < counts[d]; i++) {
+            ipv4_header wire_header;
+            stream_correct &= ipv4_parse_header(stream + position, &wire_header) &&
+                              memcmp(&wire_header, &fragments[d][i].header, sizeof(wire_header)) == 0;
+            int offset = (wire_header.flags_frag_offset & 0x1FFF) * 8;
+            memcpy(rebuilt + offset, stream + position + IPV4_HEADER_SIZE, wire_header.total_len - IPV4_HEADER_SIZE);
+            position += wire_header.total_len;
+        }
+        materialize_payload(&packets[d].content, original, packets[d].payload_size);
+        stream_correct &= (memcmp(original, rebuilt, packets[d].payload_size) == 0);
+    }
+    stream_correct &= (position == stream_size);
+
+    if (stream_correct) {
+        printf("  ✓ %d fragments in %ld writev calls reassemble into the original payloads\n",
+               fragment_total, writer.stats.syscalls);
+        test_passed++;
+    } else {
+        printf("  ✗ Written stream does not match the fragments\n");
+    }
+    total_tests++;
+
+    // Test 3: a failed write is reported
+    printf("\n=== Test Case 3: Write Errors ===\n");
+    wire_writer_init(&writer, -1, 4);
+    int bad_status = 0;
+    for (int d = 0; d < 3; d++) {
+        bad_status |= wire_emit(&writer, &packets[d], fragments[d], counts[d]);
+    }
+    bad_status |= wire_writer_free(&writer);
+
+    if (bad_status != 0 && writer.error != 0 && writer.stats.bytes == 0) {
+        printf("  ✓ Writing to a bad descriptor fails with \"%s\"\n", strerror(writer.error));
+        test_passed++;
+    } else {
+        printf("  ✗ Write error went unnoticed\n");
+    }
+    total_tests++;
+
+    for (int d = 0; d < 3; d++) {
+        for (int i = 0; i < counts[d]; i++) {
+            free(fragments[d][i].data);
+        }
+        free(fragments[d]);
+        free(packets[d].payload);
+    }
+    remove(WIRE_PATH);
+
+    // Print test summary
+    printf("\n=== Test Summary ===\n");
+    printf("Passed: %d/%d tests\n", test_passed, total_tests);
+
+    if (test_passed == total_tests) {
+        printf("All tests passed successfully!\n");
+    } else {
+        printf("Some tests failed. Please check the output above.\n");
+    }
+
+    return (test_passed == total_tests) ? EXIT_SUCCESS : EXIT_FAILURE;
+}